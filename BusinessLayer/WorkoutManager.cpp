@@ -8,7 +8,8 @@
 #include <algorithm>
 
 // Constructor
-WorkoutManager::WorkoutManager(WorkoutDAO* dataAccess) : dao(dataAccess) {
+WorkoutManager::WorkoutManager(WorkoutDAO* dataAccess)
+    : dao(dataAccess), externalCheckIntervalMs(1000), startedAt(std::time(nullptr)) {
     //std::cout << "[WorkoutManager] Initialized" << std::endl;
 }
 
@@ -31,14 +32,100 @@ bool WorkoutManager::testConnection() {
     return dao->testConnection();
 }
 
+// ==================== CHANGE VERSIONING ====================
+
+namespace {
+const char* tableName(TableId table) {
+    switch (table) {
+        case TableId::WORKOUT:      return "Workout";
+        case TableId::MUSCLE_GROUP: return "MuscleGroup";
+        case TableId::NUTRITION:    return "Nutrition";
+        case TableId::RECOVERY:     return "Recovery";
+        default:                    return "Equipment";
+    }
+}
+}
+
+// Record a successful write to a table
+void WorkoutManager::bumpVersion(TableId table) {
+    versions[static_cast<int>(table)].local.fetch_add(1);
+}
+
+// Record a successful write and tell the change listener, if any
+void WorkoutManager::recordChange(TableId table, ChangeKind kind, int id) {
+    bumpVersion(table);
+    if (changeListener) {
+        changeListener(ChangeEvent{table, kind, id});
+    }
+}
+
+// Set the function told about every write made through this manager
+void WorkoutManager::setChangeListener(const ChangeListener& listener) {
+    changeListener = listener;
+}
+
+// Get the in-process version counter of a table
+unsigned long long WorkoutManager::getTableVersion(TableId table) const {
+    return versions[static_cast<int>(table)].local.load();
+}
+
+// Count a write made elsewhere in this process
+void WorkoutManager::noteWrite(TableId table) {
+    bumpVersion(table);
+}
+
+// Set how often external stamps are refreshed
+void WorkoutManager::setExternalCheckInterval(int milliseconds) {
+    externalCheckIntervalMs = milliseconds;
+}
+
+// Build an ETag from the local counter plus the (throttled) database version.
+// The process start time keeps tags from colliding across restarts.
+// The database is read outside versionMutex, so requests never queue
+// behind it; a write from another process shows within the check interval.
+std::string WorkoutManager::getTableETag(TableId table) {
+    TableVersion& version = versions[static_cast<int>(table)];
+    bool refresh = false;
+    long long external;
+    
+    {
+        std::lock_guard<std::mutex> lock(versionMutex);
+        auto now = std::chrono::steady_clock::now();
+        
+        if (externalCheckIntervalMs > 0 && !version.refreshing &&
+            (!version.checked ||
+             now - version.checkedAt >= std::chrono::milliseconds(externalCheckIntervalMs))) {
+            version.refreshing = true;
+            refresh = true;
+        }
+        external = version.external;
+    }
+    
+    if (refresh) {
+        long long current = 0;
+        bool found = dao->readTableVersion(tableName(table), current);
+        
+        std::lock_guard<std::mutex> lock(versionMutex);
+        if (found) version.external = current;
+        version.checkedAt = std::chrono::steady_clock::now();
+        version.checked = true;
+        version.refreshing = false;
+        external = version.external;
+    }
+    
+    return "\"" + std::string(tableName(table)) + "-" + std::to_string(startedAt) + "-" +
+           std::to_string(version.local.load()) + "-" + std::to_string(external) + "\"";
+}
+
 
 // ==================== WORKOUT BUSINESS METHODS ====================
 
 // Save workout - creates if ID is 0, updates otherwise
 bool WorkoutManager::saveWorkout(Workout& workout) {
     bool result;
+    bool creating = workout.getWorkoutId() == 0;
     
-    if (workout.getWorkoutId() == 0) {
+    if (creating) {
         // Create new workout
         result = dao->createWorkout(workout);
         if (result) {
@@ -53,6 +140,11 @@ bool WorkoutManager::saveWorkout(Workout& workout) {
         logOperation("Updated Workout ID: " + std::to_string(workout.getWorkoutId()), result);
     }
     
+    if (result) {
+        recordChange(TableId::WORKOUT, creating ? ChangeKind::CREATED : ChangeKind::UPDATED,
+                     workout.getWorkoutId());
+    }
+    
     return result;
 }
 
@@ -67,44 +159,70 @@ Workout* WorkoutManager::getWorkout(int workoutId) {
     return workout;
 }
 
+// Get several workouts in one round trip
+ResultSet<Workout> WorkoutManager::getWorkoutsByIds(const std::vector<int>& workoutIds) {
+    ResultSet<Workout> workouts = dao->readWorkoutsByIds(workoutIds);
+    std::cout << "[INFO] Retrieved " << workouts.size() << " of " << workoutIds.size() << " workouts by ID" << std::endl;
+    return workouts;
+}
+
 // Get all workouts
-std::vector<Workout*> WorkoutManager::getAllWorkouts() {
-    std::vector<Workout*> workouts = dao->readAllWorkouts();
+ResultSet<Workout> WorkoutManager::getAllWorkouts() {
+    ResultSet<Workout> workouts = dao->readAllWorkouts();
     std::cout << "[INFO] Retrieved " << workouts.size() << " workouts" << std::endl;
     return workouts;
 }
 
 // Get workouts by date
-std::vector<Workout*> WorkoutManager::getWorkoutsByDate(const std::string& date) {
-    std::vector<Workout*> workouts = dao->readWorkoutsByDate(date);
+ResultSet<Workout> WorkoutManager::getWorkoutsByDate(const std::string& date) {
+    ResultSet<Workout> workouts = dao->readWorkoutsByDate(date);
     std::cout << "[INFO] Found " << workouts.size() << " workouts on " << date << std::endl;
     return workouts;
 }
 
 // Get workouts by muscle group
-std::vector<Workout*> WorkoutManager::getWorkoutsByMuscleGroup(int muscleGroupId) {
-    std::vector<Workout*> workouts = dao->readWorkoutsByMuscleGroup(muscleGroupId);
+ResultSet<Workout> WorkoutManager::getWorkoutsByMuscleGroup(int muscleGroupId) {
+    ResultSet<Workout> workouts = dao->readWorkoutsByMuscleGroup(muscleGroupId);
     std::cout << "[INFO] Found " << workouts.size() << " workouts for muscle group " << muscleGroupId << std::endl;
     return workouts;
 }
 
+// Get workouts matching a filter
+ResultSet<Workout> WorkoutManager::getWorkoutsWhere(const WorkoutFilter& filter) {
+    ResultSet<Workout> workouts = dao->readWorkoutsWhere(filter);
+    std::cout << "[INFO] Found " << workouts.size() << " matching workouts" << std::endl;
+    return workouts;
+}
+
+// Create a batch of new workouts with one statement
+bool WorkoutManager::createWorkouts(std::vector<Workout>& workouts) {
+    if (workouts.empty()) return true;
+    
+    bool result = dao->createWorkouts(workouts);
+    logOperation("Created " + std::to_string(workouts.size()) + " Workouts", result);
+    if (result) {
+        for (const Workout& workout : workouts) {
+            recordChange(TableId::WORKOUT, ChangeKind::CREATED, workout.getWorkoutId());
+        }
+    }
+    return result;
+}
+
 // Delete workout
 bool WorkoutManager::deleteWorkout(int workoutId) {
     bool result = dao->deleteWorkout(workoutId);
     logOperation("Deleted Workout ID: " + std::to_string(workoutId), result);
+    if (result) {
+        recordChange(TableId::WORKOUT, ChangeKind::DELETED, workoutId);
+    }
     return result;
 }
 
-// Get high intensity workouts
-std::vector<Workout*> WorkoutManager::getHighIntensityWorkouts() {
-    std::vector<Workout*> allWorkouts = dao->readAllWorkouts();
-    std::vector<Workout*> highIntensity;
-    
-    for (auto* workout : allWorkouts) {
-        if (workout->isHighIntensity()) {
-            highIntensity.push_back(workout);
-        }
-    }
+// Get high intensity workouts (RPE >= 8, same threshold as Workout::isHighIntensity)
+ResultSet<Workout> WorkoutManager::getHighIntensityWorkouts() {
+    WorkoutFilter filter;
+    filter.where(WorkoutColumn::RPE, CompareOp::GE, 8);
+    ResultSet<Workout> highIntensity = dao->readWorkoutsWhere(filter);
     
     std::cout << "[INFO] Found " << highIntensity.size() << " high intensity workouts" << std::endl;
     return highIntensity;
@@ -112,31 +230,38 @@ std::vector<Workout*> WorkoutManager::getHighIntensityWorkouts() {
 
 // Get total calories burned for date range
 double WorkoutManager::getTotalCaloriesBurned(const std::string& startDate, const std::string& endDate) {
-    std::vector<Workout*> allWorkouts = dao->readAllWorkouts();
+    WorkoutFilter filter;
+    filter.between(WorkoutColumn::DATE, startDate, endDate);
+    ResultSet<Workout> workouts = dao->readWorkoutsWhere(filter);
     double totalCalories = 0.0;
     
-    for (auto* workout : allWorkouts) {
-        std::string date = workout->getWorkoutDate();
-        if (date >= startDate && date <= endDate) {
-            totalCalories += workout->getCaloriesBurned();
-        }
+    for (const Workout& workout : workouts) {
+        totalCalories += workout.getCaloriesBurned();
     }
     
-    // Cleanup
-    cleanupVector(allWorkouts);
-    
     std::cout << "[INFO] Total calories burned from " << startDate << " to " << endDate 
               << ": " << totalCalories << std::endl;
     return totalCalories;
 }
 
+// Get total calories burned from a snapshot (no database round trip)
+double WorkoutManager::getTotalCaloriesBurned(const AnalyticsSnapshot& snapshot, const std::string& startDate, const std::string& endDate) {
+    double totalCalories = snapshot.workouts().sumByDate("calories_burned",
+        ColumnSnapshot::dateKey(startDate), ColumnSnapshot::dateKey(endDate));
+    
+    std::cout << "[INFO] Total calories burned from " << startDate << " to " << endDate 
+              << ": " << totalCalories << " (snapshot)" << std::endl;
+    return totalCalories;
+}
+
 // ==================== MUSCLEGROUP BUSINESS METHODS ====================
 
 // Save muscle group - creates if ID is 0, updates otherwise
 bool WorkoutManager::saveMuscleGroup(MuscleGroup& muscleGroup) {
     bool result;
+    bool creating = muscleGroup.getMuscleGroupId() == 0;
     
-    if (muscleGroup.getMuscleGroupId() == 0) {
+    if (creating) {
         // Create new muscle group
         result = dao->createMuscleGroup(muscleGroup);
         if (result) {
@@ -151,9 +276,19 @@ bool WorkoutManager::saveMuscleGroup(MuscleGroup& muscleGroup) {
         logOperation("Updated MuscleGroup ID: " + std::to_string(muscleGroup.getMuscleGroupId()), result);
     }
     
+    if (result) {
+        recordChange(TableId::MUSCLE_GROUP, creating ? ChangeKind::CREATED : ChangeKind::UPDATED,
+                     muscleGroup.getMuscleGroupId());
+    }
+    
     return result;
 }
 
+// Whether the last failed save hit a unique name
+bool WorkoutManager::isDuplicateName() const {
+    return dao->lastWriteWasDuplicate();
+}
+
 // Get a single muscle group
 MuscleGroup* WorkoutManager::getMuscleGroup(int muscleGroupId) {
     MuscleGroup* muscleGroup = dao->readMuscleGroup(muscleGroupId);
@@ -165,9 +300,17 @@ MuscleGroup* WorkoutManager::getMuscleGroup(int muscleGroupId) {
     return muscleGroup;
 }
 
+// Get several muscle groups by ID (one query)
+ResultSet<MuscleGroup> WorkoutManager::getMuscleGroupsByIds(const std::vector<int>& muscleGroupIds) {
+    ResultSet<MuscleGroup> muscleGroups = dao->readMuscleGroupsByIds(muscleGroupIds);
+    std::cout << "[INFO] Retrieved " << muscleGroups.size() << " of " << muscleGroupIds.size()
+              << " muscle groups by ID" << std::endl;
+    return muscleGroups;
+}
+
 // Get all muscle groups
-std::vector<MuscleGroup*> WorkoutManager::getAllMuscleGroups() {
-    std::vector<MuscleGroup*> muscleGroups = dao->readAllMuscleGroups();
+ResultSet<MuscleGroup> WorkoutManager::getAllMuscleGroups() {
+    ResultSet<MuscleGroup> muscleGroups = dao->readAllMuscleGroups();
     std::cout << "[INFO] Retrieved " << muscleGroups.size() << " muscle groups" << std::endl;
     return muscleGroups;
 }
@@ -183,10 +326,22 @@ MuscleGroup* WorkoutManager::getMuscleGroupByName(const std::string& name) {
     return muscleGroup;
 }
 
+// Get muscle groups matching a filter
+ResultSet<MuscleGroup> WorkoutManager::getMuscleGroupsWhere(const MuscleGroupFilter& filter) {
+    ResultSet<MuscleGroup> muscleGroups = dao->readMuscleGroupsWhere(filter);
+    std::cout << "[INFO] Found " << muscleGroups.size() << " matching muscle groups" << std::endl;
+    return muscleGroups;
+}
+
 // Delete muscle group
 bool WorkoutManager::deleteMuscleGroup(int muscleGroupId) {
     bool result = dao->deleteMuscleGroup(muscleGroupId);
     logOperation("Deleted MuscleGroup ID: " + std::to_string(muscleGroupId), result);
+    if (result) {
+        recordChange(TableId::MUSCLE_GROUP, ChangeKind::DELETED, muscleGroupId);
+        // ON DELETE SET NULL rewrote the group's workouts too
+        bumpVersion(TableId::WORKOUT);
+    }
     return result;
 }
 
@@ -195,8 +350,9 @@ bool WorkoutManager::deleteMuscleGroup(int muscleGroupId) {
 // Save nutrition - creates if ID is 0, updates otherwise
 bool WorkoutManager::saveNutrition(Nutrition& nutrition) {
     bool result;
+    bool creating = nutrition.getNutritionId() == 0;
     
-    if (nutrition.getNutritionId() == 0) {
+    if (creating) {
         // Create new nutrition entry
         result = dao->createNutrition(nutrition);
         if (result) {
@@ -211,6 +367,11 @@ bool WorkoutManager::saveNutrition(Nutrition& nutrition) {
         logOperation("Updated Nutrition ID: " + std::to_string(nutrition.getNutritionId()), result);
     }
     
+    if (result) {
+        recordChange(TableId::NUTRITION, creating ? ChangeKind::CREATED : ChangeKind::UPDATED,
+                     nutrition.getNutritionId());
+    }
+    
     return result;
 }
 
@@ -226,72 +387,95 @@ Nutrition* WorkoutManager::getNutrition(int nutritionId) {
 }
 
 // Get all nutrition entries
-std::vector<Nutrition*> WorkoutManager::getAllNutrition() {
-    std::vector<Nutrition*> nutrition = dao->readAllNutrition();
+ResultSet<Nutrition> WorkoutManager::getAllNutrition() {
+    ResultSet<Nutrition> nutrition = dao->readAllNutrition();
     std::cout << "[INFO] Retrieved " << nutrition.size() << " nutrition entries" << std::endl;
     return nutrition;
 }
 
 // Get nutrition by date
-std::vector<Nutrition*> WorkoutManager::getNutritionByDate(const std::string& date) {
-    std::vector<Nutrition*> nutrition = dao->readNutritionByDate(date);
+ResultSet<Nutrition> WorkoutManager::getNutritionByDate(const std::string& date) {
+    ResultSet<Nutrition> nutrition = dao->readNutritionByDate(date);
     std::cout << "[INFO] Found " << nutrition.size() << " nutrition entries on " << date << std::endl;
     return nutrition;
 }
 
 // Get nutrition by family
-std::vector<Nutrition*> WorkoutManager::getNutritionByFamily(const std::string& family) {
-    std::vector<Nutrition*> nutrition = dao->readNutritionByFamily(family);
+ResultSet<Nutrition> WorkoutManager::getNutritionByFamily(const std::string& family) {
+    ResultSet<Nutrition> nutrition = dao->readNutritionByFamily(family);
     std::cout << "[INFO] Found " << nutrition.size() << " " << family << " nutrition entries" << std::endl;
     return nutrition;
 }
 
+// Get nutrition entries matching a filter
+ResultSet<Nutrition> WorkoutManager::getNutritionWhere(const NutritionFilter& filter) {
+    ResultSet<Nutrition> nutrition = dao->readNutritionWhere(filter);
+    std::cout << "[INFO] Found " << nutrition.size() << " matching nutrition entries" << std::endl;
+    return nutrition;
+}
+
 // Delete nutrition entry
 bool WorkoutManager::deleteNutrition(int nutritionId) {
     bool result = dao->deleteNutrition(nutritionId);
     logOperation("Deleted Nutrition ID: " + std::to_string(nutritionId), result);
+    if (result) {
+        recordChange(TableId::NUTRITION, ChangeKind::DELETED, nutritionId);
+    }
     return result;
 }
 
 // Get total calories for a date
 double WorkoutManager::getTotalCaloriesForDate(const std::string& date) {
-    std::vector<Nutrition*> nutrition = dao->readNutritionByDate(date);
+    ResultSet<Nutrition> nutrition = dao->readNutritionByDate(date);
     double totalCalories = 0.0;
     
-    for (auto* n : nutrition) {
-        totalCalories += n->calculateTotalCalories();
+    for (const Nutrition& n : nutrition) {
+        totalCalories += n.calculateTotalCalories();
     }
     
-    // Cleanup
-    cleanupVector(nutrition);
-    
     std::cout << "[INFO] Total calories consumed on " << date << ": " << totalCalories << std::endl;
     return totalCalories;
 }
 
 // Get total protein for a date
 double WorkoutManager::getTotalProteinForDate(const std::string& date) {
-    std::vector<Nutrition*> nutrition = dao->readNutritionByDate(date);
+    ResultSet<Nutrition> nutrition = dao->readNutritionByDate(date);
     double totalProtein = 0.0;
     
-    for (auto* n : nutrition) {
-        totalProtein += n->getProtein();
+    for (const Nutrition& n : nutrition) {
+        totalProtein += n.getProtein();
     }
     
-    // Cleanup
-    cleanupVector(nutrition);
-    
     std::cout << "[INFO] Total protein consumed on " << date << ": " << totalProtein << "g" << std::endl;
     return totalProtein;
 }
 
+// Get total calories for a date from a snapshot
+double WorkoutManager::getTotalCaloriesForDate(const AnalyticsSnapshot& snapshot, const std::string& date) {
+    int32_t day = ColumnSnapshot::dateKey(date);
+    double totalCalories = snapshot.nutrition().sumByDate("calories", day, day);
+    
+    std::cout << "[INFO] Total calories consumed on " << date << ": " << totalCalories << " (snapshot)" << std::endl;
+    return totalCalories;
+}
+
+// Get total protein for a date from a snapshot
+double WorkoutManager::getTotalProteinForDate(const AnalyticsSnapshot& snapshot, const std::string& date) {
+    int32_t day = ColumnSnapshot::dateKey(date);
+    double totalProtein = snapshot.nutrition().sumByDate("protein", day, day);
+    
+    std::cout << "[INFO] Total protein consumed on " << date << ": " << totalProtein << "g (snapshot)" << std::endl;
+    return totalProtein;
+}
+
 // ==================== RECOVERY BUSINESS METHODS ====================
 
 // Save recovery - creates if ID is 0, updates otherwise
 bool WorkoutManager::saveRecovery(Recovery& recovery) {
     bool result;
+    bool creating = recovery.getRecoveryId() == 0;
     
-    if (recovery.getRecoveryId() == 0) {
+    if (creating) {
         // Create new recovery session
         result = dao->createRecovery(recovery);
         if (result) {
@@ -306,6 +490,11 @@ bool WorkoutManager::saveRecovery(Recovery& recovery) {
         logOperation("Updated Recovery ID: " + std::to_string(recovery.getRecoveryId()), result);
     }
     
+    if (result) {
+        recordChange(TableId::RECOVERY, creating ? ChangeKind::CREATED : ChangeKind::UPDATED,
+                     recovery.getRecoveryId());
+    }
+    
     return result;
 }
 
@@ -321,60 +510,77 @@ Recovery* WorkoutManager::getRecovery(int recoveryId) {
 }
 
 // Get all recovery sessions
-std::vector<Recovery*> WorkoutManager::getAllRecovery() {
-    std::vector<Recovery*> recovery = dao->readAllRecovery();
+ResultSet<Recovery> WorkoutManager::getAllRecovery() {
+    ResultSet<Recovery> recovery = dao->readAllRecovery();
     std::cout << "[INFO] Retrieved " << recovery.size() << " recovery sessions" << std::endl;
     return recovery;
 }
 
 // Get recovery by date
-std::vector<Recovery*> WorkoutManager::getRecoveryByDate(const std::string& date) {
-    std::vector<Recovery*> recovery = dao->readRecoveryByDate(date);
+ResultSet<Recovery> WorkoutManager::getRecoveryByDate(const std::string& date) {
+    ResultSet<Recovery> recovery = dao->readRecoveryByDate(date);
     std::cout << "[INFO] Found " << recovery.size() << " recovery sessions on " << date << std::endl;
     return recovery;
 }
 
 // Get recovery by type
-std::vector<Recovery*> WorkoutManager::getRecoveryByType(const std::string& type) {
-    std::vector<Recovery*> recovery = dao->readRecoveryByType(type);
+ResultSet<Recovery> WorkoutManager::getRecoveryByType(const std::string& type) {
+    ResultSet<Recovery> recovery = dao->readRecoveryByType(type);
     std::cout << "[INFO] Found " << recovery.size() << " " << type << " sessions" << std::endl;
     return recovery;
 }
 
+// Get recovery sessions matching a filter
+ResultSet<Recovery> WorkoutManager::getRecoveryWhere(const RecoveryFilter& filter) {
+    ResultSet<Recovery> recovery = dao->readRecoveryWhere(filter);
+    std::cout << "[INFO] Found " << recovery.size() << " matching recovery sessions" << std::endl;
+    return recovery;
+}
+
 // Delete recovery session
 bool WorkoutManager::deleteRecovery(int recoveryId) {
     bool result = dao->deleteRecovery(recoveryId);
     logOperation("Deleted Recovery ID: " + std::to_string(recoveryId), result);
+    if (result) {
+        recordChange(TableId::RECOVERY, ChangeKind::DELETED, recoveryId);
+    }
     return result;
 }
 
 // Get total recovery time for date range
 int WorkoutManager::getTotalRecoveryTime(const std::string& startDate, const std::string& endDate) {
-    std::vector<Recovery*> allRecovery = dao->readAllRecovery();
+    RecoveryFilter filter;
+    filter.between(RecoveryColumn::DATE, startDate, endDate);
+    ResultSet<Recovery> sessions = dao->readRecoveryWhere(filter);
     int totalMinutes = 0;
     
-    for (auto* recovery : allRecovery) {
-        std::string date = recovery->getRecoveryDate();
-        if (date >= startDate && date <= endDate) {
-            totalMinutes += recovery->getDuration();
-        }
+    for (const Recovery& recovery : sessions) {
+        totalMinutes += recovery.getDuration();
     }
     
-    // Cleanup
-    cleanupVector(allRecovery);
-    
     std::cout << "[INFO] Total recovery time from " << startDate << " to " << endDate 
               << ": " << totalMinutes << " minutes" << std::endl;
     return totalMinutes;
 }
 
+// Get total recovery time from a snapshot
+int WorkoutManager::getTotalRecoveryTime(const AnalyticsSnapshot& snapshot, const std::string& startDate, const std::string& endDate) {
+    int totalMinutes = static_cast<int>(snapshot.recovery().sumByDate("duration",
+        ColumnSnapshot::dateKey(startDate), ColumnSnapshot::dateKey(endDate)));
+    
+    std::cout << "[INFO] Total recovery time from " << startDate << " to " << endDate 
+              << ": " << totalMinutes << " minutes (snapshot)" << std::endl;
+    return totalMinutes;
+}
+
 // ==================== EQUIPMENT BUSINESS METHODS ====================
 
 // Save equipment - creates if ID is 0, updates otherwise
 bool WorkoutManager::saveEquipment(Equipment& equipment) {
     bool result;
+    bool creating = equipment.getEquipmentId() == 0;
     
-    if (equipment.getEquipmentId() == 0) {
+    if (creating) {
         // Create new equipment
         result = dao->createEquipment(equipment);
         if (result) {
@@ -389,6 +595,11 @@ bool WorkoutManager::saveEquipment(Equipment& equipment) {
         logOperation("Updated Equipment ID: " + std::to_string(equipment.getEquipmentId()), result);
     }
     
+    if (result) {
+        recordChange(TableId::EQUIPMENT, creating ? ChangeKind::CREATED : ChangeKind::UPDATED,
+                     equipment.getEquipmentId());
+    }
+    
     return result;
 }
 
@@ -404,15 +615,15 @@ Equipment* WorkoutManager::getEquipment(int equipmentId) {
 }
 
 // Get all equipment
-std::vector<Equipment*> WorkoutManager::getAllEquipment() {
-    std::vector<Equipment*> equipment = dao->readAllEquipment();
+ResultSet<Equipment> WorkoutManager::getAllEquipment() {
+    ResultSet<Equipment> equipment = dao->readAllEquipment();
     std::cout << "[INFO] Retrieved " << equipment.size() << " equipment items" << std::endl;
     return equipment;
 }
 
 // Get equipment by category
-std::vector<Equipment*> WorkoutManager::getEquipmentByCategory(const std::string& category) {
-    std::vector<Equipment*> equipment = dao->readEquipmentByCategory(category);
+ResultSet<Equipment> WorkoutManager::getEquipmentByCategory(const std::string& category) {
+    ResultSet<Equipment> equipment = dao->readEquipmentByCategory(category);
     std::cout << "[INFO] Found " << equipment.size() << " " << category << " equipment items" << std::endl;
     return equipment;
 }
@@ -428,24 +639,68 @@ Equipment* WorkoutManager::getEquipmentByName(const std::string& name) {
     return equipment;
 }
 
+// Get equipment matching a filter
+ResultSet<Equipment> WorkoutManager::getEquipmentWhere(const EquipmentFilter& filter) {
+    ResultSet<Equipment> equipment = dao->readEquipmentWhere(filter);
+    std::cout << "[INFO] Found " << equipment.size() << " matching equipment items" << std::endl;
+    return equipment;
+}
+
 // Delete equipment
 bool WorkoutManager::deleteEquipment(int equipmentId) {
     bool result = dao->deleteEquipment(equipmentId);
     logOperation("Deleted Equipment ID: " + std::to_string(equipmentId), result);
+    if (result) {
+        recordChange(TableId::EQUIPMENT, ChangeKind::DELETED, equipmentId);
+    }
     return result;
 }
 
 // Get all cardio equipment
-std::vector<Equipment*> WorkoutManager::getCardioEquipment() {
-    std::vector<Equipment*> allEquipment = dao->readAllEquipment();
-    std::vector<Equipment*> cardio;
-    
-    for (auto* equipment : allEquipment) {
-        if (equipment->isCardioEquipment()) {
-            cardio.push_back(equipment);
-        }
-    }
+ResultSet<Equipment> WorkoutManager::getCardioEquipment() {
+    ResultSet<Equipment> cardio = dao->readAllEquipment();
+    cardio.keepIf([](const Equipment& equipment) { return equipment.isCardioEquipment(); });
     
     std::cout << "[INFO] Found " << cardio.size() << " cardio equipment items" << std::endl;
     return cardio;
 }
+
+// ==================== TRAINING DAY ====================
+
+// Log a whole training day in one transaction
+bool WorkoutManager::logDay(const std::string& clientKey, const std::string& fingerprint, Workout* workout,
+                            std::vector<Nutrition>& meals, Recovery* recovery, DayLogResult& result) {
+    if (!workout && meals.empty() && !recovery) {
+        logOperation("Log Day (nothing to log)", false);
+        return false;
+    }
+    
+    bool success = dao->logDay(clientKey, fingerprint, workout, meals, recovery, result);
+    if (!success) {
+        logOperation("Log Day", false);
+        return false;
+    }
+    
+    // Write the ids back so callers can use the objects as saved entities
+    if (workout) workout->setWorkoutId(result.workoutId);
+    for (size_t i = 0; i < meals.size() && i < result.nutritionIds.size(); ++i) {
+        meals[i].setNutritionId(result.nutritionIds[i]);
+    }
+    if (recovery) recovery->setRecoveryId(result.recoveryId);
+    
+    if (result.replayed) {
+        logOperation("Replayed Day for key " + clientKey, true);
+        return true;
+    }
+    
+    if (result.workoutId) recordChange(TableId::WORKOUT, ChangeKind::CREATED, result.workoutId);
+    for (int nutritionId : result.nutritionIds) {
+        recordChange(TableId::NUTRITION, ChangeKind::CREATED, nutritionId);
+    }
+    if (result.recoveryId) recordChange(TableId::RECOVERY, ChangeKind::CREATED, result.recoveryId);
+    
+    logOperation("Logged Day: workout " + std::to_string(result.workoutId) + ", " +
+                 std::to_string(result.nutritionIds.size()) + " meals, recovery " +
+                 std::to_string(result.recoveryId), true);
+    return true;
+}
@@ -12,15 +12,66 @@
 #include "../Nutrition.h"
 #include "../Recovery.h"
 #include "../Equipment.h"
+#include "../ColumnSnapshot.h"
 #include <vector>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+#include <functional>
+
+// Tables tracked for change versioning
+enum class TableId {
+    WORKOUT,
+    MUSCLE_GROUP,
+    NUTRITION,
+    RECOVERY,
+    EQUIPMENT
+};
+
+// What a successful save/delete did, for change listeners
+enum class ChangeKind {
+    CREATED,
+    UPDATED,
+    DELETED
+};
+
+struct ChangeEvent {
+    TableId table;
+    ChangeKind kind;
+    int id;
+};
+
+typedef std::function<void(const ChangeEvent&)> ChangeListener;
 
 class WorkoutManager {
 private:
     WorkoutDAO* dao;
     
+    // Change tracking for one table. The local counter is bumped by every
+    // successful save/delete here; the database's version of the table is
+    // re-read now and then to catch writes from other processes. One request
+    // does the re-read (refreshing) while the others use the last value.
+    struct TableVersion {
+        std::atomic<unsigned long long> local{0};
+        long long external = 0;
+        std::chrono::steady_clock::time_point checkedAt;
+        bool checked = false;
+        bool refreshing = false;
+    };
+    
+    static const int TABLE_COUNT = 5;
+    TableVersion versions[TABLE_COUNT];
+    std::mutex versionMutex;
+    int externalCheckIntervalMs;
+    time_t startedAt;
+    ChangeListener changeListener;
+    
     // Helper methods
     void logOperation(const std::string& operation, bool success);
+    void bumpVersion(TableId table);
+    void recordChange(TableId table, ChangeKind kind, int id);
 
 public:
     // Constructor and Destructor
@@ -34,39 +85,57 @@ public:
     
     // Get a single workout
     Workout* getWorkout(int workoutId);
+    ResultSet<Workout> getWorkoutsByIds(const std::vector<int>& workoutIds);
     
     // Get all workouts
-    std::vector<Workout*> getAllWorkouts();
+    ResultSet<Workout> getAllWorkouts();
     
     // Get workouts by date
-    std::vector<Workout*> getWorkoutsByDate(const std::string& date);
+    ResultSet<Workout> getWorkoutsByDate(const std::string& date);
     
     // Get workouts by muscle group
-    std::vector<Workout*> getWorkoutsByMuscleGroup(int muscleGroupId);
+    ResultSet<Workout> getWorkoutsByMuscleGroup(int muscleGroupId);
+    
+    // Get workouts matching an arbitrary filter
+    ResultSet<Workout> getWorkoutsWhere(const WorkoutFilter& filter);
+    
+    // Create several new workouts in one round trip (ids are written back)
+    bool createWorkouts(std::vector<Workout>& workouts);
     
     // Delete workout
     bool deleteWorkout(int workoutId);
     
     // Get high intensity workouts (RPE >= 8)
-    std::vector<Workout*> getHighIntensityWorkouts();
+    ResultSet<Workout> getHighIntensityWorkouts();
     
     // Get total calories burned for a date range
     double getTotalCaloriesBurned(const std::string& startDate, const std::string& endDate);
     
+    // Same, computed from an exported snapshot instead of the database
+    double getTotalCaloriesBurned(const AnalyticsSnapshot& snapshot, const std::string& startDate, const std::string& endDate);
+    
     // ==================== MUSCLEGROUP BUSINESS METHODS ====================
     
     // Save method - creates if ID is 0, updates if ID exists
     bool saveMuscleGroup(MuscleGroup& muscleGroup);
     
+    // True when the last failed save on this thread used a name that is
+    // already taken (muscle group and equipment names are unique)
+    bool isDuplicateName() const;
+    
     // Get a single muscle group
     MuscleGroup* getMuscleGroup(int muscleGroupId);
+    ResultSet<MuscleGroup> getMuscleGroupsByIds(const std::vector<int>& muscleGroupIds);
     
     // Get all muscle groups
-    std::vector<MuscleGroup*> getAllMuscleGroups();
+    ResultSet<MuscleGroup> getAllMuscleGroups();
     
     // Get muscle group by name
     MuscleGroup* getMuscleGroupByName(const std::string& name);
     
+    // Get muscle groups matching an arbitrary filter
+    ResultSet<MuscleGroup> getMuscleGroupsWhere(const MuscleGroupFilter& filter);
+    
     // Delete muscle group
     bool deleteMuscleGroup(int muscleGroupId);
     
@@ -79,13 +148,16 @@ public:
     Nutrition* getNutrition(int nutritionId);
     
     // Get all nutrition entries
-    std::vector<Nutrition*> getAllNutrition();
+    ResultSet<Nutrition> getAllNutrition();
     
     // Get nutrition by date
-    std::vector<Nutrition*> getNutritionByDate(const std::string& date);
+    ResultSet<Nutrition> getNutritionByDate(const std::string& date);
     
     // Get nutrition by family
-    std::vector<Nutrition*> getNutritionByFamily(const std::string& family);
+    ResultSet<Nutrition> getNutritionByFamily(const std::string& family);
+    
+    // Get nutrition entries matching an arbitrary filter
+    ResultSet<Nutrition> getNutritionWhere(const NutritionFilter& filter);
     
     // Delete nutrition entry
     bool deleteNutrition(int nutritionId);
@@ -96,6 +168,10 @@ public:
     // Get total protein for a date
     double getTotalProteinForDate(const std::string& date);
     
+    // Snapshot versions of the two totals above
+    double getTotalCaloriesForDate(const AnalyticsSnapshot& snapshot, const std::string& date);
+    double getTotalProteinForDate(const AnalyticsSnapshot& snapshot, const std::string& date);
+    
     // ==================== RECOVERY BUSINESS METHODS ====================
     
     // Save method - creates if ID is 0, updates if ID exists
@@ -105,13 +181,16 @@ public:
     Recovery* getRecovery(int recoveryId);
     
     // Get all recovery sessions
-    std::vector<Recovery*> getAllRecovery();
+    ResultSet<Recovery> getAllRecovery();
     
     // Get recovery by date
-    std::vector<Recovery*> getRecoveryByDate(const std::string& date);
+    ResultSet<Recovery> getRecoveryByDate(const std::string& date);
     
     // Get recovery by type
-    std::vector<Recovery*> getRecoveryByType(const std::string& type);
+    ResultSet<Recovery> getRecoveryByType(const std::string& type);
+    
+    // Get recovery sessions matching an arbitrary filter
+    ResultSet<Recovery> getRecoveryWhere(const RecoveryFilter& filter);
     
     // Delete recovery session
     bool deleteRecovery(int recoveryId);
@@ -119,6 +198,9 @@ public:
     // Get total recovery time for a date range
     int getTotalRecoveryTime(const std::string& startDate, const std::string& endDate);
     
+    // Same, computed from an exported snapshot instead of the database
+    int getTotalRecoveryTime(const AnalyticsSnapshot& snapshot, const std::string& startDate, const std::string& endDate);
+    
     // ==================== EQUIPMENT BUSINESS METHODS ====================
     
     // Save method - creates if ID is 0, updates if ID exists
@@ -128,33 +210,56 @@ public:
     Equipment* getEquipment(int equipmentId);
     
     // Get all equipment
-    std::vector<Equipment*> getAllEquipment();
+    ResultSet<Equipment> getAllEquipment();
     
     // Get equipment by category
-    std::vector<Equipment*> getEquipmentByCategory(const std::string& category);
+    ResultSet<Equipment> getEquipmentByCategory(const std::string& category);
     
     // Get equipment by name
     Equipment* getEquipmentByName(const std::string& name);
     
+    // Get equipment matching an arbitrary filter
+    ResultSet<Equipment> getEquipmentWhere(const EquipmentFilter& filter);
+    
     // Delete equipment
     bool deleteEquipment(int equipmentId);
     
     // Get all cardio equipment
-    std::vector<Equipment*> getCardioEquipment();
+    ResultSet<Equipment> getCardioEquipment();
+    
+    // ==================== TRAINING DAY ====================
+    
+    // Log a workout, meals and a recovery session together, all or nothing.
+    // Pass nullptr / an empty vector for parts not done that day. New ids are
+    // written back into the objects. A non-empty clientKey makes retries safe;
+    // reusing it with another fingerprint fails with result.mismatch set.
+    bool logDay(const std::string& clientKey, const std::string& fingerprint, Workout* workout,
+                std::vector<Nutrition>& meals, Recovery* recovery, DayLogResult& result);
     
     // ==================== UTILITY METHODS ====================
     
     // Test database connection
     bool testConnection();
     
-    // Cleanup memory for vectors
-    template<typename T>
-    void cleanupVector(std::vector<T*>& vec) {
-        for (T* ptr : vec) {
-            delete ptr;
-        }
-        vec.clear();
-    }
+    // ==================== CHANGE VERSIONING ====================
+    
+    // Monotonic version of a table, bumped by every successful save/delete
+    unsigned long long getTableVersion(TableId table) const;
+    
+    // Entity tag describing a table's current contents (for conditional GETs)
+    std::string getTableETag(TableId table);
+    
+    // How often to re-read updated_at stamps from MySQL (0 = never)
+    void setExternalCheckInterval(int milliseconds);
+    
+    // Record a write made through another manager in this process (e.g. the
+    // write-behind flusher) so ETags change without waiting for a stamp check
+    void noteWrite(TableId table);
+    
+    // Call listener after every successful save/delete through this manager,
+    // on the writing thread (so it must not block). Set it before the manager
+    // is shared between threads.
+    void setChangeListener(const ChangeListener& listener);
 };
 
 #endif // WORKOUTMANAGER_H
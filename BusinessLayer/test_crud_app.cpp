@@ -5,6 +5,7 @@
 // Date: 2026-01-28
 
 #include "WorkoutManager.h"
+#include "../LocalStoreDAO.h"
 #include <iostream>
 #include <iomanip>
 
@@ -321,8 +322,9 @@ int main() {
     std::string database = "workout_tracker";
     int port = 3306;
     
-    // Create DAO and Manager
-    WorkoutDAO dao(host, user, password, database, port);
+    // Create DAO and Manager (WORKOUT_STORAGE=local uses the embedded store)
+    std::unique_ptr<WorkoutDAO> storage = createWorkoutDAO(host, user, password, database, port);
+    WorkoutDAO& dao = *storage;
     WorkoutManager manager(&dao);
     
     // Test connection
@@ -352,6 +354,12 @@ int main() {
         std::cout << "  • Nutrition CRUD    : ✓ PASSED" << std::endl;
         std::cout << "  • Recovery CRUD     : ✓ PASSED" << std::endl;
         std::cout << "  • Equipment CRUD    : ✓ PASSED" << std::endl;
+        
+        // One query per DAO call; pings only after the connection sat idle
+        ConnectionStats stats = dao.getConnectionStats();
+        std::cout << "\nDatabase round trips: " << stats.queries << " queries, "
+                  << stats.pings << " pings, " << stats.connects << " connects, "
+                  << stats.retries << " retries" << std::endl;
         printSeparator();
         
     } catch (const std::exception& e) {
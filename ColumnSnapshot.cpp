@@ -0,0 +1,461 @@
+// ColumnSnapshot.cpp
+// Workout Tracking System - Memory-mapped columnar snapshots for analytics
+// Author: Therin Emmons
+// Date: 2026-10-18
+#include "ColumnSnapshot.h"
+#include "WorkoutDAO.h"
+#include "RowMapping.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static_assert(sizeof(ColumnSnapshot::Header) == 72, "snapshot header layout changed");
+static_assert(sizeof(ColumnSnapshot::ColumnEntry) == 64, "snapshot column entry layout changed");
+static_assert(sizeof(ColumnSnapshot::Zone) == 8, "snapshot zone layout changed");
+
+namespace {
+const char MAGIC[8] = {'W', 'T', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+// Columns are used in place, so the file's byte order must be the host's
+bool hostIsLittleEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+}
+
+size_t align8(size_t offset) {
+    return (offset + 7) & ~static_cast<size_t>(7);
+}
+
+template<typename V>
+void appendRaw(std::string& out, const V& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void padTo8(std::string& out) {
+    out.resize(align8(out.size()), '\0');
+}
+
+void copyName(char* target, size_t capacity, const std::string& name) {
+    std::memset(target, 0, capacity);
+    std::memcpy(target, name.data(), std::min(name.size(), capacity - 1));
+}
+}
+
+// Destructor
+ColumnSnapshot::~ColumnSnapshot() {
+    close();
+}
+
+int32_t ColumnSnapshot::dateKey(const std::string& date) {
+    if (date.size() < 10 || date[4] != '-' || date[7] != '-') return 0;
+    int32_t key = 0;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (date[i] < '0' || date[i] > '9') return 0;
+        key = key * 10 + (date[i] - '0');
+    }
+    return key;
+}
+
+// ==================== WRITING ====================
+
+bool ColumnSnapshot::write(const std::string& path, const std::string& table,
+                           const std::vector<ColumnData>& data, int dateColumn, std::string& error) {
+    if (!hostIsLittleEndian()) {
+        error = "Snapshots require a little-endian host";
+        return false;
+    }
+
+    size_t rowCount = 0;
+    for (size_t c = 0; c < data.size(); ++c) {
+        size_t rows = data[c].type == Type::TEXT ? data[c].texts.size() : data[c].numbers.size();
+        if (c > 0 && rows != rowCount) {
+            error = "Column " + data[c].name + " has a different row count";
+            return false;
+        }
+        rowCount = rows;
+    }
+    if (dateColumn >= static_cast<int>(data.size()) ||
+        (dateColumn >= 0 && data[dateColumn].type != Type::DATE)) {
+        error = "Invalid date column";
+        return false;
+    }
+
+    uint32_t zoneCount = dateColumn >= 0
+        ? static_cast<uint32_t>((rowCount + ZONE_ROWS - 1) / ZONE_ROWS) : 0;
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.columnCount = static_cast<uint32_t>(data.size());
+    header.rowCount = rowCount;
+    header.zoneRows = ZONE_ROWS;
+    header.zoneCount = zoneCount;
+    header.dateColumn = dateColumn;
+    header.createdAt = static_cast<int64_t>(std::time(nullptr));
+    copyName(header.table, sizeof(header.table), table);
+
+    // Column data goes after the fixed part; entries are filled in as it is laid out
+    std::vector<ColumnEntry> entries(data.size());
+    size_t fixedSize = sizeof(Header) + data.size() * sizeof(ColumnEntry) + zoneCount * sizeof(Zone);
+    std::string body(align8(fixedSize) - fixedSize, '\0');
+    size_t bodyStart = fixedSize;
+
+    for (size_t c = 0; c < data.size(); ++c) {
+        const ColumnData& column = data[c];
+        ColumnEntry& entry = entries[c];
+        std::memset(&entry, 0, sizeof(entry));
+        copyName(entry.name, sizeof(entry.name), column.name);
+        entry.type = static_cast<uint32_t>(column.type);
+        entry.dataOffset = bodyStart + body.size();
+
+        if (column.type == Type::FLOAT64) {
+            for (double value : column.numbers) appendRaw(body, value);
+        } else if (column.type != Type::TEXT) {
+            for (double value : column.numbers) appendRaw(body, static_cast<int32_t>(value));
+        } else {
+            // Dictionary codes in order of first appearance
+            std::map<std::string, uint32_t> codes;
+            std::vector<const std::string*> dictionary;
+            for (const std::string& text : column.texts) {
+                auto inserted = codes.emplace(text, static_cast<uint32_t>(dictionary.size()));
+                if (inserted.second) dictionary.push_back(&inserted.first->first);
+                appendRaw(body, inserted.first->second);
+            }
+            padTo8(body);
+
+            entry.dictionaryOffset = bodyStart + body.size();
+            entry.dictionarySize = dictionary.size();
+            uint32_t offset = 0;
+            for (const std::string* text : dictionary) {
+                appendRaw(body, offset);
+                offset += static_cast<uint32_t>(text->size());
+            }
+            appendRaw(body, offset);
+            for (const std::string* text : dictionary) body += *text;
+        }
+        padTo8(body);
+    }
+
+    std::vector<Zone> zoneMap(zoneCount);
+    for (uint32_t z = 0; z < zoneCount; ++z) {
+        const std::vector<double>& dates = data[dateColumn].numbers;
+        size_t first = static_cast<size_t>(z) * ZONE_ROWS;
+        size_t last = std::min(rowCount, first + ZONE_ROWS);
+        zoneMap[z].minDate = static_cast<int32_t>(*std::min_element(dates.begin() + first, dates.begin() + last));
+        zoneMap[z].maxDate = static_cast<int32_t>(*std::max_element(dates.begin() + first, dates.begin() + last));
+    }
+
+    // Write aside and rename, so a reader never maps a half-written file
+    std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ColumnEntry));
+    out.write(reinterpret_cast<const char*>(zoneMap.data()), zoneMap.size() * sizeof(Zone));
+    out.write(body.data(), body.size());
+    out.close();
+
+    if (!out || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        error = "Cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+// ==================== READING ====================
+
+bool ColumnSnapshot::open(const std::string& path, std::string& error) {
+    close();
+    if (!hostIsLittleEndian()) {
+        error = "Snapshots require a little-endian host";
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = "Cannot open " + path;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        error = path + " is not a snapshot";
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        error = "Cannot map " + path;
+        return false;
+    }
+    madvise(mapping, length, MADV_WILLNEED);
+
+    base = static_cast<const char*>(mapping);
+    size = length;
+    const Header* candidate = reinterpret_cast<const Header*>(base);
+
+    // Check everything the accessors will rely on before accepting the file
+    bool valid = std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 candidate->version == FORMAT_VERSION &&
+                 candidate->dateColumn < static_cast<int32_t>(candidate->columnCount);
+    size_t fixedSize = sizeof(Header) + candidate->columnCount * sizeof(ColumnEntry) +
+                       candidate->zoneCount * sizeof(Zone);
+    valid = valid && candidate->columnCount < 1024 && fixedSize <= size;
+
+    const ColumnEntry* entries = reinterpret_cast<const ColumnEntry*>(base + sizeof(Header));
+    for (uint32_t c = 0; valid && c < candidate->columnCount; ++c) {
+        const ColumnEntry& entry = entries[c];
+        size_t width = entry.type == static_cast<uint32_t>(Type::FLOAT64) ? 8 : 4;
+        valid = entry.type >= 1 && entry.type <= 4 && entry.dataOffset % 8 == 0 &&
+                entry.dataOffset <= size && candidate->rowCount <= (size - entry.dataOffset) / width;
+        if (valid && entry.type == static_cast<uint32_t>(Type::TEXT)) {
+            valid = entry.dictionaryOffset % 4 == 0 && entry.dictionaryOffset <= size &&
+                    entry.dictionarySize < (size - entry.dictionaryOffset) / 4;
+        }
+    }
+    if (valid && candidate->dateColumn >= 0) {
+        valid = entries[candidate->dateColumn].type == static_cast<uint32_t>(Type::DATE) &&
+                candidate->zoneRows > 0 &&
+                candidate->zoneCount == (candidate->rowCount + candidate->zoneRows - 1) / candidate->zoneRows;
+    }
+
+    if (!valid) {
+        close();
+        error = path + " is not a version " + std::to_string(FORMAT_VERSION) + " snapshot";
+        return false;
+    }
+
+    header = candidate;
+    columns = entries;
+    zones = reinterpret_cast<const Zone*>(base + sizeof(Header) + header->columnCount * sizeof(ColumnEntry));
+    return true;
+}
+
+void ColumnSnapshot::close() {
+    if (base) munmap(const_cast<char*>(base), size);
+    base = nullptr;
+    size = 0;
+    header = nullptr;
+    columns = nullptr;
+    zones = nullptr;
+}
+
+std::string ColumnSnapshot::getTable() const {
+    if (!header) return "";
+    return std::string(header->table, strnlen(header->table, sizeof(header->table)));
+}
+
+int ColumnSnapshot::columnIndex(const std::string& name) const {
+    if (!header) return -1;
+    for (uint32_t c = 0; c < header->columnCount; ++c) {
+        if (strnlen(columns[c].name, sizeof(columns[c].name)) == name.size() &&
+            std::memcmp(columns[c].name, name.data(), name.size()) == 0) {
+            return static_cast<int>(c);
+        }
+    }
+    return -1;
+}
+
+const int32_t* ColumnSnapshot::int32Column(int column) const {
+    if (!header || column < 0 || static_cast<uint32_t>(column) >= header->columnCount) return nullptr;
+    uint32_t type = columns[column].type;
+    if (type != static_cast<uint32_t>(Type::INT32) && type != static_cast<uint32_t>(Type::DATE)) return nullptr;
+    return reinterpret_cast<const int32_t*>(base + columns[column].dataOffset);
+}
+
+const double* ColumnSnapshot::float64Column(int column) const {
+    if (!header || column < 0 || static_cast<uint32_t>(column) >= header->columnCount) return nullptr;
+    if (columns[column].type != static_cast<uint32_t>(Type::FLOAT64)) return nullptr;
+    return reinterpret_cast<const double*>(base + columns[column].dataOffset);
+}
+
+const uint32_t* ColumnSnapshot::textCodes(int column) const {
+    if (!header || column < 0 || static_cast<uint32_t>(column) >= header->columnCount) return nullptr;
+    if (columns[column].type != static_cast<uint32_t>(Type::TEXT)) return nullptr;
+    return reinterpret_cast<const uint32_t*>(base + columns[column].dataOffset);
+}
+
+size_t ColumnSnapshot::dictionarySize(int column) const {
+    return textCodes(column) ? static_cast<size_t>(columns[column].dictionarySize) : 0;
+}
+
+std::string ColumnSnapshot::dictionaryEntry(int column, uint32_t code) const {
+    if (code >= dictionarySize(column)) return "";
+    const ColumnEntry& entry = columns[column];
+    const uint32_t* offsets = reinterpret_cast<const uint32_t*>(base + entry.dictionaryOffset);
+    size_t bytes = entry.dictionaryOffset + (entry.dictionarySize + 1) * 4;
+    size_t start = offsets[code];
+    size_t end = offsets[code + 1];
+    if (start > end || bytes + end > size) return "";
+    return std::string(base + bytes + start, end - start);
+}
+
+// The zone map finds the first block that can hold fromDate and the last
+// that can hold toDate; binary search inside those blocks gives the exact rows
+std::pair<size_t, size_t> ColumnSnapshot::dateRange(int32_t fromDate, int32_t toDate) const {
+    if (!header || header->dateColumn < 0 || fromDate > toDate) return {0, 0};
+
+    const int32_t* dates = int32Column(header->dateColumn);
+    size_t rows = getRowCount();
+    size_t zoneRows = header->zoneRows;
+    const Zone* zonesEnd = zones + header->zoneCount;
+
+    size_t firstZone = std::partition_point(zones, zonesEnd,
+        [fromDate](const Zone& zone) { return zone.maxDate < fromDate; }) - zones;
+    size_t endZone = std::partition_point(zones, zonesEnd,
+        [toDate](const Zone& zone) { return zone.minDate <= toDate; }) - zones;
+    if (firstZone >= endZone) return {0, 0};
+
+    size_t zoneStart = firstZone * zoneRows;
+    size_t first = std::lower_bound(dates + zoneStart, dates + std::min(rows, zoneStart + zoneRows),
+                                    fromDate) - dates;
+    size_t lastStart = (endZone - 1) * zoneRows;
+    size_t last = std::upper_bound(dates + lastStart, dates + std::min(rows, lastStart + zoneRows),
+                                   toDate) - dates;
+    return first < last ? std::make_pair(first, last) : std::make_pair(first, first);
+}
+
+double ColumnSnapshot::sumByDate(const std::string& column, int32_t fromDate, int32_t toDate) const {
+    int index = columnIndex(column);
+    std::pair<size_t, size_t> rows = dateRange(fromDate, toDate);
+    double total = 0.0;
+
+    if (const double* values = float64Column(index)) {
+        for (size_t row = rows.first; row < rows.second; ++row) total += values[row];
+    } else if (const int32_t* values = int32Column(index)) {
+        for (size_t row = rows.first; row < rows.second; ++row) total += values[row];
+    }
+    return total;
+}
+
+// ==================== EXPORT ====================
+
+namespace {
+typedef std::vector<std::pair<const char*, ColumnSnapshot::Type>> Layout;
+
+// Columns of a table in row order, read through RowMapping<T>
+template<typename T>
+std::vector<ColumnSnapshot::ColumnData> buildColumns(const ResultSet<T>& rows, const std::vector<size_t>& order,
+                                                     const Layout& layout) {
+    std::vector<ColumnSnapshot::ColumnData> columns;
+    for (const auto& spec : layout) {
+        ColumnSnapshot::ColumnData column;
+        column.name = spec.first;
+        column.type = spec.second;
+        const FieldMapping<T>& field = RowMapping<T>::fields[fieldIndex<T>(spec.first)];
+
+        for (size_t index : order) {
+            std::string text = field.read(rows[index]);
+            switch (spec.second) {
+                case ColumnSnapshot::Type::TEXT:
+                    column.texts.push_back(std::move(text));
+                    break;
+                case ColumnSnapshot::Type::DATE:
+                    column.numbers.push_back(ColumnSnapshot::dateKey(text));
+                    break;
+                case ColumnSnapshot::Type::INT32:
+                    column.numbers.push_back(parseIntField(text.c_str()));
+                    break;
+                default:
+                    column.numbers.push_back(parseDoubleField(text.c_str()));
+                    break;
+            }
+        }
+        columns.push_back(std::move(column));
+    }
+    return columns;
+}
+
+// Row order for export: by date when the table has one, else as read
+template<typename T>
+std::vector<size_t> exportOrder(const ResultSet<T>& rows, const char* dateColumn) {
+    std::vector<size_t> order(rows.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    if (dateColumn) {
+        const FieldMapping<T>& field = RowMapping<T>::fields[fieldIndex<T>(dateColumn)];
+        std::vector<int32_t> keys(rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) keys[i] = ColumnSnapshot::dateKey(field.read(rows[i]));
+        std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+    }
+    return order;
+}
+
+// Computed columns appended after the mapped ones (none by default)
+template<typename T>
+void addDerivedColumns(const ResultSet<T>&, const std::vector<size_t>&,
+                       std::vector<ColumnSnapshot::ColumnData>&) {}
+
+// Nutrition: meal calories, so analytics need not repeat the formula
+void addDerivedColumns(const ResultSet<Nutrition>& rows, const std::vector<size_t>& order,
+                       std::vector<ColumnSnapshot::ColumnData>& columns) {
+    ColumnSnapshot::ColumnData calories;
+    calories.name = "calories";
+    calories.type = ColumnSnapshot::Type::FLOAT64;
+    for (size_t index : order) calories.numbers.push_back(rows[index].calculateTotalCalories());
+    columns.push_back(std::move(calories));
+}
+
+template<typename T>
+bool exportTable(const ResultSet<T>& rows, const std::string& path, const Layout& layout,
+                 const char* dateColumn, std::string& error) {
+    std::vector<size_t> order = exportOrder(rows, dateColumn);
+    std::vector<ColumnSnapshot::ColumnData> columns = buildColumns(rows, order, layout);
+
+    int dateIndex = -1;
+    for (size_t c = 0; dateColumn && c < layout.size(); ++c) {
+        if (std::strcmp(layout[c].first, dateColumn) == 0) dateIndex = static_cast<int>(c);
+    }
+
+    addDerivedColumns(rows, order, columns);
+    return ColumnSnapshot::write(path, RowMapping<T>::table, columns, dateIndex, error);
+}
+}
+
+bool AnalyticsSnapshot::exportFrom(WorkoutDAO& dao, const std::string& directory, std::string& error) {
+    using Type = ColumnSnapshot::Type;
+    std::string dir = directory.empty() ? "." : directory;
+
+    return exportTable(dao.readAllWorkouts(), dir + "/workout.snap",
+                       {{"workout_id", Type::INT32}, {"workout_date", Type::DATE},
+                        {"workout_time", Type::TEXT}, {"duration", Type::INT32},
+                        {"type_description", Type::TEXT}, {"calories_burned", Type::FLOAT64},
+                        {"rate_perceived_exhaustion", Type::INT32}, {"muscle_group_id", Type::INT32}},
+                       "workout_date", error) &&
+           exportTable(dao.readAllMuscleGroups(), dir + "/musclegroup.snap",
+                       {{"muscle_group_id", Type::INT32}, {"name", Type::TEXT},
+                        {"description", Type::TEXT}, {"days_per_week", Type::INT32},
+                        {"sets", Type::INT32}, {"reps", Type::INT32}, {"weight_amount", Type::FLOAT64}},
+                       nullptr, error) &&
+           exportTable(dao.readAllNutrition(), dir + "/nutrition.snap",
+                       {{"nutrition_id", Type::INT32}, {"family", Type::TEXT},
+                        {"water", Type::FLOAT64}, {"carbs", Type::FLOAT64}, {"fat", Type::FLOAT64},
+                        {"protein", Type::FLOAT64}, {"sugar", Type::FLOAT64}, {"meal_date", Type::DATE}},
+                       "meal_date", error) &&
+           exportTable(dao.readAllRecovery(), dir + "/recovery.snap",
+                       {{"recovery_id", Type::INT32}, {"recovery_date", Type::DATE},
+                        {"duration", Type::INT32}, {"type", Type::TEXT}, {"helpers", Type::TEXT}},
+                       "recovery_date", error) &&
+           exportTable(dao.readAllEquipment(), dir + "/equipment.snap",
+                       {{"equipment_id", Type::INT32}, {"name", Type::TEXT},
+                        {"description", Type::TEXT}, {"category", Type::TEXT}, {"target", Type::TEXT}},
+                       nullptr, error);
+}
+
+bool AnalyticsSnapshot::open(const std::string& directory, std::string& error) {
+    std::string dir = directory.empty() ? "." : directory;
+    return workoutTable.open(dir + "/workout.snap", error) &&
+           muscleGroupTable.open(dir + "/musclegroup.snap", error) &&
+           nutritionTable.open(dir + "/nutrition.snap", error) &&
+           recoveryTable.open(dir + "/recovery.snap", error) &&
+           equipmentTable.open(dir + "/equipment.snap", error);
+}
@@ -0,0 +1,157 @@
+// ColumnSnapshot.h
+// Workout Tracking System - Memory-mapped columnar snapshots for analytics
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef COLUMNSNAPSHOT_H
+#define COLUMNSNAPSHOT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+class WorkoutDAO;
+
+/*
+ * One table exported to a read-only columnar file. The file is mmap'd and
+ * its columns are used in place: a FLOAT64 column is a const double* into
+ * the mapping, so opening a snapshot costs one mmap and a header check no
+ * matter how many rows it holds, and a warm page cache makes that instant.
+ *
+ *   header | column directory | zone map | column data (8-byte aligned)
+ *
+ *   INT32 / FLOAT64  fixed-width little-endian values, one per row
+ *   DATE             int32 yyyymmdd ("2026-01-20" -> 20260120)
+ *   TEXT             uint32 dictionary codes per row, then the dictionary:
+ *                    (count + 1) uint32 offsets followed by the bytes
+ *
+ * Tables with a date column are written sorted by it, and the zone map holds
+ * the min/max date of every block of zoneRows rows, so a date range maps to
+ * one contiguous run of rows without touching the others.
+ *
+ * The header carries a magic and a format version; files of another
+ * version are refused rather than misread.
+ */
+class ColumnSnapshot {
+public:
+    enum class Type : uint32_t {
+        INT32 = 1,
+        FLOAT64 = 2,
+        DATE = 3,
+        TEXT = 4
+    };
+
+    static const uint32_t FORMAT_VERSION = 1;
+    static const uint32_t ZONE_ROWS = 1024;
+
+    // A column to write: numbers for INT32/FLOAT64/DATE, texts for TEXT
+    struct ColumnData {
+        std::string name;
+        Type type;
+        std::vector<double> numbers;
+        std::vector<std::string> texts;
+    };
+
+    // On-disk structures (exposed so they can be checked with static_assert)
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t columnCount;
+        uint64_t rowCount;
+        uint32_t zoneRows;
+        uint32_t zoneCount;
+        int32_t dateColumn;  // -1 when the table has no date column
+        uint32_t reserved;
+        int64_t createdAt;   // epoch seconds of the export
+        char table[24];
+    };
+
+    struct ColumnEntry {
+        char name[32];
+        uint32_t type;
+        uint32_t reserved;
+        uint64_t dataOffset;
+        uint64_t dictionaryOffset;  // TEXT only
+        uint64_t dictionarySize;    // entries in the dictionary
+    };
+
+    struct Zone {
+        int32_t minDate;
+        int32_t maxDate;
+    };
+
+private:
+    const char* base = nullptr;
+    size_t size = 0;
+    const Header* header = nullptr;
+    const ColumnEntry* columns = nullptr;
+    const Zone* zones = nullptr;
+
+public:
+    ColumnSnapshot() = default;
+    ~ColumnSnapshot();
+    ColumnSnapshot(const ColumnSnapshot&) = delete;
+    ColumnSnapshot& operator=(const ColumnSnapshot&) = delete;
+
+    // Write a snapshot file (to a temporary name, renamed into place).
+    // Rows must already be sorted by dateColumn when there is one.
+    static bool write(const std::string& path, const std::string& table,
+                      const std::vector<ColumnData>& data, int dateColumn, std::string& error);
+
+    bool open(const std::string& path, std::string& error);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    std::string getTable() const;
+    size_t getRowCount() const { return header ? static_cast<size_t>(header->rowCount) : 0; }
+    long long getCreatedAt() const { return header ? header->createdAt : 0; }
+    int columnIndex(const std::string& name) const;  // -1 when absent
+
+    // Column views into the mapping (nullptr on a type mismatch)
+    const int32_t* int32Column(int column) const;   // INT32 and DATE
+    const double* float64Column(int column) const;
+    const uint32_t* textCodes(int column) const;
+    size_t dictionarySize(int column) const;
+    std::string dictionaryEntry(int column, uint32_t code) const;
+
+    // Rows [first, last) whose date is within [fromDate, toDate] (yyyymmdd)
+    std::pair<size_t, size_t> dateRange(int32_t fromDate, int32_t toDate) const;
+
+    // Sum of a numeric column over the rows dated within [fromDate, toDate]
+    double sumByDate(const std::string& column, int32_t fromDate, int32_t toDate) const;
+
+    // "YYYY-MM-DD" -> yyyymmdd, 0 when malformed
+    static int32_t dateKey(const std::string& date);
+};
+
+/*
+ * The five tables exported side by side into one directory
+ * (workout.snap, musclegroup.snap, nutrition.snap, recovery.snap,
+ * equipment.snap). Nutrition gets an extra "calories" column computed with
+ * Nutrition::calculateTotalCalories at export time.
+ */
+class AnalyticsSnapshot {
+private:
+    ColumnSnapshot workoutTable;
+    ColumnSnapshot muscleGroupTable;
+    ColumnSnapshot nutritionTable;
+    ColumnSnapshot recoveryTable;
+    ColumnSnapshot equipmentTable;
+
+public:
+    // Read every table through the DAO and write the snapshot files
+    static bool exportFrom(WorkoutDAO& dao, const std::string& directory, std::string& error);
+
+    bool open(const std::string& directory, std::string& error);
+    bool isOpen() const { return workoutTable.isOpen(); }
+
+    const ColumnSnapshot& workouts() const { return workoutTable; }
+    const ColumnSnapshot& muscleGroups() const { return muscleGroupTable; }
+    const ColumnSnapshot& nutrition() const { return nutritionTable; }
+    const ColumnSnapshot& recovery() const { return recoveryTable; }
+    const ColumnSnapshot& equipment() const { return equipmentTable; }
+};
+
+#endif // COLUMNSNAPSHOT_H
@@ -0,0 +1,255 @@
+// ConnectionPolicy.h
+// Workout Tracking System - Timeouts, retry backoff and circuit breaker for the DAO
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef CONNECTIONPOLICY_H
+#define CONNECTIONPOLICY_H
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+
+// Connection settings, overridable through environment variables:
+//   WORKOUT_DB_CONNECT_TIMEOUT       seconds to wait for a connection (default 3)
+//   WORKOUT_DB_READ_TIMEOUT          seconds to wait for a query result (default 10)
+//   WORKOUT_DB_WRITE_TIMEOUT         seconds to wait while sending a query (default 10)
+//   WORKOUT_DB_IDLE_PING_SECONDS     ping before reuse only after this much idle time (default 30)
+//   WORKOUT_DB_READ_RETRIES          extra attempts for reads after a dropped connection (default 2)
+//   WORKOUT_DB_BREAKER_THRESHOLD     consecutive connection failures that open the circuit (default 3)
+//   WORKOUT_DB_BREAKER_COOLDOWN_MS   how long the circuit stays open before a probe (default 5000)
+//   WORKOUT_DB_REPLICAS              read replicas as "host[:port],host[:port]" (default none)
+//   WORKOUT_DB_STICKY_MS             reads stay on the primary this long after a write (default 5000)
+struct ConnectionPolicy {
+    unsigned int connectTimeoutSec = 3;
+    unsigned int readTimeoutSec = 10;
+    unsigned int writeTimeoutSec = 10;
+    int idlePingSec = 30;
+    int readRetries = 2;
+    int backoffBaseMs = 50;
+    int backoffMaxMs = 1000;
+    int breakerThreshold = 3;
+    int breakerCooldownMs = 5000;
+    std::vector<std::pair<std::string, int>> replicas;
+    int stickyMs = 5000;
+
+    static ConnectionPolicy fromEnvironment() {
+        ConnectionPolicy policy;
+        readSetting("WORKOUT_DB_CONNECT_TIMEOUT", policy.connectTimeoutSec);
+        readSetting("WORKOUT_DB_READ_TIMEOUT", policy.readTimeoutSec);
+        readSetting("WORKOUT_DB_WRITE_TIMEOUT", policy.writeTimeoutSec);
+        readSetting("WORKOUT_DB_IDLE_PING_SECONDS", policy.idlePingSec);
+        readSetting("WORKOUT_DB_READ_RETRIES", policy.readRetries);
+        readSetting("WORKOUT_DB_BREAKER_THRESHOLD", policy.breakerThreshold);
+        readSetting("WORKOUT_DB_BREAKER_COOLDOWN_MS", policy.breakerCooldownMs);
+        readSetting("WORKOUT_DB_STICKY_MS", policy.stickyMs);
+        if (const char* replicas = std::getenv("WORKOUT_DB_REPLICAS")) {
+            policy.replicas = parseReplicas(replicas);
+        }
+        return policy;
+    }
+
+    // Delay before retry number attempt (0-based): exponential with full
+    // jitter, so clients that failed together do not retry together
+    int backoffDelayMs(int attempt) const {
+        int ceiling = backoffBaseMs;
+        for (int i = 0; i < attempt && ceiling < backoffMaxMs; ++i) {
+            ceiling *= 2;
+        }
+        if (ceiling > backoffMaxMs) ceiling = backoffMaxMs;
+
+        thread_local std::mt19937 generator(std::random_device{}());
+        std::uniform_int_distribution<int> jitter(0, ceiling);
+        return jitter(generator);
+    }
+
+    // "db2:3307, db3" -> {("db2", 3307), ("db3", 3306)}
+    static std::vector<std::pair<std::string, int>> parseReplicas(const std::string& list) {
+        std::vector<std::pair<std::string, int>> result;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos) end = list.size();
+
+            std::string entry = list.substr(start, end - start);
+            size_t first = entry.find_first_not_of(" \t");
+            size_t last = entry.find_last_not_of(" \t");
+            if (first != std::string::npos) {
+                entry = entry.substr(first, last - first + 1);
+                int port = 3306;
+                size_t colon = entry.rfind(':');
+                if (colon != std::string::npos) {
+                    port = std::atoi(entry.c_str() + colon + 1);
+                    entry.erase(colon);
+                }
+                if (!entry.empty() && port > 0) result.emplace_back(entry, port);
+            }
+            start = end + 1;
+        }
+        return result;
+    }
+
+private:
+    template<typename T>
+    static void readSetting(const char* name, T& value) {
+        const char* text = std::getenv(name);
+        if (!text) return;
+        long parsed = std::atol(text);
+        if (parsed >= 0) value = static_cast<T>(parsed);
+    }
+};
+
+/*
+ * Fails fast while the database is unreachable. After `threshold`
+ * consecutive connection failures the circuit opens and callers are refused
+ * without touching the network. Once the cooldown has passed one caller is
+ * let through as a probe (half-open): success closes the circuit, failure
+ * opens it for another cooldown. Other callers are refused until the probe
+ * has reported, so a database that is still down costs one connect timeout
+ * per cooldown rather than one per request thread. A caller let through by
+ * allowRequest() must report recordSuccess() or recordFailure().
+ */
+class CircuitBreaker {
+public:
+    enum class State {
+        CLOSED,
+        OPEN,
+        HALF_OPEN
+    };
+
+private:
+    mutable std::mutex mutex;
+    State state = State::CLOSED;
+    int threshold;
+    int cooldownMs;
+    int consecutiveFailures = 0;
+    bool probing = false;   // a half-open probe has been let through and not reported yet
+    unsigned long long timesOpened = 0;
+    std::chrono::steady_clock::time_point openedAt;
+
+    bool coolingDown(std::chrono::steady_clock::time_point now) const {
+        return now - openedAt < std::chrono::milliseconds(cooldownMs);
+    }
+
+    bool rejecting(std::chrono::steady_clock::time_point now) const {
+        return (state == State::OPEN && coolingDown(now)) || (state == State::HALF_OPEN && probing);
+    }
+
+public:
+    explicit CircuitBreaker(int failureThreshold = 3, int cooldownMilliseconds = 5000)
+        : threshold(failureThreshold), cooldownMs(cooldownMilliseconds) {}
+
+    void configure(int failureThreshold, int cooldownMilliseconds) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threshold = failureThreshold;
+        cooldownMs = cooldownMilliseconds;
+    }
+
+    // May the caller try the database? After the cooldown the first caller
+    // moves OPEN to HALF_OPEN and becomes the probe; the rest wait for it.
+    bool allowRequest() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state == State::CLOSED) return true;
+        if (rejecting(std::chrono::steady_clock::now())) return false;
+        state = State::HALF_OPEN;
+        probing = true;
+        return true;
+    }
+
+    void recordSuccess() {
+        std::lock_guard<std::mutex> lock(mutex);
+        state = State::CLOSED;
+        probing = false;
+        consecutiveFailures = 0;
+    }
+
+    void recordFailure() {
+        std::lock_guard<std::mutex> lock(mutex);
+        probing = false;
+        ++consecutiveFailures;
+        if (state == State::HALF_OPEN || (threshold > 0 && consecutiveFailures >= threshold)) {
+            if (state != State::OPEN) ++timesOpened;
+            state = State::OPEN;
+            openedAt = std::chrono::steady_clock::now();
+        }
+    }
+
+    State getState() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return state;
+    }
+
+    // True while requests are being refused (open and still cooling down, or
+    // half-open with the probe still out)
+    bool isRejecting() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return rejecting(std::chrono::steady_clock::now());
+    }
+
+    // Milliseconds until the next probe is allowed (0 unless rejecting)
+    int retryAfterMs() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (state != State::OPEN) return 0;
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - openedAt).count();
+        return elapsed >= cooldownMs ? 0 : static_cast<int>(cooldownMs - elapsed);
+    }
+
+    int getConsecutiveFailures() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return consecutiveFailures;
+    }
+
+    unsigned long long getTimesOpened() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return timesOpened;
+    }
+
+    static const char* stateName(State state) {
+        switch (state) {
+            case State::CLOSED:    return "closed";
+            case State::OPEN:      return "open";
+            default:               return "half_open";
+        }
+    }
+};
+
+/*
+ * Carries the read-your-writes deadline (WorkoutDAO::getPrimaryReadsUntil)
+ * between a client's requests, so a page or API call made right after a
+ * write is read from the primary even if it lands on another thread or
+ * process:  Set-Cookie: workout_rw=<epoch ms>
+ */
+struct ReadYourWritesCookie {
+    static constexpr const char* name = "workout_rw";
+
+    // Deadline from a Cookie header, or 0 when absent. The value comes from
+    // the client, so it is capped at nowMs + stickyMs: a forged cookie can
+    // keep reads on the primary no longer than a real write would.
+    static long long parse(const std::string& cookieHeader, long long nowMs, int stickyMs) {
+        std::string prefix = std::string(name) + "=";
+        size_t pos = 0;
+        while ((pos = cookieHeader.find(prefix, pos)) != std::string::npos) {
+            if (pos == 0 || cookieHeader[pos - 1] == ' ' || cookieHeader[pos - 1] == ';') {
+                long long until = std::atoll(cookieHeader.c_str() + pos + prefix.size());
+                return std::max(0LL, std::min(until, nowMs + stickyMs));
+            }
+            pos += prefix.size();
+        }
+        return 0;
+    }
+
+    // Set-Cookie value that expires with the deadline
+    static std::string format(long long untilMs, long long nowMs) {
+        long long maxAge = (untilMs - nowMs + 999) / 1000;
+        return std::string(name) + "=" + std::to_string(untilMs) +
+               "; Max-Age=" + std::to_string(maxAge > 0 ? maxAge : 0) + "; Path=/; HttpOnly; SameSite=Lax";
+    }
+};
+
+#endif // CONNECTIONPOLICY_H
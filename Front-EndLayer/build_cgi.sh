@@ -46,7 +46,7 @@ g++ -std=c++17 -Isrc -I/usr/include/mysql \
     ../ServiceLayer/WorkoutService.cpp \
     ../BusinessLayer/*.cpp \
     ../*.cpp \
-    -L/usr/lib/x86_64-linux-gnu -lmysqlclient \
+    -L/usr/lib/x86_64-linux-gnu -lmysqlclient -lz -lrt \
     -o workout.cgi
 
 if [ $? -eq 0 ]; then
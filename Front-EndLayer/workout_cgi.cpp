@@ -44,6 +44,10 @@
  */
 
 #include "../ServiceLayer/WorkoutService.h"
+#include "../ServiceLayer/CompressionHelper.h"
+#include "../ServiceLayer/FormDecoder.h"
+#include "../ServiceLayer/SharedCache.h"
+#include "../LocalStoreDAO.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -51,49 +55,112 @@
 #include <sstream>
 #include <cstdlib>
 #include <algorithm>
+#include <chrono>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
 
 // ==================== CGI UTILITY FUNCTIONS ====================
 
-// Parse query string into map
-std::map<std::string, std::string> parseQueryString(const std::string& query) {
-    std::map<std::string, std::string> params;
-    std::istringstream iss(query);
-    std::string pair;
-    
-    while (std::getline(iss, pair, '&')) {
-        size_t pos = pair.find('=');
-        if (pos != std::string::npos) {
-            std::string key = pair.substr(0, pos);
-            std::string value = pair.substr(pos + 1);
-            
-            // URL decode
-            std::string decoded;
-            for (size_t i = 0; i < value.length(); ++i) {
-                if (value[i] == '+') {
-                    decoded += ' ';
-                } else if (value[i] == '%' && i + 2 < value.length()) {
-                    int hex;
-                    std::istringstream hexStream(value.substr(i + 1, 2));
-                    hexStream >> std::hex >> hex;
-                    decoded += static_cast<char>(hex);
-                    i += 2;
-                } else {
-                    decoded += value[i];
-                }
-            }
-            params[key] = decoded;
-        }
-    }
-    
-    return params;
-}
-
 // Get environment variable
 std::string getEnv(const char* name) {
     const char* value = std::getenv(name);
     return value ? std::string(value) : "";
 }
 
+// ==================== REQUEST PARAMETERS ====================
+
+// Numeric form fields. Each is converted once when the request is parsed;
+// the first INTEGER_FIELDS are integers, the rest decimals.
+enum class NumericField {
+    ID, DURATION, RPE, MUSCLE_GROUP_ID, DAYS_PER_WEEK, SETS, REPS,
+    CALORIES, WEIGHT, WATER, CARBS, FAT, PROTEIN, SUGAR,
+    COUNT
+};
+
+constexpr size_t INTEGER_FIELDS = 7;
+constexpr const char* numericFieldNames[] = {
+    "id", "duration", "rpe", "muscle_group_id", "days_per_week", "sets", "reps",
+    "calories", "weight", "water", "carbs", "fat", "protein", "sugar"
+};
+static_assert(sizeof(numericFieldNames) / sizeof(numericFieldNames[0]) ==
+              static_cast<size_t>(NumericField::COUNT), "a NumericField is missing its name");
+
+// The parameters of one request: text as sent, numbers already converted.
+// A missing or malformed required field throws std::invalid_argument, which
+// handleRequest turns into an error page. A field sent twice reads as its
+// first value.
+class CgiParams {
+private:
+    struct Number {
+        double value = 0.0;
+        bool valid = false;
+    };
+    
+    FormDecoder form;
+    std::array<Number, static_cast<size_t>(NumericField::COUNT)> numbers;
+    
+public:
+    // Decode a query string or form body
+    explicit CgiParams(std::string_view input) {
+        form.parse(input);
+        for (size_t field = 0; field < numbers.size(); ++field) {
+            std::string_view text = form.get(numericFieldNames[field]);
+            if (text.empty()) continue;
+            
+            const char* first = text.data();
+            const char* last = first + text.size();
+            if (field < INTEGER_FIELDS) {
+                int parsed = 0;
+                auto result = std::from_chars(first, last, parsed);
+                numbers[field].value = parsed;
+                numbers[field].valid = result.ec == std::errc();
+            } else {
+                auto result = std::from_chars(first, last, numbers[field].value);
+                numbers[field].valid = result.ec == std::errc();
+            }
+        }
+    }
+    
+    bool has(const char* name) const {
+        return form.has(name);
+    }
+    
+    // Required text field
+    std::string text(const char* name) const {
+        const FormDecoder::Field* field = form.find(name);
+        if (!field) {
+            throw std::invalid_argument(std::string("Missing field: ") + name);
+        }
+        return std::string(field->value);
+    }
+    
+    // Optional text field
+    std::string text(const char* name, const char* fallback) const {
+        const FormDecoder::Field* field = form.find(name);
+        return field ? std::string(field->value) : std::string(fallback);
+    }
+    
+    int integer(NumericField field) const {
+        return static_cast<int>(number(field));
+    }
+    
+    double number(NumericField field) const {
+        const Number& entry = numbers[static_cast<size_t>(field)];
+        if (!entry.valid) {
+            throw std::invalid_argument(std::string("Missing or invalid field: ") +
+                                        numericFieldNames[static_cast<size_t>(field)]);
+        }
+        return entry.value;
+    }
+    
+    int id() const {
+        return integer(NumericField::ID);
+    }
+};
+
 // URL encode
 std::string urlEncode(const std::string& str) {
     std::ostringstream escaped;
@@ -130,7 +197,6 @@ std::string htmlEscape(const std::string& str) {
 // ==================== HTML GENERATION ====================
 
 void printHTMLHeader(const std::string& title) {
-    std::cout << "Content-Type: text/html\r\n\r\n";
     std::cout << R"(<!DOCTYPE html>
 <html lang="en">
 <head>
@@ -373,11 +439,11 @@ You can create, view, update, and delete records across all five tables in the d
 }
 
 // Forward declarations for list/form handlers
-void showWorkoutList(WorkoutService& service, const std::map<std::string, std::string>& params);
+void showWorkoutList(WorkoutService& service, const CgiParams& params);
 void showWorkoutInsertForm();
 void showWorkoutUpdateForm(WorkoutService& service, int id);
-void handleWorkoutInsert(WorkoutService& service, const std::map<std::string, std::string>& params);
-void handleWorkoutUpdate(WorkoutService& service, const std::map<std::string, std::string>& params);
+void handleWorkoutInsert(WorkoutService& service, const CgiParams& params);
+void handleWorkoutUpdate(WorkoutService& service, const CgiParams& params);
 void handleWorkoutDelete(WorkoutService& service, int id);
 
 void viewWorkout(WorkoutService& service, int id) {
@@ -468,18 +534,18 @@ void showWorkoutUpdateForm(WorkoutService& service, int id) {
     printHTMLFooter();
 }
 
-void handleWorkoutUpdate(WorkoutService& service, const std::map<std::string, std::string>& params) {
-    int id = std::stoi(params.at("id"));
+void handleWorkoutUpdate(WorkoutService& service, const CgiParams& params) {
+    int id = params.id();
     
     ServiceResponse response = service.updateWorkout(
         id,
-        params.at("date"),
-        params.at("time") + ":00",
-        std::stoi(params.at("duration")),
-        params.at("type"),
-        std::stod(params.at("calories")),
-        std::stoi(params.at("rpe")),
-        std::stoi(params.at("muscle_group_id"))
+        params.text("date"),
+        params.text("time") + ":00",
+        params.integer(NumericField::DURATION),
+        params.text("type"),
+        params.number(NumericField::CALORIES),
+        params.integer(NumericField::RPE),
+        params.integer(NumericField::MUSCLE_GROUP_ID)
     );
     
     printHTMLHeader("Workout Updated");
@@ -511,7 +577,7 @@ void handleWorkoutDelete(WorkoutService& service, int id) {
 
 // ==================== MUSCLEGROUP HANDLERS ====================
 
-void listMuscleGroups(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void listMuscleGroups(WorkoutService& service, const CgiParams& params) {
     printHTMLHeader("Muscle Groups - List All");
     
     std::cout << "<div class=\"action-bar\">\n";
@@ -519,7 +585,7 @@ void listMuscleGroups(WorkoutService& service, const std::map<std::string, std::
     std::cout << "  <a href=\"workout.cgi?action=insert_form&table=musclegroup\" class=\"btn btn-success\">➕ Add New Muscle Group</a>\n";
     std::cout << "</div>\n";
     
-    std::vector<MuscleGroup*> groups = service.getAllMuscleGroups();
+    ResultSet<MuscleGroup> groups = service.getAllMuscleGroups();
     
     std::cout << "<p>Total muscle groups: <strong>" << groups.size() << "</strong></p>\n";
     
@@ -532,22 +598,21 @@ void listMuscleGroups(WorkoutService& service, const std::map<std::string, std::
         std::cout << "  <th>Sets</th><th>Reps</th><th>Weight (lbs)</th><th>Actions</th>\n";
         std::cout << "</tr>\n";
         
-        for (MuscleGroup* mg : groups) {
+        for (const MuscleGroup& mg : groups) {
             std::cout << "<tr>\n";
-            std::cout << "  <td>" << mg->getMuscleGroupId() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(mg->getName()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(mg->getDescription().substr(0, 50)) << "</td>\n";
-            std::cout << "  <td>" << mg->getDaysPerWeek() << "</td>\n";
-            std::cout << "  <td>" << mg->getSets() << "</td>\n";
-            std::cout << "  <td>" << mg->getReps() << "</td>\n";
-            std::cout << "  <td>" << mg->getWeightAmount() << "</td>\n";
+            std::cout << "  <td>" << mg.getMuscleGroupId() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(mg.getName()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(mg.getDescription().substr(0, 50)) << "</td>\n";
+            std::cout << "  <td>" << mg.getDaysPerWeek() << "</td>\n";
+            std::cout << "  <td>" << mg.getSets() << "</td>\n";
+            std::cout << "  <td>" << mg.getReps() << "</td>\n";
+            std::cout << "  <td>" << mg.getWeightAmount() << "</td>\n";
             std::cout << "  <td>\n";
-            std::cout << "    <a href=\"workout.cgi?action=view&table=musclegroup&id=" << mg->getMuscleGroupId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=update_form&table=musclegroup&id=" << mg->getMuscleGroupId() << "\" class=\"btn btn-sm\">✏️ Edit</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=delete&table=musclegroup&id=" << mg->getMuscleGroupId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete this muscle group?')\">🗑️ Delete</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=view&table=musclegroup&id=" << mg.getMuscleGroupId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=update_form&table=musclegroup&id=" << mg.getMuscleGroupId() << "\" class=\"btn btn-sm\">✏️ Edit</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=delete&table=musclegroup&id=" << mg.getMuscleGroupId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete this muscle group?')\">🗑️ Delete</a>\n";
             std::cout << "  </td>\n";
             std::cout << "</tr>\n";
-            delete mg;
         }
         
         std::cout << "</table>\n";
@@ -639,14 +704,14 @@ void showMuscleGroupInsertForm() {
     printHTMLFooter();
 }
 
-void handleMuscleGroupInsert(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void handleMuscleGroupInsert(WorkoutService& service, const CgiParams& params) {
     ServiceResponse response = service.insertMuscleGroup(
-        params.at("name"),
-        params.count("description") ? params.at("description") : "",
-        std::stoi(params.at("days_per_week")),
-        std::stoi(params.at("sets")),
-        std::stoi(params.at("reps")),
-        std::stod(params.at("weight"))
+        params.text("name"),
+        params.text("description", ""),
+        params.integer(NumericField::DAYS_PER_WEEK),
+        params.integer(NumericField::SETS),
+        params.integer(NumericField::REPS),
+        params.number(NumericField::WEIGHT)
     );
     
     printHTMLHeader("Muscle Group Created");
@@ -727,17 +792,17 @@ void showMuscleGroupUpdateForm(WorkoutService& service, int id) {
     printHTMLFooter();
 }
 
-void handleMuscleGroupUpdate(WorkoutService& service, const std::map<std::string, std::string>& params) {
-    int id = std::stoi(params.at("id"));
+void handleMuscleGroupUpdate(WorkoutService& service, const CgiParams& params) {
+    int id = params.id();
     
     ServiceResponse response = service.updateMuscleGroup(
         id,
-        params.at("name"),
-        params.count("description") ? params.at("description") : "",
-        std::stoi(params.at("days_per_week")),
-        std::stoi(params.at("sets")),
-        std::stoi(params.at("reps")),
-        std::stod(params.at("weight"))
+        params.text("name"),
+        params.text("description", ""),
+        params.integer(NumericField::DAYS_PER_WEEK),
+        params.integer(NumericField::SETS),
+        params.integer(NumericField::REPS),
+        params.number(NumericField::WEIGHT)
     );
     
     printHTMLHeader("Muscle Group Updated");
@@ -772,7 +837,7 @@ void handleMuscleGroupDelete(WorkoutService& service, int id) {
 
 // ==================== NUTRITION HANDLERS ====================
 
-void listNutrition(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void listNutrition(WorkoutService& service, const CgiParams& params) {
     printHTMLHeader("Nutrition - List All");
     
     std::cout << "<div class=\"action-bar\">\n";
@@ -780,7 +845,7 @@ void listNutrition(WorkoutService& service, const std::map<std::string, std::str
     std::cout << "  <a href=\"workout.cgi?action=insert_form&table=nutrition\" class=\"btn btn-success\">➕ Add New Entry</a>\n";
     std::cout << "</div>\n";
     
-    std::vector<Nutrition*> entries = service.getAllNutrition();
+    ResultSet<Nutrition> entries = service.getAllNutrition();
     
     std::cout << "<p>Total entries: <strong>" << entries.size() << "</strong></p>\n";
     
@@ -793,23 +858,22 @@ void listNutrition(WorkoutService& service, const std::map<std::string, std::str
         std::cout << "  <th>Carbs (g)</th><th>Fat (g)</th><th>Protein (g)</th><th>Sugar (g)</th><th>Actions</th>\n";
         std::cout << "</tr>\n";
         
-        for (Nutrition* n : entries) {
+        for (const Nutrition& n : entries) {
             std::cout << "<tr>\n";
-            std::cout << "  <td>" << n->getNutritionId() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(n->getMealDate()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(n->getFamilyString()) << "</td>\n";
-            std::cout << "  <td>" << n->getWater() << "</td>\n";
-            std::cout << "  <td>" << n->getCarbs() << "</td>\n";
-            std::cout << "  <td>" << n->getFat() << "</td>\n";
-            std::cout << "  <td>" << n->getProtein() << "</td>\n";
-            std::cout << "  <td>" << n->getSugar() << "</td>\n";
+            std::cout << "  <td>" << n.getNutritionId() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(n.getMealDate()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(n.getFamilyString()) << "</td>\n";
+            std::cout << "  <td>" << n.getWater() << "</td>\n";
+            std::cout << "  <td>" << n.getCarbs() << "</td>\n";
+            std::cout << "  <td>" << n.getFat() << "</td>\n";
+            std::cout << "  <td>" << n.getProtein() << "</td>\n";
+            std::cout << "  <td>" << n.getSugar() << "</td>\n";
             std::cout << "  <td>\n";
-            std::cout << "    <a href=\"workout.cgi?action=view&table=nutrition&id=" << n->getNutritionId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=update_form&table=nutrition&id=" << n->getNutritionId() << "\" class=\"btn btn-sm\">✏️ Edit</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=delete&table=nutrition&id=" << n->getNutritionId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=view&table=nutrition&id=" << n.getNutritionId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=update_form&table=nutrition&id=" << n.getNutritionId() << "\" class=\"btn btn-sm\">✏️ Edit</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=delete&table=nutrition&id=" << n.getNutritionId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
             std::cout << "  </td>\n";
             std::cout << "</tr>\n";
-            delete n;
         }
         
         std::cout << "</table>\n";
@@ -878,15 +942,15 @@ void showNutritionInsertForm() {
     printHTMLFooter();
 }
 
-void handleNutritionInsert(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void handleNutritionInsert(WorkoutService& service, const CgiParams& params) {
     ServiceResponse response = service.insertNutrition(
-        params.at("family"),
-        std::stod(params.at("water")),
-        std::stod(params.at("carbs")),
-        std::stod(params.at("fat")),
-        std::stod(params.at("protein")),
-        std::stod(params.at("sugar")),
-        params.at("date")
+        params.text("family"),
+        params.number(NumericField::WATER),
+        params.number(NumericField::CARBS),
+        params.number(NumericField::FAT),
+        params.number(NumericField::PROTEIN),
+        params.number(NumericField::SUGAR),
+        params.text("date")
     );
     
     printHTMLHeader("Nutrition Entry Created");
@@ -921,7 +985,7 @@ void handleNutritionDelete(WorkoutService& service, int id) {
 
 // ==================== RECOVERY HANDLERS ====================
 
-void listRecovery(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void listRecovery(WorkoutService& service, const CgiParams& params) {
     printHTMLHeader("Recovery - List All");
     
     std::cout << "<div class=\"action-bar\">\n";
@@ -929,7 +993,7 @@ void listRecovery(WorkoutService& service, const std::map<std::string, std::stri
     std::cout << "  <a href=\"workout.cgi?action=insert_form&table=recovery\" class=\"btn btn-success\">➕ Add New Session</a>\n";
     std::cout << "</div>\n";
     
-    std::vector<Recovery*> sessions = service.getAllRecovery();
+    ResultSet<Recovery> sessions = service.getAllRecovery();
     
     std::cout << "<p>Total sessions: <strong>" << sessions.size() << "</strong></p>\n";
     
@@ -939,19 +1003,18 @@ void listRecovery(WorkoutService& service, const std::map<std::string, std::stri
         std::cout << "<table>\n";
         std::cout << "<tr><th>ID</th><th>Date</th><th>Duration (min)</th><th>Type</th><th>Helpers</th><th>Actions</th></tr>\n";
         
-        for (Recovery* r : sessions) {
+        for (const Recovery& r : sessions) {
             std::cout << "<tr>\n";
-            std::cout << "  <td>" << r->getRecoveryId() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(r->getRecoveryDate()) << "</td>\n";
-            std::cout << "  <td>" << r->getDuration() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(r->getType()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(r->getHelpers().substr(0, 30)) << "</td>\n";
+            std::cout << "  <td>" << r.getRecoveryId() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(r.getRecoveryDate()) << "</td>\n";
+            std::cout << "  <td>" << r.getDuration() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(r.getType()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(r.getHelpers().substr(0, 30)) << "</td>\n";
             std::cout << "  <td>\n";
-            std::cout << "    <a href=\"workout.cgi?action=view&table=recovery&id=" << r->getRecoveryId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=delete&table=recovery&id=" << r->getRecoveryId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=view&table=recovery&id=" << r.getRecoveryId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=delete&table=recovery&id=" << r.getRecoveryId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
             std::cout << "  </td>\n";
             std::cout << "</tr>\n";
-            delete r;
         }
         
         std::cout << "</table>\n";
@@ -997,12 +1060,12 @@ void showRecoveryInsertForm() {
     printHTMLFooter();
 }
 
-void handleRecoveryInsert(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void handleRecoveryInsert(WorkoutService& service, const CgiParams& params) {
     ServiceResponse response = service.insertRecovery(
-        params.at("date"),
-        std::stoi(params.at("duration")),
-        params.at("type"),
-        params.count("helpers") ? params.at("helpers") : ""
+        params.text("date"),
+        params.integer(NumericField::DURATION),
+        params.text("type"),
+        params.text("helpers", "")
     );
     
     printHTMLHeader("Recovery Session Created");
@@ -1037,7 +1100,7 @@ void handleRecoveryDelete(WorkoutService& service, int id) {
 
 // ==================== EQUIPMENT HANDLERS ====================
 
-void listEquipment(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void listEquipment(WorkoutService& service, const CgiParams& params) {
     printHTMLHeader("Equipment - List All");
     
     std::cout << "<div class=\"action-bar\">\n";
@@ -1045,7 +1108,7 @@ void listEquipment(WorkoutService& service, const std::map<std::string, std::str
     std::cout << "  <a href=\"workout.cgi?action=insert_form&table=equipment\" class=\"btn btn-success\">➕ Add New Equipment</a>\n";
     std::cout << "</div>\n";
     
-    std::vector<Equipment*> items = service.getAllEquipment();
+    ResultSet<Equipment> items = service.getAllEquipment();
     
     std::cout << "<p>Total equipment: <strong>" << items.size() << "</strong></p>\n";
     
@@ -1055,19 +1118,18 @@ void listEquipment(WorkoutService& service, const std::map<std::string, std::str
         std::cout << "<table>\n";
         std::cout << "<tr><th>ID</th><th>Name</th><th>Description</th><th>Category</th><th>Target</th><th>Actions</th></tr>\n";
         
-        for (Equipment* e : items) {
+        for (const Equipment& e : items) {
             std::cout << "<tr>\n";
-            std::cout << "  <td>" << e->getEquipmentId() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(e->getName()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(e->getDescription().substr(0, 50)) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(e->getCategory()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(e->getTarget()) << "</td>\n";
+            std::cout << "  <td>" << e.getEquipmentId() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(e.getName()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(e.getDescription().substr(0, 50)) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(e.getCategory()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(e.getTarget()) << "</td>\n";
             std::cout << "  <td>\n";
-            std::cout << "    <a href=\"workout.cgi?action=view&table=equipment&id=" << e->getEquipmentId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
-            std::cout << "    <a href=\"workout.cgi?action=delete&table=equipment&id=" << e->getEquipmentId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=view&table=equipment&id=" << e.getEquipmentId() << "\" class=\"btn btn-info btn-sm\">👁️ View</a>\n";
+            std::cout << "    <a href=\"workout.cgi?action=delete&table=equipment&id=" << e.getEquipmentId() << "\" class=\"btn btn-danger btn-sm\" onclick=\"return confirm('Delete?')\">🗑️ Delete</a>\n";
             std::cout << "  </td>\n";
             std::cout << "</tr>\n";
-            delete e;
         }
         
         std::cout << "</table>\n";
@@ -1113,12 +1175,12 @@ void showEquipmentInsertForm() {
     printHTMLFooter();
 }
 
-void handleEquipmentInsert(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void handleEquipmentInsert(WorkoutService& service, const CgiParams& params) {
     ServiceResponse response = service.insertEquipment(
-        params.at("name"),
-        params.count("description") ? params.at("description") : "",
-        params.at("category"),
-        params.count("target") ? params.at("target") : ""
+        params.text("name"),
+        params.text("description", ""),
+        params.text("category"),
+        params.text("target", "")
     );
     
     printHTMLHeader("Equipment Created");
@@ -1152,195 +1214,395 @@ void handleEquipmentDelete(WorkoutService& service, int id) {
 }
 
 
+// ==================== DATABASE ACCESS ====================
+
+// What the current request spent on the database, sent back in a
+// Server-Timing header (visible in the browser's network panel)
+struct RequestTiming {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool databaseOpened = false;
+    double connectMs = 0.0;           // building the DAO and connecting
+    unsigned long long queries = 0;   // statements the handler sent
+    const char* cache = nullptr;      // "hit" or "miss" when the page was cacheable
+};
+
+RequestTiming requestTiming;
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+long long epochMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Read-your-writes deadline from the browser's workout_rw cookie
+long long cookieReadsUntil() {
+    return ReadYourWritesCookie::parse(getEnv("HTTP_COOKIE"), epochMillis(),
+                                       ConnectionPolicy::fromEnvironment().stickyMs);
+}
+
+// Build the DAO and check that it can reach its storage.
+// Returns nullptr when the database is unreachable.
+std::unique_ptr<WorkoutDAO> openDatabase() {
+    auto start = std::chrono::steady_clock::now();
+    
+    // Primary from WORKOUT_DB_HOST/WORKOUT_DB_PORT (Apache SetEnv), replicas
+    // from WORKOUT_DB_REPLICAS; a recent write keeps reads on the primary.
+    // WORKOUT_STORAGE=local uses the embedded store instead; concurrent
+    // requests then wait their turn for the store's file lock.
+    std::string dbHost = getEnv("WORKOUT_DB_HOST");
+    std::string dbPort = getEnv("WORKOUT_DB_PORT");
+    WorkoutDAO::setPrimaryReadsUntil(cookieReadsUntil());
+    std::unique_ptr<WorkoutDAO> dao = createWorkoutDAO(dbHost.empty() ? "localhost" : dbHost,
+                                                       "workout_user", "workout_pass", "workout_tracker",
+                                                       dbPort.empty() ? 3306 : std::atoi(dbPort.c_str()));
+    
+    // testConnection reports success on stdout, which is the page here
+    std::ostringstream discard;
+    std::streambuf* pageBuffer = std::cout.rdbuf(discard.rdbuf());
+    bool connected = dao->testConnection();
+    std::cout.rdbuf(pageBuffer);
+    
+    requestTiming.databaseOpened = true;
+    requestTiming.connectMs = millisecondsSince(start);
+    if (!connected) {
+        std::cerr << "[CGI] Database connection failed after " << requestTiming.connectMs << " ms" << std::endl;
+        return nullptr;
+    }
+    return dao;
+}
+
+// Server-Timing: cache;desc="miss", db-connect;dur=2.41, db-queries;desc="3", total;dur=4.97
+std::string serverTimingHeader() {
+    std::ostringstream header;
+    header << std::fixed << std::setprecision(2);
+    if (requestTiming.cache) {
+        header << "cache;desc=\"" << requestTiming.cache << "\", ";
+    }
+    if (requestTiming.databaseOpened) {
+        header << "db-connect;dur=" << requestTiming.connectMs
+               << ", db-queries;desc=\"" << requestTiming.queries << "\", ";
+    }
+    header << "total;dur=" << millisecondsSince(requestTiming.start);
+    return header.str();
+}
+
+// ==================== RESPONSE OUTPUT ====================
+
+// Write the buffered page to stdout with CGI headers, compressed when the
+// browser sent a usable Accept-Encoding and the page is large enough
+void sendResponse(const std::string& body) {
+    CompressionConfig config = CompressionConfig::fromEnvironment();
+    ContentEncoding encoding = CompressionHelper::negotiate(getEnv("HTTP_ACCEPT_ENCODING"));
+    
+    std::string compressed;
+    bool useCompressed = CompressionHelper::shouldCompress(config, body.size(), "text/html") &&
+                         CompressionHelper::compress(body, encoding, config.level, compressed);
+    
+    std::cout << "Content-Type: text/html\r\n";
+    std::cout << "Vary: Accept-Encoding\r\n";
+    std::cout << "Server-Timing: " << serverTimingHeader() << "\r\n";
+    
+    // Keep the next pages on the primary after a write (read-your-writes)
+    long long primaryReadsUntil = WorkoutDAO::getPrimaryReadsUntil();
+    if (!getEnv("WORKOUT_DB_REPLICAS").empty() &&
+        primaryReadsUntil > cookieReadsUntil()) {
+        std::cout << "Set-Cookie: " << ReadYourWritesCookie::format(primaryReadsUntil, epochMillis()) << "\r\n";
+    }
+    if (useCompressed) {
+        std::cout << "Content-Encoding: " << CompressionHelper::encodingName(encoding) << "\r\n";
+    }
+    std::cout << "\r\n";
+    
+    const std::string& payload = useCompressed ? compressed : body;
+    std::cout.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    std::cout.flush();
+}
+
+// ==================== ROUTE TABLE ====================
+
+// Pages that exist only as placeholders so far
+void showNotImplemented(const std::string& operation, const std::string& entity, const std::string& table) {
+    printHTMLHeader(operation + " " + entity);
+    std::cout << "<h1>" << operation << " not yet implemented for " << entity << "</h1>\n";
+    std::cout << "<a href=\"workout.cgi?action=list&table=" << table << "\" class=\"btn\">Back to List</a>\n";
+    printHTMLFooter();
+}
+
+// Tables the CGI knows, for the "unknown action" page
+struct TableInfo {
+    const char* table;
+    const char* entity;
+    const char* plural;
+};
+
+constexpr TableInfo cgiTables[] = {
+    {"workout", "Workout", "Workouts"},
+    {"musclegroup", "MuscleGroup", "Muscle Groups"},
+    {"nutrition", "Nutrition", "Nutrition"},
+    {"recovery", "Recovery", "Recovery"},
+    {"equipment", "Equipment", "Equipment"}
+};
+
+const TableInfo* findTable(const std::string& table) {
+    for (const TableInfo& info : cgiTables) {
+        if (table == info.table) return &info;
+    }
+    return nullptr;
+}
+
+typedef void (*RouteHandler)(WorkoutService& service, const CgiParams& params);
+
+// Tables a route reads or writes, as bits for the shared page cache: a page
+// is cached until one of the tables it reads is written
+enum TableBits : uint32_t {
+    NO_TABLES = 0,
+    WORKOUT_TABLE = 1u << static_cast<int>(TableId::WORKOUT),
+    MUSCLE_GROUP_TABLE = 1u << static_cast<int>(TableId::MUSCLE_GROUP),
+    NUTRITION_TABLE = 1u << static_cast<int>(TableId::NUTRITION),
+    RECOVERY_TABLE = 1u << static_cast<int>(TableId::RECOVERY),
+    EQUIPMENT_TABLE = 1u << static_cast<int>(TableId::EQUIPMENT),
+    ALL_TABLES = WORKOUT_TABLE | MUSCLE_GROUP_TABLE | NUTRITION_TABLE | RECOVERY_TABLE | EQUIPMENT_TABLE
+};
+
+// One page: table x action, its handler, and whether it needs the database
+// (insert forms and placeholders do not, so no connection is opened for them).
+// reads != 0 makes a GET of the page cacheable; writes lists the tables whose
+// cached pages a successful call makes stale (deleting a muscle group also
+// clears it from workouts).
+struct Route {
+    std::string_view table;
+    std::string_view action;
+    RouteHandler handler;
+    bool needsDatabase;
+    uint32_t reads;
+    uint32_t writes;
+};
+
+constexpr Route routes[] = {
+    {"", "", [](WorkoutService& s, const CgiParams&) { showHomePage(s); }, true, ALL_TABLES, NO_TABLES},
+    
+    {"workout", "list", showWorkoutList, true, WORKOUT_TABLE, NO_TABLES},
+    {"workout", "view", [](WorkoutService& s, const CgiParams& p) { viewWorkout(s, p.id()); }, true, WORKOUT_TABLE, NO_TABLES},
+    {"workout", "insert_form", [](WorkoutService&, const CgiParams&) { showWorkoutInsertForm(); }, false, NO_TABLES, NO_TABLES},
+    {"workout", "insert", handleWorkoutInsert, true, NO_TABLES, WORKOUT_TABLE},
+    {"workout", "update_form", [](WorkoutService& s, const CgiParams& p) { showWorkoutUpdateForm(s, p.id()); }, true, WORKOUT_TABLE, NO_TABLES},
+    {"workout", "update", handleWorkoutUpdate, true, NO_TABLES, WORKOUT_TABLE},
+    {"workout", "delete", [](WorkoutService& s, const CgiParams& p) { handleWorkoutDelete(s, p.id()); }, true, NO_TABLES, WORKOUT_TABLE},
+    
+    {"musclegroup", "list", listMuscleGroups, true, MUSCLE_GROUP_TABLE, NO_TABLES},
+    {"musclegroup", "view", [](WorkoutService& s, const CgiParams& p) { viewMuscleGroup(s, p.id()); }, true, MUSCLE_GROUP_TABLE, NO_TABLES},
+    {"musclegroup", "insert_form", [](WorkoutService&, const CgiParams&) { showMuscleGroupInsertForm(); }, false, NO_TABLES, NO_TABLES},
+    {"musclegroup", "insert", handleMuscleGroupInsert, true, NO_TABLES, MUSCLE_GROUP_TABLE | WORKOUT_TABLE},
+    {"musclegroup", "update_form", [](WorkoutService& s, const CgiParams& p) { showMuscleGroupUpdateForm(s, p.id()); }, true, MUSCLE_GROUP_TABLE, NO_TABLES},
+    {"musclegroup", "update", handleMuscleGroupUpdate, true, NO_TABLES, MUSCLE_GROUP_TABLE | WORKOUT_TABLE},
+    {"musclegroup", "delete", [](WorkoutService& s, const CgiParams& p) { handleMuscleGroupDelete(s, p.id()); }, true, NO_TABLES, MUSCLE_GROUP_TABLE | WORKOUT_TABLE},
+    
+    {"nutrition", "list", listNutrition, true, NUTRITION_TABLE, NO_TABLES},
+    {"nutrition", "view", [](WorkoutService&, const CgiParams&) { showNotImplemented("View", "Nutrition", "nutrition"); }, false, NO_TABLES, NO_TABLES},
+    {"nutrition", "insert_form", [](WorkoutService&, const CgiParams&) { showNutritionInsertForm(); }, false, NO_TABLES, NO_TABLES},
+    {"nutrition", "insert", handleNutritionInsert, true, NO_TABLES, NUTRITION_TABLE},
+    {"nutrition", "update_form", [](WorkoutService&, const CgiParams&) { showNotImplemented("Update", "Nutrition", "nutrition"); }, false, NO_TABLES, NO_TABLES},
+    {"nutrition", "delete", [](WorkoutService& s, const CgiParams& p) { handleNutritionDelete(s, p.id()); }, true, NO_TABLES, NUTRITION_TABLE},
+    
+    {"recovery", "list", listRecovery, true, RECOVERY_TABLE, NO_TABLES},
+    {"recovery", "view", [](WorkoutService&, const CgiParams&) { showNotImplemented("View", "Recovery", "recovery"); }, false, NO_TABLES, NO_TABLES},
+    {"recovery", "insert_form", [](WorkoutService&, const CgiParams&) { showRecoveryInsertForm(); }, false, NO_TABLES, NO_TABLES},
+    {"recovery", "insert", handleRecoveryInsert, true, NO_TABLES, RECOVERY_TABLE},
+    {"recovery", "update_form", [](WorkoutService&, const CgiParams&) { showNotImplemented("Update", "Recovery", "recovery"); }, false, NO_TABLES, NO_TABLES},
+    {"recovery", "delete", [](WorkoutService& s, const CgiParams& p) { handleRecoveryDelete(s, p.id()); }, true, NO_TABLES, RECOVERY_TABLE},
+    
+    {"equipment", "list", listEquipment, true, EQUIPMENT_TABLE, NO_TABLES},
+    {"equipment", "view", [](WorkoutService&, const CgiParams&) { showNotImplemented("View", "Equipment", "equipment"); }, false, NO_TABLES, NO_TABLES},
+    {"equipment", "insert_form", [](WorkoutService&, const CgiParams&) { showEquipmentInsertForm(); }, false, NO_TABLES, NO_TABLES},
+    {"equipment", "insert", handleEquipmentInsert, true, NO_TABLES, EQUIPMENT_TABLE},
+    {"equipment", "update_form", [](WorkoutService&, const CgiParams&) { showNotImplemented("Update", "Equipment", "equipment"); }, false, NO_TABLES, NO_TABLES},
+    {"equipment", "delete", [](WorkoutService& s, const CgiParams& p) { handleEquipmentDelete(s, p.id()); }, true, NO_TABLES, EQUIPMENT_TABLE}
+};
+
+constexpr size_t ROUTE_COUNT = sizeof(routes) / sizeof(routes[0]);
+constexpr size_t ROUTE_SLOTS = 256;
+constexpr uint8_t NO_ROUTE = 0xFF;
+static_assert(ROUTE_COUNT < ROUTE_SLOTS, "route table is full; raise ROUTE_SLOTS");
+
+// FNV-1a over "table/action", perturbed by a seed
+constexpr uint32_t routeHash(std::string_view table, std::string_view action, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : table) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    hash = (hash ^ '/') * 16777619u;
+    for (char c : action) hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    return hash;
+}
+
+// The first seed that gives every route its own slot. Found by the compiler;
+// a duplicate route can never get its own slot, so it fails the build too.
+constexpr uint32_t findRouteSeed() {
+    for (uint32_t seed = 0; seed < 1000; ++seed) {
+        bool used[ROUTE_SLOTS] = {};
+        bool collision = false;
+        for (size_t i = 0; i < ROUTE_COUNT && !collision; ++i) {
+            size_t slot = routeHash(routes[i].table, routes[i].action, seed) % ROUTE_SLOTS;
+            collision = used[slot];
+            used[slot] = true;
+        }
+        if (!collision) return seed;
+    }
+    return UINT32_MAX;
+}
+
+constexpr uint32_t ROUTE_SEED = findRouteSeed();
+static_assert(ROUTE_SEED != UINT32_MAX, "no collision-free seed for the route table; raise ROUTE_SLOTS");
+
+struct RouteSlots {
+    uint8_t index[ROUTE_SLOTS];
+};
+
+constexpr RouteSlots buildRouteSlots() {
+    RouteSlots slots{};
+    for (size_t slot = 0; slot < ROUTE_SLOTS; ++slot) slots.index[slot] = NO_ROUTE;
+    for (size_t i = 0; i < ROUTE_COUNT; ++i) {
+        slots.index[routeHash(routes[i].table, routes[i].action, ROUTE_SEED) % ROUTE_SLOTS] = static_cast<uint8_t>(i);
+    }
+    return slots;
+}
+
+constexpr RouteSlots routeSlots = buildRouteSlots();
+
+// One hash and one comparison, however many routes there are
+const Route* findRoute(std::string_view table, std::string_view action) {
+    uint8_t index = routeSlots.index[routeHash(table, action, ROUTE_SEED) % ROUTE_SLOTS];
+    if (index == NO_ROUTE) return nullptr;
+    const Route& route = routes[index];
+    return route.table == table && route.action == action ? &route : nullptr;
+}
+
 // ==================== MAIN CGI HANDLER ====================
 
+int handleRequest();
+
 int main() {
-    std::cout << "Content-Type: text/html\r\n\r\n";
-    std::cout.flush();
+    // Buffer the whole page so headers can be decided after rendering
+    std::ostringstream page;
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(page.rdbuf());
+    
+    int status = handleRequest();
+    
+    std::cout.rdbuf(stdoutBuffer);
+    sendResponse(page.str());
+    return status;
+}
+
+// Sends cout to a private buffer until destroyed, so one handler's page
+// can be kept for the shared cache
+class PageCapture {
+    std::ostringstream captured;
+    std::streambuf* previous;
+    
+public:
+    PageCapture() : previous(std::cout.rdbuf(captured.rdbuf())) {}
+    ~PageCapture() {
+        std::cout.rdbuf(previous);
+    }
+    PageCapture(const PageCapture&) = delete;
+    PageCapture& operator=(const PageCapture&) = delete;
+    
+    std::string text() const {
+        return captured.str();
+    }
+};
+
+int handleRequest() {
+    std::unique_ptr<WorkoutDAO> dao;
+    SharedCacheConfig cacheConfig = SharedCacheConfig::fromEnvironment();
+    SharedCache cache;
+    
     try {
         // Get request method and query string
         std::string requestMethod = getEnv("REQUEST_METHOD");
         std::string queryString = getEnv("QUERY_STRING");
         
-        // Parse parameters
-        std::map<std::string, std::string> params;
+        // Parse parameters (numbers are converted once, here)
+        std::string postData;
         
-        if (requestMethod == "GET") {
-            params = parseQueryString(queryString);
-        } else if (requestMethod == "POST") {
+        if (requestMethod == "POST") {
             std::string contentLength = getEnv("CONTENT_LENGTH");
             if (!contentLength.empty()) {
                 int length = std::stoi(contentLength);
-                std::string postData;
                 postData.resize(length);
                 std::cin.read(&postData[0], length);
-                params = parseQueryString(postData);
             }
         }
+        CgiParams params(requestMethod == "POST" ? std::string_view(postData) :
+                         requestMethod == "GET" ? std::string_view(queryString) : std::string_view());
         
-        // Initialize service layer
-        WorkoutDAO dao("localhost", "workout_user", "workout_pass", "workout_tracker");
-        WorkoutManager manager(&dao);
-        WorkoutService service(&manager);
-        
-        // Test connection
-        if (!service.testConnection()) {
-            printHTMLHeader("Database Error");
-            std::cout << "<h1>Database Connection Error</h1>\n";
-            std::cout << "<p>Could not connect to the database.</p>\n";
-            printHTMLFooter();
-            return 1;
-        }
-        
-        // Route based on action and table parameters
-        std::string action = params["action"];
-        std::string table = params["table"];
+        // Route based on action and table parameters; no action is the home page
+        std::string action = params.text("action", "");
+        std::string table = action.empty() ? "" : params.text("table", "");
+        const Route* route = findRoute(table, action);
         
-        // ==================== HOME PAGE ====================
-        if (action.empty()) {
-            showHomePage(service);
+        // Pages that only read are shared between CGI processes; a hit
+        // needs no database connection at all
+        bool cacheable = cacheConfig.enabled && route && route->reads != NO_TABLES && requestMethod == "GET";
+        if ((cacheable || (cacheConfig.enabled && route && route->writes != NO_TABLES)) &&
+            !cache.open(cacheConfig)) {
+            std::cerr << "[CGI] Shared cache " << cacheConfig.name << " unavailable" << std::endl;
+            cacheable = false;
         }
-        
-        // ==================== WORKOUT ROUTING ====================
-        else if (table == "workout") {
-            if (action == "list") {
-                showWorkoutList(service, params);
-            } else if (action == "view") {
-                viewWorkout(service, std::stoi(params["id"]));
-            } else if (action == "insert_form") {
-                showWorkoutInsertForm();
-            } else if (action == "insert") {
-                handleWorkoutInsert(service, params);
-            } else if (action == "update_form") {
-                showWorkoutUpdateForm(service, std::stoi(params["id"]));
-            } else if (action == "update") {
-                handleWorkoutUpdate(service, params);
-            } else if (action == "delete") {
-                handleWorkoutDelete(service, std::stoi(params["id"]));
-            } else {
-                printHTMLHeader("Unknown Action");
-                std::cout << "<h1>Unknown Action</h1>\n";
-                std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for Workout.</p>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=workout\" class=\"btn\">Back to Workouts</a>\n";
-                printHTMLFooter();
-            }
+        std::string cachedPage;
+        if (cacheable && cache.lookup(queryString, cachedPage)) {
+            requestTiming.cache = "hit";
+            std::cout << cachedPage;
+            return 0;
         }
         
-        // ==================== MUSCLEGROUP ROUTING ====================
-        else if (table == "musclegroup") {
-            if (action == "list") {
-                listMuscleGroups(service, params);
-            } else if (action == "view") {
-                viewMuscleGroup(service, std::stoi(params["id"]));
-            } else if (action == "insert_form") {
-                showMuscleGroupInsertForm();
-            } else if (action == "insert") {
-                handleMuscleGroupInsert(service, params);
-            } else if (action == "update_form") {
-                showMuscleGroupUpdateForm(service, std::stoi(params["id"]));
-            } else if (action == "update") {
-                handleMuscleGroupUpdate(service, params);
-            } else if (action == "delete") {
-                handleMuscleGroupDelete(service, std::stoi(params["id"]));
-            } else {
-                printHTMLHeader("Unknown Action");
-                std::cout << "<h1>Unknown Action</h1>\n";
-                std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for MuscleGroup.</p>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=musclegroup\" class=\"btn\">Back to Muscle Groups</a>\n";
+        // Connect only for routes that read or write data; form pages
+        // render without touching the database
+        if (route && route->needsDatabase) {
+            dao = openDatabase();
+            if (!dao) {
+                printHTMLHeader("Database Error");
+                std::cout << "<h1>Database Connection Error</h1>\n";
+                std::cout << "<p>Could not connect to the database.</p>\n";
                 printHTMLFooter();
+                return 1;
             }
         }
         
-        // ==================== NUTRITION ROUTING ====================
-        else if (table == "nutrition") {
-            if (action == "list") {
-                listNutrition(service, params);
-            } else if (action == "view") {
-                // View not implemented yet, redirect to list
-                printHTMLHeader("View Nutrition");
-                std::cout << "<h1>View not yet implemented for Nutrition</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=nutrition\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "insert_form") {
-                showNutritionInsertForm();
-            } else if (action == "insert") {
-                handleNutritionInsert(service, params);
-            } else if (action == "update_form") {
-                printHTMLHeader("Update Nutrition");
-                std::cout << "<h1>Update not yet implemented for Nutrition</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=nutrition\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "delete") {
-                handleNutritionDelete(service, std::stoi(params["id"]));
-            } else {
-                printHTMLHeader("Unknown Action");
-                std::cout << "<h1>Unknown Action</h1>\n";
-                std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for Nutrition.</p>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=nutrition\" class=\"btn\">Back to Nutrition</a>\n";
-                printHTMLFooter();
-            }
-        }
+        // Without a DAO only the static pages are reachable
+        WorkoutManager manager(dao.get());
+        WorkoutService service(&manager);
         
-        // ==================== RECOVERY ROUTING ====================
-        else if (table == "recovery") {
-            if (action == "list") {
-                listRecovery(service, params);
-            } else if (action == "view") {
-                printHTMLHeader("View Recovery");
-                std::cout << "<h1>View not yet implemented for Recovery</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=recovery\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "insert_form") {
-                showRecoveryInsertForm();
-            } else if (action == "insert") {
-                handleRecoveryInsert(service, params);
-            } else if (action == "update_form") {
-                printHTMLHeader("Update Recovery");
-                std::cout << "<h1>Update not yet implemented for Recovery</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=recovery\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "delete") {
-                handleRecoveryDelete(service, std::stoi(params["id"]));
-            } else {
-                printHTMLHeader("Unknown Action");
-                std::cout << "<h1>Unknown Action</h1>\n";
-                std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for Recovery.</p>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=recovery\" class=\"btn\">Back to Recovery</a>\n";
-                printHTMLFooter();
+        if (cacheable) {
+            // Versions are taken before reading, so a write that lands while
+            // this page renders leaves the stored copy already stale. A page
+            // whose reads failed shows an empty list rather than an error,
+            // so it is sent but not stored.
+            requestTiming.cache = "miss";
+            SharedCache::Stamp stamp = cache.stamp();
+            unsigned long long failures = WorkoutDAO::getFailureCount();
+            std::string rendered;
+            {
+                PageCapture capture;
+                route->handler(service, params);
+                rendered = capture.text();
             }
-        }
-        
-        // ==================== EQUIPMENT ROUTING ====================
-        else if (table == "equipment") {
-            if (action == "list") {
-                listEquipment(service, params);
-            } else if (action == "view") {
-                printHTMLHeader("View Equipment");
-                std::cout << "<h1>View not yet implemented for Equipment</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=equipment\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "insert_form") {
-                showEquipmentInsertForm();
-            } else if (action == "insert") {
-                handleEquipmentInsert(service, params);
-            } else if (action == "update_form") {
-                printHTMLHeader("Update Equipment");
-                std::cout << "<h1>Update not yet implemented for Equipment</h1>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=equipment\" class=\"btn\">Back to List</a>\n";
-                printHTMLFooter();
-            } else if (action == "delete") {
-                handleEquipmentDelete(service, std::stoi(params["id"]));
-            } else {
-                printHTMLHeader("Unknown Action");
-                std::cout << "<h1>Unknown Action</h1>\n";
-                std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for Equipment.</p>\n";
-                std::cout << "<a href=\"workout.cgi?action=list&table=equipment\" class=\"btn\">Back to Equipment</a>\n";
-                printHTMLFooter();
+            std::cout << rendered;
+            if (WorkoutDAO::getFailureCount() == failures) {
+                cache.store(queryString, route->reads, stamp, rendered);
             }
-        }
-        
-        // ==================== UNKNOWN TABLE ====================
-        else {
+        } else if (route) {
+            route->handler(service, params);
+            if (route->writes != NO_TABLES) cache.invalidate(route->writes);
+        } else if (const TableInfo* info = findTable(table)) {
+            printHTMLHeader("Unknown Action");
+            std::cout << "<h1>Unknown Action</h1>\n";
+            std::cout << "<p>Action '" << htmlEscape(action) << "' not recognized for " << info->entity << ".</p>\n";
+            std::cout << "<a href=\"workout.cgi?action=list&table=" << info->table
+                      << "\" class=\"btn\">Back to " << info->plural << "</a>\n";
+            printHTMLFooter();
+        } else {
             printHTMLHeader("Error");
             std::cout << "<h1>Unknown Table</h1>\n";
             std::cout << "<p>Table '" << htmlEscape(table) << "' is not recognized.</p>\n";
@@ -1356,12 +1618,15 @@ int main() {
         printHTMLFooter();
     }
     
+    if (dao) {
+        requestTiming.queries = dao->getConnectionStats().queries;
+    }
     return 0;
 }
 
 // ==================== WORKOUT LIST HANDLER ====================
 
-void showWorkoutList(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void showWorkoutList(WorkoutService& service, const CgiParams& params) {
     printHTMLHeader("Workouts List");
     
     std::cout << "<h1>🏋️ Workouts</h1>\n";
@@ -1370,7 +1635,7 @@ void showWorkoutList(WorkoutService& service, const std::map<std::string, std::s
     std::cout << "<a href=\"workout.cgi?action=insert_form&table=workout\" class=\"btn\">➕ Add New Workout</a>\n";
     
     // Get all workouts
-    std::vector<Workout*> workouts = service.getAllWorkouts();
+    ResultSet<Workout> workouts = service.getAllWorkouts();
     
     std::cout << "<h2>All Workouts (" << workouts.size() << ")</h2>\n";
     
@@ -1383,25 +1648,24 @@ void showWorkoutList(WorkoutService& service, const std::map<std::string, std::s
         std::cout << "  <th>Type</th><th>Calories</th><th>RPE</th><th>Actions</th>\n";
         std::cout << "</tr>\n";
         
-        for (Workout* w : workouts) {
+        for (const Workout& w : workouts) {
             std::cout << "<tr>\n";
-            std::cout << "  <td>" << w->getWorkoutId() << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(w->getWorkoutDate()) << "</td>\n";
-            std::cout << "  <td>" << htmlEscape(w->getWorkoutTime()) << "</td>\n";
-            std::cout << "  <td>" << w->getDuration() << " min</td>\n";
-            std::cout << "  <td>" << htmlEscape(w->getTypeDescription()) << "</td>\n";
-            std::cout << "  <td>" << w->getCaloriesBurned() << "</td>\n";
-            std::cout << "  <td>" << w->getRatePerceivedExhaustion() << "/10</td>\n";
+            std::cout << "  <td>" << w.getWorkoutId() << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(w.getWorkoutDate()) << "</td>\n";
+            std::cout << "  <td>" << htmlEscape(w.getWorkoutTime()) << "</td>\n";
+            std::cout << "  <td>" << w.getDuration() << " min</td>\n";
+            std::cout << "  <td>" << htmlEscape(w.getTypeDescription()) << "</td>\n";
+            std::cout << "  <td>" << w.getCaloriesBurned() << "</td>\n";
+            std::cout << "  <td>" << w.getRatePerceivedExhaustion() << "/10</td>\n";
             std::cout << "  <td>\n";
             std::cout << "    <a href=\"workout.cgi?action=update_form&table=workout&id=" 
-                      << w->getWorkoutId() << "\" class=\"btn btn-edit\">Edit</a>\n";
+                      << w.getWorkoutId() << "\" class=\"btn btn-edit\">Edit</a>\n";
             std::cout << "    <a href=\"workout.cgi?action=delete&table=workout&id=" 
-                      << w->getWorkoutId() << "\" class=\"btn btn-delete\" "
+                      << w.getWorkoutId() << "\" class=\"btn btn-delete\" "
                       << "onclick=\"return confirm('Are you sure?')\">Delete</a>\n";
             std::cout << "  </td>\n";
             std::cout << "</tr>\n";
             
-            delete w;
         }
         
         std::cout << "</table>\n";
@@ -1470,15 +1734,15 @@ void showWorkoutInsertForm() {
 
 // ==================== WORKOUT INSERT HANDLER ====================
 
-void handleWorkoutInsert(WorkoutService& service, const std::map<std::string, std::string>& params) {
+void handleWorkoutInsert(WorkoutService& service, const CgiParams& params) {
     ServiceResponse response = service.insertWorkout(
-        params.at("date"),
-        params.at("time") + ":00",  // Add seconds
-        std::stoi(params.at("duration")),
-        params.at("type"),
-        std::stod(params.at("calories")),
-        std::stoi(params.at("rpe")),
-        std::stoi(params.at("muscle_group_id"))
+        params.text("date"),
+        params.text("time") + ":00",  // Add seconds
+        params.integer(NumericField::DURATION),
+        params.text("type"),
+        params.number(NumericField::CALORIES),
+        params.integer(NumericField::RPE),
+        params.integer(NumericField::MUSCLE_GROUP_ID)
     );
     
     printHTMLHeader("Workout Created");
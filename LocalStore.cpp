@@ -0,0 +1,461 @@
+// LocalStore.cpp
+// Workout Tracking System - Embedded single-file storage engine
+// Author: Therin Emmons
+// Date: 2026-10-18
+#include "LocalStore.h"
+#include <zlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+/*
+ * Record layout (integers little-endian):
+ *
+ *   u32 body length | u32 CRC-32 of body | body
+ *
+ *   body: u8 kind | u8 flags (1 = last record of a commit) | u8 table
+ *         i64 stamp (epoch seconds) | i32 id | str key | u32 count | count x str
+ *   str:  u32 length | bytes
+ */
+
+namespace {
+const uint8_t COMMIT_FLAG = 1;
+const size_t HEADER_SIZE = 8;
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out += static_cast<char>((value >> (8 * i)) & 0xff);
+}
+
+void putText(std::string& out, const std::string& text) {
+    putU32(out, static_cast<uint32_t>(text.size()));
+    out += text;
+}
+
+uint32_t getU32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    return value;
+}
+
+uint64_t getU64(const char* data) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    return value;
+}
+
+uint32_t checksum(const char* data, size_t length) {
+    return static_cast<uint32_t>(crc32(0L, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(length)));
+}
+
+// Bounds-checked reader over one record body
+struct Cursor {
+    const char* data;
+    size_t length;
+    size_t pos = 0;
+
+    bool has(size_t bytes) const { return length - pos >= bytes; }
+
+    bool readU32(uint32_t& value) {
+        if (!has(4)) return false;
+        value = getU32(data + pos);
+        pos += 4;
+        return true;
+    }
+
+    bool readText(std::string& text) {
+        uint32_t size;
+        if (!readU32(size) || !has(size)) return false;
+        text.assign(data + pos, size);
+        pos += size;
+        return true;
+    }
+};
+
+bool writeAll(int fd, const std::string& data, long long offset) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = pwrite(fd, data.data() + written, data.size() - written,
+                           static_cast<off_t>(offset + written));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Make a rename in dir durable
+void syncDirectoryOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(dir.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+}
+
+// Constructor
+LocalStore::LocalStore(const std::vector<TableSpec>& rowTables, size_t keyTableCount)
+    : specs(rowTables), tables(rowTables.size()), keyTables(keyTableCount) {
+}
+
+// Destructor
+LocalStore::~LocalStore() {
+    close();
+}
+
+bool LocalStore::fail(const std::string& message) {
+    error = message + (errno ? std::string(": ") + std::strerror(errno) : "");
+    return false;
+}
+
+bool LocalStore::open(const std::string& filePath, bool sync) {
+    close();
+    path = filePath;
+    syncWrites = sync;
+    errno = 0;
+
+    // Wait for any other process using the file to let go of it
+    lockFd = ::open((path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (lockFd < 0) return fail("Cannot create " + path + ".lock");
+    while (flock(lockFd, LOCK_EX) != 0) {
+        if (errno != EINTR) {
+            fail("Cannot lock " + path);
+            close();
+            return false;
+        }
+    }
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fail("Cannot open " + path);
+        close();
+        return false;
+    }
+
+    if (!replay()) {
+        close();
+        return false;
+    }
+    if (logRecords > 2 * liveRecords() + 1024) {
+        compact();
+    }
+    return true;
+}
+
+void LocalStore::close() {
+    if (fd >= 0) ::close(fd);
+    if (lockFd >= 0) ::close(lockFd);  // releases the flock
+    fd = -1;
+    lockFd = -1;
+    fileSize = 0;
+    logRecords = 0;
+    for (size_t i = 0; i < tables.size(); ++i) tables[i] = Table();
+    for (auto& keyTable : keyTables) keyTable.clear();
+}
+
+// ==================== RECORDS ====================
+
+void LocalStore::encode(std::string& out, const Change& change, long long stamp, bool last) {
+    std::string body;
+    body += static_cast<char>(change.kind);
+    body += static_cast<char>(last ? COMMIT_FLAG : 0);
+    body += static_cast<char>(change.table);
+    putU64(body, static_cast<uint64_t>(stamp));
+    putU32(body, static_cast<uint32_t>(change.id));
+    putText(body, change.key);
+    putU32(body, static_cast<uint32_t>(change.row.size()));
+    for (const std::string& value : change.row) {
+        putText(body, value);
+    }
+
+    putU32(out, static_cast<uint32_t>(body.size()));
+    putU32(out, checksum(body.data(), body.size()));
+    out += body;
+}
+
+bool LocalStore::decode(const char* body, size_t length, Change& change, long long& stamp, bool& last) const {
+    Cursor in{body, length};
+    if (!in.has(3 + 8)) return false;
+
+    uint8_t kind = static_cast<uint8_t>(body[0]);
+    last = (static_cast<uint8_t>(body[1]) & COMMIT_FLAG) != 0;
+    change.table = static_cast<uint8_t>(body[2]);
+    stamp = static_cast<long long>(getU64(body + 3));
+    in.pos = 3 + 8;
+
+    if (kind < static_cast<uint8_t>(Change::Kind::PUT_ROW) || kind > static_cast<uint8_t>(Change::Kind::NEXT_ID)) {
+        return false;
+    }
+    change.kind = static_cast<Change::Kind>(kind);
+
+    bool keyed = change.kind == Change::Kind::PUT_KEY || change.kind == Change::Kind::DELETE_KEY;
+    if (static_cast<size_t>(change.table) >= (keyed ? keyTables.size() : tables.size())) {
+        return false;
+    }
+
+    uint32_t id, count;
+    if (!in.readU32(id) || !in.readText(change.key) || !in.readU32(count)) return false;
+    change.id = static_cast<int>(id);
+
+    change.row.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string value;
+        if (!in.readText(value)) return false;
+        change.row.push_back(std::move(value));
+    }
+    return in.pos == length;
+}
+
+// The whole, checksummed record at pos of data; end is set past it
+bool LocalStore::readRecord(const std::string& data, size_t pos, Change& change, long long& stamp, bool& last,
+                            size_t& end) const {
+    if (data.size() - pos < HEADER_SIZE) return false;
+    uint32_t length = getU32(&data[pos]);
+    uint32_t crc = getU32(&data[pos + 4]);
+    if (length > data.size() - pos - HEADER_SIZE) return false;
+
+    const char* body = &data[pos + HEADER_SIZE];
+    if (checksum(body, length) != crc || !decode(body, length, change, stamp, last)) return false;
+    end = pos + HEADER_SIZE + length;
+    return true;
+}
+
+std::string LocalStore::indexKey(int tableId, const Row& row) const {
+    std::string key;
+    const std::vector<int>& columns = specs[tableId].indexColumns;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) key += indexSeparator;
+        if (static_cast<size_t>(columns[i]) < row.size()) key += row[columns[i]];
+    }
+    return key;
+}
+
+void LocalStore::apply(const Change& change, long long stamp) {
+    if (change.kind == Change::Kind::PUT_KEY) {
+        keyTables[change.table][change.key] = change.row;
+        return;
+    }
+    if (change.kind == Change::Kind::DELETE_KEY) {
+        keyTables[change.table].erase(change.key);
+        return;
+    }
+
+    Table& target = tables[change.table];
+    if (change.kind == Change::Kind::NEXT_ID) {
+        if (change.id > target.nextId) target.nextId = change.id;
+        return;
+    }
+
+    auto existing = target.rows.find(change.id);
+    if (existing != target.rows.end()) {
+        target.index.erase({indexKey(change.table, existing->second), change.id});
+        if (change.kind == Change::Kind::DELETE_ROW) target.rows.erase(existing);
+    }
+    if (change.kind == Change::Kind::PUT_ROW) {
+        target.rows[change.id] = change.row;
+        target.index.insert({indexKey(change.table, change.row), change.id});
+        if (change.id >= target.nextId) target.nextId = change.id + 1;
+    }
+    if (stamp > target.lastUpdated) target.lastUpdated = stamp;
+    ++target.changes;
+}
+
+size_t LocalStore::liveRecords() const {
+    size_t live = tables.size();  // one NEXT_ID per table
+    for (const Table& t : tables) live += t.rows.size();
+    for (const auto& keyTable : keyTables) live += keyTable.size();
+    return live;
+}
+
+// ==================== RECOVERY ====================
+
+// Rebuild the tables from the log. Records are applied a commit at a time;
+// anything after the last complete commit (a crash mid-write) is cut off.
+// A crash only ever tears the last append, so when an intact record still
+// follows the first bad one the file is damaged, not torn: it is left as it
+// is and the open fails with the bad record's offset.
+bool LocalStore::replay() {
+    struct stat info;
+    if (fstat(fd, &info) != 0) return fail("Cannot stat " + path);
+
+    std::string data(static_cast<size_t>(info.st_size), '\0');
+    size_t loaded = 0;
+    while (loaded < data.size()) {
+        ssize_t n = pread(fd, &data[loaded], data.size() - loaded, static_cast<off_t>(loaded));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return fail("Cannot read " + path);
+        loaded += static_cast<size_t>(n);
+    }
+
+    std::vector<std::pair<Change, long long>> pending;
+    size_t pos = 0;
+    size_t committedEnd = 0;
+
+    Change change;
+    long long stamp;
+    bool last;
+    size_t end;
+    while (pos < data.size() && readRecord(data, pos, change, stamp, last, end)) {
+        pending.emplace_back(std::move(change), stamp);
+        pos = end;
+        if (last) {
+            for (const auto& entry : pending) apply(entry.first, entry.second);
+            logRecords += pending.size();
+            pending.clear();
+            committedEnd = pos;
+        }
+    }
+
+    // Look past the bad record for one that is intact. A torn tail holds
+    // none: it is part of one record followed by zeros or stale bytes.
+    for (size_t at = pos + 1; pos < data.size() && at + HEADER_SIZE <= data.size(); ++at) {
+        if (readRecord(data, at, change, stamp, last, end)) {
+            errno = 0;
+            return fail("Corrupt record at offset " + std::to_string(pos) + " of " + path +
+                        ", followed by intact records at offset " + std::to_string(at) +
+                        "; the file was left unchanged");
+        }
+    }
+
+    if (committedEnd < data.size()) {
+        std::cerr << "LocalStore: discarding " << data.size() - committedEnd
+                  << " bytes of incomplete log tail in " << path << std::endl;
+        if (ftruncate(fd, static_cast<off_t>(committedEnd)) != 0) {
+            return fail("Cannot truncate " + path);
+        }
+    }
+    fileSize = static_cast<long long>(committedEnd);
+    return true;
+}
+
+// ==================== WRITES ====================
+
+bool LocalStore::commit(const std::vector<Change>& changes) {
+    if (fd < 0) {
+        error = "Store is not open";
+        return false;
+    }
+    if (changes.empty()) return true;
+
+    long long stamp = static_cast<long long>(std::time(nullptr));
+    std::string data;
+    for (size_t i = 0; i < changes.size(); ++i) {
+        encode(data, changes[i], stamp, i + 1 == changes.size());
+    }
+
+    // Write-ahead: nothing is visible in memory until the records are on disk
+    errno = 0;
+    if (!writeAll(fd, data, fileSize) || (syncWrites && fdatasync(fd) != 0)) {
+        fail("Cannot write " + path);
+        if (ftruncate(fd, static_cast<off_t>(fileSize)) != 0) {
+            std::cerr << "LocalStore: cannot roll back partial write to " << path << std::endl;
+        }
+        return false;
+    }
+
+    fileSize += static_cast<long long>(data.size());
+    logRecords += changes.size();
+    for (const Change& change : changes) {
+        apply(change, stamp);
+    }
+
+    if (logRecords > 2 * liveRecords() + 1024) {
+        compact();
+    }
+    return true;
+}
+
+// Rewrite the log with one record per live row. The new file is complete
+// and fsync'd before it replaces the old one, so a crash during compaction
+// leaves the old log in place.
+bool LocalStore::compact() {
+    std::string tempPath = path + ".compact";
+    errno = 0;
+    int out = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (out < 0) {
+        fail("Cannot create " + tempPath);
+        std::cerr << "LocalStore: " << error << std::endl;
+        return false;
+    }
+
+    // Each record is its own commit: the file only becomes the log once
+    // it has been written in full
+    std::string data;
+    long long written = 0;
+    size_t records = 0;
+    bool ok = true;
+    auto emit = [&](const Change& change, long long stamp) {
+        encode(data, change, stamp, true);
+        ++records;
+        if (data.size() >= (1 << 20)) {
+            ok = ok && writeAll(out, data, written);
+            written += static_cast<long long>(data.size());
+            data.clear();
+        }
+    };
+
+    for (size_t t = 0; t < tables.size(); ++t) {
+        int tableId = static_cast<int>(t);
+        for (const auto& row : tables[t].rows) {
+            emit(Change::putRow(tableId, row.first, row.second), tables[t].lastUpdated);
+        }
+        emit(Change{Change::Kind::NEXT_ID, tableId, tables[t].nextId, "", Row()}, tables[t].lastUpdated);
+    }
+    for (size_t k = 0; k < keyTables.size(); ++k) {
+        for (const auto& entry : keyTables[k]) {
+            emit(Change::putKey(static_cast<int>(k), entry.first, entry.second), 0);
+        }
+    }
+    ok = ok && writeAll(out, data, written);
+    written += static_cast<long long>(data.size());
+    ok = ok && fsync(out) == 0;
+    ::close(out);
+
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        fail("Cannot compact " + path);
+        std::cerr << "LocalStore: " << error << std::endl;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    syncDirectoryOf(path);
+
+    // Switch to the new file; the lock lives on "<path>.lock" and is unaffected
+    int compacted = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (compacted < 0) {
+        // The old descriptor now points at an unlinked file; stop writing
+        fail("Cannot reopen " + path);
+        std::cerr << "LocalStore: " << error << std::endl;
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    ::close(fd);
+    fd = compacted;
+    fileSize = written;
+    logRecords = records;
+    return true;
+}
+
+const LocalStore::Row* LocalStore::find(int tableId, int id) const {
+    auto it = tables[tableId].rows.find(id);
+    return it == tables[tableId].rows.end() ? nullptr : &it->second;
+}
+
+const LocalStore::Row* LocalStore::findKey(int keyTableId, const std::string& key) const {
+    auto it = keyTables[keyTableId].find(key);
+    return it == keyTables[keyTableId].end() ? nullptr : &it->second;
+}
@@ -0,0 +1,132 @@
+// LocalStore.h
+// Workout Tracking System - Embedded single-file storage engine
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef LOCALSTORE_H
+#define LOCALSTORE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/*
+ * The storage engine behind LocalStoreDAO. Everything lives in one data file
+ * that is only ever appended to, and that file is also the write-ahead log:
+ * commit() writes a group of checksummed records, fsyncs them, and only then
+ * applies them in memory. The last record of each commit carries a flag, so
+ * after a crash open() replays whole commits and cuts off a torn or
+ * half-written tail. A damaged record with intact records after it is not a
+ * crash mid-write, so open() refuses the file and names the offset instead
+ * of cutting off the commits that follow.
+ *
+ * Tables are held in memory and rebuilt from the log on open:
+ *   row tables  id -> row in a std::map (ordered by id), plus a sorted index
+ *               on chosen columns, e.g. (workout_date, workout_time)
+ *   key tables  string key -> row, for DayLog and IdempotencyKey
+ *
+ * Updates and deletes leave dead records behind; once they outnumber the
+ * live rows the log is compacted into a fresh file that replaces the old
+ * one with an atomic rename.
+ *
+ * Not thread-safe (LocalStoreDAO serializes calls). An exclusive flock() on
+ * "<path>.lock" keeps other processes out while the store is open.
+ */
+class LocalStore {
+public:
+    typedef std::vector<std::string> Row;              // column values as text
+    typedef std::set<std::pair<std::string, int>> Index;  // (index key, id)
+
+    // Row table definition: the columns its sorted index is built from
+    struct TableSpec {
+        std::string name;
+        std::vector<int> indexColumns;
+    };
+
+    struct Table {
+        std::map<int, Row> rows;
+        Index index;
+        int nextId = 1;             // next auto-increment id
+        long long lastUpdated = 0;  // epoch seconds of the newest change
+        unsigned long long changes = 0;  // rows put or deleted since the store was opened
+    };
+
+    // One change; commit() writes a list of them atomically
+    struct Change {
+        enum class Kind : uint8_t { PUT_ROW = 1, DELETE_ROW, PUT_KEY, DELETE_KEY, NEXT_ID };
+
+        Kind kind;
+        int table;
+        int id;
+        std::string key;
+        Row row;
+
+        static Change putRow(int table, int id, const Row& row) { return {Kind::PUT_ROW, table, id, "", row}; }
+        static Change deleteRow(int table, int id) { return {Kind::DELETE_ROW, table, id, "", Row()}; }
+        static Change putKey(int table, const std::string& key, const Row& row) { return {Kind::PUT_KEY, table, 0, key, row}; }
+        static Change deleteKey(int table, const std::string& key) { return {Kind::DELETE_KEY, table, 0, key, Row()}; }
+    };
+
+    // Index keys join the index columns with this separator
+    static constexpr char indexSeparator = '\x1f';
+
+private:
+    std::vector<TableSpec> specs;
+    std::vector<Table> tables;
+    std::vector<std::map<std::string, Row>> keyTables;
+
+    std::string path;
+    bool syncWrites = true;
+    int fd = -1;
+    int lockFd = -1;
+    long long fileSize = 0;
+    size_t logRecords = 0;  // records in the file, live or superseded
+    std::string error;
+
+    static void encode(std::string& out, const Change& change, long long stamp, bool last);
+    bool decode(const char* body, size_t length, Change& change, long long& stamp, bool& last) const;
+    bool readRecord(const std::string& data, size_t pos, Change& change, long long& stamp, bool& last,
+                    size_t& end) const;
+    void apply(const Change& change, long long stamp);
+    bool replay();
+    bool compact();
+    size_t liveRecords() const;
+    bool fail(const std::string& message);
+
+public:
+    LocalStore(const std::vector<TableSpec>& rowTables, size_t keyTableCount);
+    ~LocalStore();
+
+    LocalStore(const LocalStore&) = delete;
+    LocalStore& operator=(const LocalStore&) = delete;
+
+    // Open (creating if needed) and replay the data file. syncWrites = false
+    // skips the fsync per commit: faster, but a power loss may drop the
+    // latest commits (never corrupt older ones).
+    bool open(const std::string& filePath, bool sync = true);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    const std::string& getPath() const { return path; }
+    const std::string& getError() const { return error; }
+    size_t getLogRecords() const { return logRecords; }
+
+    // Reads: straight from memory
+    const Table& table(int tableId) const { return tables[tableId]; }
+    const Row* find(int tableId, int id) const;
+    const std::map<std::string, Row>& keys(int keyTableId) const { return keyTables[keyTableId]; }
+    const Row* findKey(int keyTableId, const std::string& key) const;
+    std::string indexKey(int tableId, const Row& row) const;
+
+    // Hand out the next id of a table. Ids of commits that fail are not
+    // reused, the same gaps AUTO_INCREMENT leaves.
+    int reserveId(int tableId) { return tables[tableId].nextId++; }
+
+    // Durably apply all changes, or none of them
+    bool commit(const std::vector<Change>& changes);
+};
+
+#endif // LOCALSTORE_H
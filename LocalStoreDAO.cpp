@@ -0,0 +1,746 @@
+// LocalStoreDAO.cpp
+// Workout Tracking System - WorkoutDAO backed by an embedded local store
+// Author: Therin Emmons
+// Date: 2026-10-18
+#include "LocalStoreDAO.h"
+#include "RowMapping.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <iostream>
+#include <iterator>
+
+namespace {
+// Row tables of the store, in TableSpec order
+enum LocalTable {
+    WORKOUT_TABLE,
+    MUSCLE_GROUP_TABLE,
+    NUTRITION_TABLE,
+    RECOVERY_TABLE,
+    EQUIPMENT_TABLE
+};
+
+// Key tables: DayLog rows are {workout_id, nutrition_ids, recovery_id, fingerprint};
+// IdempotencyKey rows are {fingerprint, status, content_type, body, created_at}
+enum LocalKeyTable {
+    DAY_LOG_TABLE,
+    IDEMPOTENCY_TABLE,
+    KEY_TABLE_COUNT
+};
+
+// ID of each thread's last insert, as LAST_INSERT_ID() is per connection
+thread_local int threadInsertId = 0;
+
+// Each index leads with the column the matching SQL query sorts or looks up by
+const std::vector<LocalStore::TableSpec>& tableSpecs() {
+    static const std::vector<LocalStore::TableSpec> specs = {
+        {"Workout", {fieldIndex<Workout>("workout_date"), fieldIndex<Workout>("workout_time")}},
+        {"MuscleGroup", {fieldIndex<MuscleGroup>("name")}},
+        {"Nutrition", {fieldIndex<Nutrition>("meal_date")}},
+        {"Recovery", {fieldIndex<Recovery>("recovery_date")}},
+        {"Equipment", {fieldIndex<Equipment>("name")}},
+    };
+    return specs;
+}
+
+// MuscleGroup and Equipment names are unique (uk_*_name in create_tables.sql)
+bool hasUniqueName(int table) {
+    return table == MUSCLE_GROUP_TABLE || table == EQUIPMENT_TABLE;
+}
+
+const int workoutMuscleGroupColumn = fieldIndex<Workout>("muscle_group_id");
+
+template<typename T>
+T decodeStored(const LocalStore::Row& row) {
+    std::vector<const char*> values(std::size(RowMapping<T>::fields), nullptr);
+    for (size_t i = 0; i < values.size() && i < row.size(); ++i) {
+        values[i] = row[i].c_str();
+    }
+    T entity;
+    decodeRow(values.data(), entity);
+    return entity;
+}
+
+// SQL LIKE: % matches any run, _ one character; ASCII case-insensitive
+bool likeMatch(const char* text, const char* pattern) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*text) {
+        if (*pattern == '%') {
+            star = pattern++;
+            resume = text;
+        } else if (*pattern == '_' ||
+                   std::tolower(static_cast<unsigned char>(*pattern)) ==
+                   std::tolower(static_cast<unsigned char>(*text))) {
+            ++pattern;
+            ++text;
+        } else if (star) {
+            pattern = star + 1;
+            text = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '%') ++pattern;
+    return *pattern == '\0';
+}
+
+// -1 / 0 / 1 comparing a stored value with a bound one, numerically for
+// numeric columns
+int compareValue(const std::string& stored, SqlParam::Kind kind, const SqlParam& value) {
+    if (kind == SqlParam::Kind::TEXT) {
+        int order = stored.compare(value.textValue);
+        return order < 0 ? -1 : (order > 0 ? 1 : 0);
+    }
+    double left = parseDoubleField(stored.c_str());
+    double right = value.kind == SqlParam::Kind::INT ? static_cast<double>(value.intValue) : value.doubleValue;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+bool satisfies(const std::string& stored, SqlParam::Kind kind, CompareOp op, const SqlParam& value) {
+    if (op == CompareOp::LIKE) return likeMatch(stored.c_str(), value.textValue.c_str());
+    int order = compareValue(stored, kind, value);
+    switch (op) {
+        case CompareOp::EQ: return order == 0;
+        case CompareOp::NE: return order != 0;
+        case CompareOp::LT: return order < 0;
+        case CompareOp::LE: return order <= 0;
+        case CompareOp::GT: return order > 0;
+        default:            return order >= 0;
+    }
+}
+
+// First column of an index key
+std::string leadingValue(const std::string& indexKey) {
+    return indexKey.substr(0, indexKey.find(LocalStore::indexSeparator));
+}
+}
+
+// Constructor
+LocalStoreDAO::LocalStoreDAO(const std::string& filePath, bool sync)
+    : store(tableSpecs(), KEY_TABLE_COUNT), path(filePath), syncWrites(sync) {
+    ready();
+}
+
+// Destructor
+LocalStoreDAO::~LocalStoreDAO() {
+    store.close();
+}
+
+// Open the store on first use, or again after a failed open
+bool LocalStoreDAO::ready() {
+    if (store.isOpen()) return true;
+    if (!store.open(path, syncWrites)) {
+        std::cerr << "Local Store Error: " << store.getError() << std::endl;
+        noteFailure();
+        return false;
+    }
+    return true;
+}
+
+bool LocalStoreDAO::commit(const std::vector<LocalStore::Change>& changes, const std::string& operation) {
+    if (!store.commit(changes)) {
+        std::cerr << operation << " Error: " << store.getError() << std::endl;
+        noteFailure();
+        return false;
+    }
+    return true;
+}
+
+// Id of the row with this name in a table indexed by name, or 0
+int LocalStoreDAO::findByName(int table, const std::string& name) {
+    const LocalStore::Index& index = store.table(table).index;
+    auto it = index.lower_bound({name, INT_MIN});
+    return it != index.end() && it->first == name ? it->second : 0;
+}
+
+// Constraints the MySQL schema enforces: unique names, and a workout's
+// muscle group must exist
+bool LocalStoreDAO::checkRow(int table, const LocalStore::Row& row, int id, const std::string& operation) {
+    if (hasUniqueName(table)) {
+        const std::string& name = row[tableSpecs()[table].indexColumns[0]];
+        int existing = findByName(table, name);
+        if (existing != 0 && existing != id) {
+            setDuplicateWrite(true);
+            std::cerr << operation << " Error: Duplicate entry '" << name << "' for key 'name'" << std::endl;
+            return false;
+        }
+    }
+    if (table == WORKOUT_TABLE) {
+        int muscleGroupId = parseIntField(row[workoutMuscleGroupColumn].c_str());
+        if (muscleGroupId > 0 && !store.find(MUSCLE_GROUP_TABLE, muscleGroupId)) {
+            std::cerr << operation << " Error: muscle group " << muscleGroupId << " does not exist" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==================== GENERIC ROW OPERATIONS ====================
+
+template<typename T>
+T* LocalStoreDAO::readRow(int table, int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return nullptr;
+
+    const LocalStore::Row* row = store.find(table, id);
+    return row ? new T(decodeStored<T>(*row)) : nullptr;
+}
+
+// Point lookups for several IDs under one lock, in the order given
+// (repeats and unknown IDs skipped, like the IN (...) query in WorkoutDAO)
+template<typename T>
+ResultSet<T> LocalStoreDAO::readRows(int table, const std::vector<int>& ids) {
+    ResultSet<T> list;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return list;
+
+    list.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (std::find(ids.begin(), ids.begin() + i, ids[i]) != ids.begin() + i) continue;
+        if (const LocalStore::Row* row = store.find(table, ids[i])) {
+            list.add(decodeStored<T>(*row));
+        }
+    }
+    return list;
+}
+
+// Evaluate a filter in memory. A bound on the index's leading column narrows
+// the scan to a range of the index; every condition is then checked per row.
+template<typename T, typename Column>
+ResultSet<T> LocalStoreDAO::readFiltered(int table, const QueryFilter<Column>& filter, bool descending,
+                                         const std::string& operation) {
+    ResultSet<T> list;
+    if (!filter.isValid()) {
+        std::cerr << operation << " Error: " << filter.getError() << std::endl;
+        return list;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return list;
+
+    const LocalStore::Table& data = store.table(table);
+    int leading = tableSpecs()[table].indexColumns[0];
+
+    struct Term {
+        int field;
+        SqlParam::Kind kind;
+        CompareOp op;
+        const SqlParam* value;
+    };
+    std::vector<Term> terms;
+    std::string lower, upper;
+    bool hasLower = false, hasUpper = false;
+
+    for (const auto& condition : filter.getConditions()) {
+        ColumnInfo info = columnInfo(condition.column);
+        int field = fieldIndex<T>(info.name);
+        terms.push_back({field, info.kind, condition.op, &condition.value});
+
+        if (field != leading || info.kind != SqlParam::Kind::TEXT) continue;
+        const std::string& bound = condition.value.textValue;
+        if (condition.op == CompareOp::EQ || condition.op == CompareOp::GE || condition.op == CompareOp::GT) {
+            if (!hasLower || bound > lower) lower = bound;
+            hasLower = true;
+        }
+        if (condition.op == CompareOp::EQ || condition.op == CompareOp::LE || condition.op == CompareOp::LT) {
+            if (!hasUpper || bound < upper) upper = bound;
+            hasUpper = true;
+        }
+    }
+
+    std::vector<const LocalStore::Row*> rows;
+    auto it = hasLower ? data.index.lower_bound({lower, INT_MIN}) : data.index.begin();
+    for (; it != data.index.end(); ++it) {
+        if (hasUpper && leadingValue(it->first) > upper) break;
+
+        const LocalStore::Row& row = data.rows.at(it->second);
+        bool keep = true;
+        for (const Term& term : terms) {
+            if (!satisfies(row[term.field], term.kind, term.op, *term.value)) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) rows.push_back(&row);
+    }
+
+    if (filter.hasOrder()) {
+        ColumnInfo info = columnInfo(filter.getOrderColumn());
+        int field = fieldIndex<T>(info.name);
+        bool desc = filter.isOrderDescending();
+        std::stable_sort(rows.begin(), rows.end(), [&](const LocalStore::Row* a, const LocalStore::Row* b) {
+            int order = info.kind == SqlParam::Kind::TEXT
+                ? compareValue((*a)[field], info.kind, SqlParam::fromText((*b)[field]))
+                : compareValue((*a)[field], info.kind, SqlParam::fromDouble(parseDoubleField((*b)[field].c_str())));
+            return desc ? order > 0 : order < 0;
+        });
+    } else if (descending) {
+        std::reverse(rows.begin(), rows.end());
+    }
+
+    if (filter.getLimit() > 0 && rows.size() > static_cast<size_t>(filter.getLimit())) {
+        rows.resize(filter.getLimit());
+    }
+
+    list.reserve(rows.size());
+    for (const LocalStore::Row* row : rows) {
+        list.add(decodeStored<T>(*row));
+    }
+    return list;
+}
+
+template<typename T>
+bool LocalStoreDAO::insertRow(int table, const T& entity, const std::string& operation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    setDuplicateWrite(false);
+    if (!ready()) return false;
+
+    LocalStore::Row row = encodeRow(entity);
+    if (!checkRow(table, row, 0, operation)) return false;
+
+    int id = store.reserveId(table);
+    row[0] = formatIntField(id);
+    if (!commit({LocalStore::Change::putRow(table, id, row)}, operation)) {
+        return false;
+    }
+
+    threadInsertId = id;
+    std::cout << RowMapping<T>::table << " created successfully with ID: " << id << std::endl;
+    return true;
+}
+
+template<typename T>
+bool LocalStoreDAO::updateRow(int table, int id, const T& entity, const std::string& operation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    setDuplicateWrite(false);
+    if (!ready()) return false;
+
+    // Like an UPDATE that matches no rows: nothing to do, not an error
+    if (!store.find(table, id)) return true;
+
+    LocalStore::Row row = encodeRow(entity);
+    row[0] = formatIntField(id);
+    if (!checkRow(table, row, id, operation)) return false;
+    if (!commit({LocalStore::Change::putRow(table, id, row)}, operation)) {
+        return false;
+    }
+
+    std::cout << RowMapping<T>::table << " updated successfully!" << std::endl;
+    return true;
+}
+
+template<typename T>
+bool LocalStoreDAO::deleteRow(int table, int id, const std::string& operation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    if (!store.find(table, id)) return true;
+
+    std::vector<LocalStore::Change> changes{LocalStore::Change::deleteRow(table, id)};
+
+    // ON DELETE SET NULL: detach the group's workouts in the same commit
+    if (table == MUSCLE_GROUP_TABLE) {
+        std::string groupId = formatIntField(id);
+        for (const auto& workout : store.table(WORKOUT_TABLE).rows) {
+            if (workout.second[workoutMuscleGroupColumn] != groupId) continue;
+            LocalStore::Row detached = workout.second;
+            detached[workoutMuscleGroupColumn] = "0";
+            changes.push_back(LocalStore::Change::putRow(WORKOUT_TABLE, workout.first, detached));
+        }
+    }
+
+    if (!commit(changes, operation)) {
+        return false;
+    }
+
+    std::cout << RowMapping<T>::table << " deleted successfully!" << std::endl;
+    return true;
+}
+
+// ==================== WORKOUT CRUD OPERATIONS ====================
+
+bool LocalStoreDAO::createWorkout(const Workout& workout) {
+    return insertRow(WORKOUT_TABLE, workout, "Create Workout");
+}
+
+Workout* LocalStoreDAO::readWorkout(int workoutId) {
+    return readRow<Workout>(WORKOUT_TABLE, workoutId);
+}
+
+ResultSet<Workout> LocalStoreDAO::readWorkoutsByIds(const std::vector<int>& workoutIds) {
+    return readRows<Workout>(WORKOUT_TABLE, workoutIds);
+}
+
+ResultSet<Workout> LocalStoreDAO::readAllWorkouts() {
+    return readFiltered<Workout>(WORKOUT_TABLE, WorkoutFilter(), true, "Read All Workouts");
+}
+
+ResultSet<Workout> LocalStoreDAO::readWorkoutsByDate(const std::string& date) {
+    WorkoutFilter filter;
+    filter.where(WorkoutColumn::DATE, CompareOp::EQ, date);
+    return readFiltered<Workout>(WORKOUT_TABLE, filter, true, "Read Workouts by Date");
+}
+
+ResultSet<Workout> LocalStoreDAO::readWorkoutsByMuscleGroup(int muscleGroupId) {
+    WorkoutFilter filter;
+    filter.where(WorkoutColumn::MUSCLE_GROUP, CompareOp::EQ, muscleGroupId);
+    return readFiltered<Workout>(WORKOUT_TABLE, filter, true, "Read Workouts by Muscle Group");
+}
+
+ResultSet<Workout> LocalStoreDAO::readWorkoutsWhere(const WorkoutFilter& filter) {
+    return readFiltered<Workout>(WORKOUT_TABLE, filter, true, "Read Workouts Where");
+}
+
+bool LocalStoreDAO::updateWorkout(const Workout& workout) {
+    return updateRow(WORKOUT_TABLE, workout.getWorkoutId(), workout, "Update Workout");
+}
+
+bool LocalStoreDAO::deleteWorkout(int workoutId) {
+    return deleteRow<Workout>(WORKOUT_TABLE, workoutId, "Delete Workout");
+}
+
+// ==================== MUSCLEGROUP CRUD OPERATIONS ====================
+
+bool LocalStoreDAO::createMuscleGroup(const MuscleGroup& muscleGroup) {
+    return insertRow(MUSCLE_GROUP_TABLE, muscleGroup, "Create MuscleGroup");
+}
+
+MuscleGroup* LocalStoreDAO::readMuscleGroup(int muscleGroupId) {
+    return readRow<MuscleGroup>(MUSCLE_GROUP_TABLE, muscleGroupId);
+}
+
+ResultSet<MuscleGroup> LocalStoreDAO::readMuscleGroupsByIds(const std::vector<int>& muscleGroupIds) {
+    return readRows<MuscleGroup>(MUSCLE_GROUP_TABLE, muscleGroupIds);
+}
+
+ResultSet<MuscleGroup> LocalStoreDAO::readAllMuscleGroups() {
+    return readFiltered<MuscleGroup>(MUSCLE_GROUP_TABLE, MuscleGroupFilter(), false, "Read All MuscleGroups");
+}
+
+MuscleGroup* LocalStoreDAO::readMuscleGroupByName(const std::string& name) {
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ready()) return nullptr;
+        id = findByName(MUSCLE_GROUP_TABLE, name);
+    }
+    return id ? readRow<MuscleGroup>(MUSCLE_GROUP_TABLE, id) : nullptr;
+}
+
+ResultSet<MuscleGroup> LocalStoreDAO::readMuscleGroupsWhere(const MuscleGroupFilter& filter) {
+    return readFiltered<MuscleGroup>(MUSCLE_GROUP_TABLE, filter, false, "Read MuscleGroups Where");
+}
+
+bool LocalStoreDAO::updateMuscleGroup(const MuscleGroup& muscleGroup) {
+    return updateRow(MUSCLE_GROUP_TABLE, muscleGroup.getMuscleGroupId(), muscleGroup, "Update MuscleGroup");
+}
+
+bool LocalStoreDAO::deleteMuscleGroup(int muscleGroupId) {
+    return deleteRow<MuscleGroup>(MUSCLE_GROUP_TABLE, muscleGroupId, "Delete MuscleGroup");
+}
+
+// ==================== NUTRITION CRUD OPERATIONS ====================
+
+bool LocalStoreDAO::createNutrition(const Nutrition& nutrition) {
+    return insertRow(NUTRITION_TABLE, nutrition, "Create Nutrition");
+}
+
+Nutrition* LocalStoreDAO::readNutrition(int nutritionId) {
+    return readRow<Nutrition>(NUTRITION_TABLE, nutritionId);
+}
+
+ResultSet<Nutrition> LocalStoreDAO::readAllNutrition() {
+    return readFiltered<Nutrition>(NUTRITION_TABLE, NutritionFilter(), true, "Read All Nutrition");
+}
+
+ResultSet<Nutrition> LocalStoreDAO::readNutritionByDate(const std::string& date) {
+    NutritionFilter filter;
+    filter.where(NutritionColumn::DATE, CompareOp::EQ, date);
+    return readFiltered<Nutrition>(NUTRITION_TABLE, filter, true, "Read Nutrition by Date");
+}
+
+ResultSet<Nutrition> LocalStoreDAO::readNutritionByFamily(const std::string& family) {
+    NutritionFilter filter;
+    filter.where(NutritionColumn::FAMILY, CompareOp::EQ, family);
+    return readFiltered<Nutrition>(NUTRITION_TABLE, filter, true, "Read Nutrition by Family");
+}
+
+ResultSet<Nutrition> LocalStoreDAO::readNutritionWhere(const NutritionFilter& filter) {
+    return readFiltered<Nutrition>(NUTRITION_TABLE, filter, true, "Read Nutrition Where");
+}
+
+bool LocalStoreDAO::updateNutrition(const Nutrition& nutrition) {
+    return updateRow(NUTRITION_TABLE, nutrition.getNutritionId(), nutrition, "Update Nutrition");
+}
+
+bool LocalStoreDAO::deleteNutrition(int nutritionId) {
+    return deleteRow<Nutrition>(NUTRITION_TABLE, nutritionId, "Delete Nutrition");
+}
+
+// ==================== RECOVERY CRUD OPERATIONS ====================
+
+bool LocalStoreDAO::createRecovery(const Recovery& recovery) {
+    return insertRow(RECOVERY_TABLE, recovery, "Create Recovery");
+}
+
+Recovery* LocalStoreDAO::readRecovery(int recoveryId) {
+    return readRow<Recovery>(RECOVERY_TABLE, recoveryId);
+}
+
+ResultSet<Recovery> LocalStoreDAO::readAllRecovery() {
+    return readFiltered<Recovery>(RECOVERY_TABLE, RecoveryFilter(), true, "Read All Recovery");
+}
+
+ResultSet<Recovery> LocalStoreDAO::readRecoveryByDate(const std::string& date) {
+    RecoveryFilter filter;
+    filter.where(RecoveryColumn::DATE, CompareOp::EQ, date);
+    return readFiltered<Recovery>(RECOVERY_TABLE, filter, true, "Read Recovery by Date");
+}
+
+ResultSet<Recovery> LocalStoreDAO::readRecoveryByType(const std::string& type) {
+    RecoveryFilter filter;
+    filter.where(RecoveryColumn::TYPE, CompareOp::EQ, type);
+    return readFiltered<Recovery>(RECOVERY_TABLE, filter, true, "Read Recovery by Type");
+}
+
+ResultSet<Recovery> LocalStoreDAO::readRecoveryWhere(const RecoveryFilter& filter) {
+    return readFiltered<Recovery>(RECOVERY_TABLE, filter, true, "Read Recovery Where");
+}
+
+bool LocalStoreDAO::updateRecovery(const Recovery& recovery) {
+    return updateRow(RECOVERY_TABLE, recovery.getRecoveryId(), recovery, "Update Recovery");
+}
+
+bool LocalStoreDAO::deleteRecovery(int recoveryId) {
+    return deleteRow<Recovery>(RECOVERY_TABLE, recoveryId, "Delete Recovery");
+}
+
+// ==================== EQUIPMENT CRUD OPERATIONS ====================
+
+bool LocalStoreDAO::createEquipment(const Equipment& equipment) {
+    return insertRow(EQUIPMENT_TABLE, equipment, "Create Equipment");
+}
+
+Equipment* LocalStoreDAO::readEquipment(int equipmentId) {
+    return readRow<Equipment>(EQUIPMENT_TABLE, equipmentId);
+}
+
+ResultSet<Equipment> LocalStoreDAO::readAllEquipment() {
+    return readFiltered<Equipment>(EQUIPMENT_TABLE, EquipmentFilter(), false, "Read All Equipment");
+}
+
+ResultSet<Equipment> LocalStoreDAO::readEquipmentByCategory(const std::string& category) {
+    EquipmentFilter filter;
+    filter.where(EquipmentColumn::CATEGORY, CompareOp::EQ, category);
+    return readFiltered<Equipment>(EQUIPMENT_TABLE, filter, false, "Read Equipment by Category");
+}
+
+Equipment* LocalStoreDAO::readEquipmentByName(const std::string& name) {
+    int id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ready()) return nullptr;
+        id = findByName(EQUIPMENT_TABLE, name);
+    }
+    return id ? readRow<Equipment>(EQUIPMENT_TABLE, id) : nullptr;
+}
+
+ResultSet<Equipment> LocalStoreDAO::readEquipmentWhere(const EquipmentFilter& filter) {
+    return readFiltered<Equipment>(EQUIPMENT_TABLE, filter, false, "Read Equipment Where");
+}
+
+bool LocalStoreDAO::updateEquipment(const Equipment& equipment) {
+    return updateRow(EQUIPMENT_TABLE, equipment.getEquipmentId(), equipment, "Update Equipment");
+}
+
+bool LocalStoreDAO::deleteEquipment(int equipmentId) {
+    return deleteRow<Equipment>(EQUIPMENT_TABLE, equipmentId, "Delete Equipment");
+}
+
+// ==================== TRAINING DAY AND BATCH INSERT ====================
+
+// Everything, including the DayLog entry for clientKey, goes in one commit
+bool LocalStoreDAO::logDay(const std::string& clientKey, const std::string& fingerprint, const Workout* workout,
+                           const std::vector<Nutrition>& meals, const Recovery* recovery,
+                           DayLogResult& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    if (!clientKey.empty()) {
+        if (const LocalStore::Row* saved = store.findKey(DAY_LOG_TABLE, clientKey)) {
+            // Rows from before fingerprints were stored have three columns
+            if (saved->size() > 3 && !(*saved)[3].empty() && (*saved)[3] != fingerprint) {
+                result = DayLogResult();
+                result.mismatch = true;
+                std::cerr << "Log Day Error: key " << clientKey << " was used for a different request" << std::endl;
+                return false;
+            }
+            result.workoutId = parseIntField((*saved)[0].c_str());
+            result.recoveryId = parseIntField((*saved)[2].c_str());
+            result.nutritionIds.clear();
+            const std::string& ids = (*saved)[1];
+            for (size_t start = 0; start < ids.size();) {
+                size_t end = std::min(ids.find(',', start), ids.size());
+                result.nutritionIds.push_back(parseIntField(ids.substr(start, end - start).c_str()));
+                start = end + 1;
+            }
+            result.replayed = true;
+            std::cout << "Day already logged for key " << clientKey << ", replaying" << std::endl;
+            return true;
+        }
+    }
+
+    std::vector<LocalStore::Change> changes;
+    DayLogResult created;
+
+    if (workout) {
+        LocalStore::Row row = encodeRow(*workout);
+        if (!checkRow(WORKOUT_TABLE, row, 0, "Log Day")) return false;
+        created.workoutId = store.reserveId(WORKOUT_TABLE);
+        row[0] = formatIntField(created.workoutId);
+        changes.push_back(LocalStore::Change::putRow(WORKOUT_TABLE, created.workoutId, row));
+    }
+
+    std::string mealIds;
+    for (const Nutrition& meal : meals) {
+        int id = store.reserveId(NUTRITION_TABLE);
+        LocalStore::Row row = encodeRow(meal);
+        row[0] = formatIntField(id);
+        changes.push_back(LocalStore::Change::putRow(NUTRITION_TABLE, id, row));
+        created.nutritionIds.push_back(id);
+        mealIds += (mealIds.empty() ? "" : ",") + formatIntField(id);
+    }
+
+    if (recovery) {
+        created.recoveryId = store.reserveId(RECOVERY_TABLE);
+        LocalStore::Row row = encodeRow(*recovery);
+        row[0] = formatIntField(created.recoveryId);
+        changes.push_back(LocalStore::Change::putRow(RECOVERY_TABLE, created.recoveryId, row));
+    }
+
+    if (!clientKey.empty()) {
+        changes.push_back(LocalStore::Change::putKey(DAY_LOG_TABLE, clientKey,
+            {formatIntField(created.workoutId), mealIds, formatIntField(created.recoveryId), fingerprint}));
+    }
+
+    if (!commit(changes, "Log Day")) {
+        return false;
+    }
+
+    result = created;
+    std::cout << "Day logged successfully (" << meals.size() << " meals)" << std::endl;
+    return true;
+}
+
+bool LocalStoreDAO::createWorkouts(std::vector<Workout>& workouts) {
+    if (workouts.empty()) return true;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    std::vector<LocalStore::Change> changes;
+    std::vector<int> ids;
+    for (const Workout& workout : workouts) {
+        LocalStore::Row row = encodeRow(workout);
+        if (!checkRow(WORKOUT_TABLE, row, 0, "Create Workouts")) return false;
+        ids.push_back(store.reserveId(WORKOUT_TABLE));
+        row[0] = formatIntField(ids.back());
+        changes.push_back(LocalStore::Change::putRow(WORKOUT_TABLE, ids.back(), row));
+    }
+
+    if (!commit(changes, "Create Workouts")) {
+        return false;
+    }
+
+    for (size_t i = 0; i < workouts.size(); ++i) {
+        workouts[i].setWorkoutId(ids[i]);
+    }
+    threadInsertId = ids.front();
+    std::cout << workouts.size() << " workouts created, IDs " << ids.front() << "-" << ids.back() << std::endl;
+    return true;
+}
+
+// ==================== IDEMPOTENCY KEYS ====================
+
+bool LocalStoreDAO::readIdempotencyRecord(const std::string& key, IdempotencyRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    const LocalStore::Row* row = store.findKey(IDEMPOTENCY_TABLE, key);
+    if (!row || row->size() < 5) return false;
+
+    record.fingerprint = (*row)[0];
+    record.status = parseIntField((*row)[1].c_str());
+    record.contentType = (*row)[2];
+    record.body = (*row)[3];
+    record.createdAt = std::atoll((*row)[4].c_str());
+    return true;
+}
+
+bool LocalStoreDAO::saveIdempotencyRecord(const std::string& key, const IdempotencyRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    LocalStore::Row row{record.fingerprint, formatIntField(record.status), record.contentType,
+                        record.body, std::to_string(record.createdAt)};
+    return commit({LocalStore::Change::putKey(IDEMPOTENCY_TABLE, key, row)}, "Save Idempotency Record");
+}
+
+int LocalStoreDAO::purgeIdempotencyRecords(long long olderThan) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return 0;
+
+    std::vector<LocalStore::Change> changes;
+    for (const auto& entry : store.keys(IDEMPOTENCY_TABLE)) {
+        if (entry.second.size() < 5 || std::atoll(entry.second[4].c_str()) < olderThan) {
+            changes.push_back(LocalStore::Change::deleteKey(IDEMPOTENCY_TABLE, entry.first));
+        }
+    }
+
+    if (!commit(changes, "Purge Idempotency Records")) {
+        return 0;
+    }
+    return static_cast<int>(changes.size());
+}
+
+// ==================== UTILITY ====================
+
+bool LocalStoreDAO::testConnection() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) {
+        return false;
+    }
+    std::cout << "Local store open: " << path << " (" << store.getLogRecords() << " log records)" << std::endl;
+    return true;
+}
+
+int LocalStoreDAO::getLastInsertId() {
+    return threadInsertId;
+}
+
+bool LocalStoreDAO::readTableVersion(const std::string& table, long long& version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ready()) return false;
+
+    const std::vector<LocalStore::TableSpec>& specs = tableSpecs();
+    for (size_t t = 0; t < specs.size(); ++t) {
+        if (specs[t].name == table) {
+            version = static_cast<long long>(store.table(static_cast<int>(t)).changes);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================== BACKEND SELECTION ====================
+
+std::unique_ptr<WorkoutDAO> createWorkoutDAO(const std::string& host, const std::string& user,
+                                             const std::string& password, const std::string& database,
+                                             int port) {
+    StorageConfig config = StorageConfig::fromEnvironment();
+    if (config.local) {
+        return std::make_unique<LocalStoreDAO>(config.path, config.syncWrites);
+    }
+    return std::make_unique<WorkoutDAO>(host, user, password, database, port);
+}
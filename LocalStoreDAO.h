@@ -0,0 +1,161 @@
+// LocalStoreDAO.h
+// Workout Tracking System - WorkoutDAO backed by an embedded local store
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef LOCALSTOREDAO_H
+#define LOCALSTOREDAO_H
+
+#include "WorkoutDAO.h"
+#include "LocalStore.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstdlib>
+
+// Storage backend, chosen at startup through environment variables:
+//   WORKOUT_STORAGE        "mysql" (default) or "local"
+//   WORKOUT_LOCAL_PATH     data file of the local store (default workout_tracker.db)
+//   WORKOUT_LOCAL_FSYNC    0 = skip the fsync after each commit (default 1)
+struct StorageConfig {
+    bool local = false;
+    std::string path = "workout_tracker.db";
+    bool syncWrites = true;
+
+    static StorageConfig fromEnvironment() {
+        StorageConfig config;
+        const char* storage = std::getenv("WORKOUT_STORAGE");
+        const char* path = std::getenv("WORKOUT_LOCAL_PATH");
+        const char* fsync = std::getenv("WORKOUT_LOCAL_FSYNC");
+
+        config.local = storage && std::string(storage) == "local";
+        if (path && *path) config.path = path;
+        if (fsync) config.syncWrites = std::atoi(fsync) != 0;
+        return config;
+    }
+};
+
+/*
+ * Implements every WorkoutDAO data method on a LocalStore file instead of a
+ * MySQL server, for single-user installs that should not need a database
+ * service. Reads are served from memory; each write is one durable commit.
+ *
+ * Behaviour follows the MySQL schema: AUTO_INCREMENT ids, unique MuscleGroup
+ * and Equipment names, and deleting a muscle group clears muscle_group_id on
+ * its workouts (ON DELETE SET NULL). Lists come back in the same order as
+ * the SQL queries; each table keeps a sorted index on the column(s) those
+ * queries sort by, which also serves date lookups and range filters. Text
+ * comparisons are byte-wise; LIKE ignores ASCII case, as MySQL's default
+ * collation does.
+ *
+ * Thread-safe: one mutex serializes all calls. Only one process can have a
+ * store open at a time (others wait in the constructor).
+ */
+class LocalStoreDAO : public WorkoutDAO {
+private:
+    LocalStore store;
+    std::string path;
+    bool syncWrites;
+    std::mutex mutex;
+
+    bool ready();  // open the store if it is not open yet (caller holds mutex)
+
+    template<typename T>
+    T* readRow(int table, int id);
+    template<typename T>
+    ResultSet<T> readRows(int table, const std::vector<int>& ids);
+    template<typename T, typename Column>
+    ResultSet<T> readFiltered(int table, const QueryFilter<Column>& filter, bool descending,
+                              const std::string& operation);
+    template<typename T>
+    bool insertRow(int table, const T& entity, const std::string& operation);
+    template<typename T>
+    bool updateRow(int table, int id, const T& entity, const std::string& operation);
+    template<typename T>
+    bool deleteRow(int table, int id, const std::string& operation);
+
+    int findByName(int table, const std::string& name);
+    bool checkRow(int table, const LocalStore::Row& row, int id, const std::string& operation);
+    bool commit(const std::vector<LocalStore::Change>& changes, const std::string& operation);
+
+public:
+    explicit LocalStoreDAO(const std::string& filePath, bool sync = true);
+    ~LocalStoreDAO() override;
+
+    // Workout CRUD operations
+    bool createWorkout(const Workout& workout) override;
+    Workout* readWorkout(int workoutId) override;
+    ResultSet<Workout> readWorkoutsByIds(const std::vector<int>& workoutIds) override;
+    ResultSet<Workout> readAllWorkouts() override;
+    ResultSet<Workout> readWorkoutsByDate(const std::string& date) override;
+    ResultSet<Workout> readWorkoutsByMuscleGroup(int muscleGroupId) override;
+    ResultSet<Workout> readWorkoutsWhere(const WorkoutFilter& filter) override;
+    bool updateWorkout(const Workout& workout) override;
+    bool deleteWorkout(int workoutId) override;
+
+    // MuscleGroup CRUD operations
+    bool createMuscleGroup(const MuscleGroup& muscleGroup) override;
+    MuscleGroup* readMuscleGroup(int muscleGroupId) override;
+    ResultSet<MuscleGroup> readMuscleGroupsByIds(const std::vector<int>& muscleGroupIds) override;
+    ResultSet<MuscleGroup> readAllMuscleGroups() override;
+    MuscleGroup* readMuscleGroupByName(const std::string& name) override;
+    ResultSet<MuscleGroup> readMuscleGroupsWhere(const MuscleGroupFilter& filter) override;
+    bool updateMuscleGroup(const MuscleGroup& muscleGroup) override;
+    bool deleteMuscleGroup(int muscleGroupId) override;
+
+    // Nutrition CRUD operations
+    bool createNutrition(const Nutrition& nutrition) override;
+    Nutrition* readNutrition(int nutritionId) override;
+    ResultSet<Nutrition> readAllNutrition() override;
+    ResultSet<Nutrition> readNutritionByDate(const std::string& date) override;
+    ResultSet<Nutrition> readNutritionByFamily(const std::string& family) override;
+    ResultSet<Nutrition> readNutritionWhere(const NutritionFilter& filter) override;
+    bool updateNutrition(const Nutrition& nutrition) override;
+    bool deleteNutrition(int nutritionId) override;
+
+    // Recovery CRUD operations
+    bool createRecovery(const Recovery& recovery) override;
+    Recovery* readRecovery(int recoveryId) override;
+    ResultSet<Recovery> readAllRecovery() override;
+    ResultSet<Recovery> readRecoveryByDate(const std::string& date) override;
+    ResultSet<Recovery> readRecoveryByType(const std::string& type) override;
+    ResultSet<Recovery> readRecoveryWhere(const RecoveryFilter& filter) override;
+    bool updateRecovery(const Recovery& recovery) override;
+    bool deleteRecovery(int recoveryId) override;
+
+    // Equipment CRUD operations
+    bool createEquipment(const Equipment& equipment) override;
+    Equipment* readEquipment(int equipmentId) override;
+    ResultSet<Equipment> readAllEquipment() override;
+    ResultSet<Equipment> readEquipmentByCategory(const std::string& category) override;
+    Equipment* readEquipmentByName(const std::string& name) override;
+    ResultSet<Equipment> readEquipmentWhere(const EquipmentFilter& filter) override;
+    bool updateEquipment(const Equipment& equipment) override;
+    bool deleteEquipment(int equipmentId) override;
+
+    // Training day and batch insert: each is a single commit
+    bool logDay(const std::string& clientKey, const std::string& fingerprint, const Workout* workout,
+                const std::vector<Nutrition>& meals, const Recovery* recovery,
+                DayLogResult& result) override;
+    bool createWorkouts(std::vector<Workout>& workouts) override;
+
+    // Idempotency keys
+    bool readIdempotencyRecord(const std::string& key, IdempotencyRecord& record) override;
+    bool saveIdempotencyRecord(const std::string& key, const IdempotencyRecord& record) override;
+    int purgeIdempotencyRecords(long long olderThan) override;
+
+    // Utility methods
+    bool testConnection() override;
+    int getLastInsertId() override;
+    bool readTableVersion(const std::string& table, long long& version) override;
+
+    const std::string& getPath() const { return path; }
+};
+
+// Build the DAO selected by StorageConfig::fromEnvironment(): a LocalStoreDAO
+// for WORKOUT_STORAGE=local, otherwise a MySQL WorkoutDAO with these settings
+std::unique_ptr<WorkoutDAO> createWorkoutDAO(const std::string& host, const std::string& user,
+                                             const std::string& password, const std::string& database,
+                                             int port = 3306);
+
+#endif // LOCALSTOREDAO_H
@@ -0,0 +1,233 @@
+// QueryFilter.h
+// Workout Tracking System - Typed filter builder for DAO queries
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef QUERYFILTER_H
+#define QUERYFILTER_H
+
+#include <string>
+#include <vector>
+#include <cmath>
+
+/*
+ * A QueryFilter collects WHERE conditions over one entity's columns and
+ * compiles them to SQL with '?' placeholders plus a list of typed values.
+ * Columns are enums, so callers can never splice arbitrary text into the
+ * statement; values are bound by WorkoutDAO (numbers printed as INT or DOUBLE
+ * literals, text escaped). Non-finite doubles make the filter invalid.
+ *
+ *   WorkoutFilter filter;
+ *   filter.where(WorkoutColumn::DATE, CompareOp::GE, "2026-01-01")
+ *         .where(WorkoutColumn::RPE, CompareOp::GE, 8);
+ *   ResultSet<Workout> hard = dao.readWorkoutsWhere(filter);
+ */
+
+// Filterable columns per entity
+enum class WorkoutColumn { ID, DATE, TIME, DURATION, TYPE, CALORIES, RPE, MUSCLE_GROUP };
+enum class MuscleGroupColumn { ID, NAME, DAYS_PER_WEEK, SETS, REPS, WEIGHT };
+enum class NutritionColumn { ID, FAMILY, WATER, CARBS, FAT, PROTEIN, SUGAR, DATE };
+enum class RecoveryColumn { ID, DATE, DURATION, TYPE };
+enum class EquipmentColumn { ID, NAME, CATEGORY, TARGET };
+
+enum class CompareOp { EQ, NE, LT, LE, GT, GE, LIKE };
+
+// A single bound value
+struct SqlParam {
+    enum class Kind { INT, DOUBLE, TEXT };
+
+    Kind kind;
+    long long intValue;
+    double doubleValue;
+    std::string textValue;
+
+    static SqlParam fromInt(long long v) { return SqlParam{Kind::INT, v, 0.0, ""}; }
+    static SqlParam fromDouble(double v) { return SqlParam{Kind::DOUBLE, 0, v, ""}; }
+    static SqlParam fromText(const std::string& v) { return SqlParam{Kind::TEXT, 0, 0.0, v}; }
+};
+
+// Column metadata: SQL name and the value kind it accepts
+struct ColumnInfo {
+    const char* name;
+    SqlParam::Kind kind;
+};
+
+inline ColumnInfo columnInfo(WorkoutColumn column) {
+    switch (column) {
+        case WorkoutColumn::ID:           return {"workout_id", SqlParam::Kind::INT};
+        case WorkoutColumn::DATE:         return {"workout_date", SqlParam::Kind::TEXT};
+        case WorkoutColumn::TIME:         return {"workout_time", SqlParam::Kind::TEXT};
+        case WorkoutColumn::DURATION:     return {"duration", SqlParam::Kind::INT};
+        case WorkoutColumn::TYPE:         return {"type_description", SqlParam::Kind::TEXT};
+        case WorkoutColumn::CALORIES:     return {"calories_burned", SqlParam::Kind::DOUBLE};
+        case WorkoutColumn::RPE:          return {"rate_perceived_exhaustion", SqlParam::Kind::INT};
+        default:                          return {"muscle_group_id", SqlParam::Kind::INT};
+    }
+}
+
+inline ColumnInfo columnInfo(MuscleGroupColumn column) {
+    switch (column) {
+        case MuscleGroupColumn::ID:            return {"muscle_group_id", SqlParam::Kind::INT};
+        case MuscleGroupColumn::NAME:          return {"name", SqlParam::Kind::TEXT};
+        case MuscleGroupColumn::DAYS_PER_WEEK: return {"days_per_week", SqlParam::Kind::INT};
+        case MuscleGroupColumn::SETS:          return {"sets", SqlParam::Kind::INT};
+        case MuscleGroupColumn::REPS:          return {"reps", SqlParam::Kind::INT};
+        default:                               return {"weight_amount", SqlParam::Kind::DOUBLE};
+    }
+}
+
+inline ColumnInfo columnInfo(NutritionColumn column) {
+    switch (column) {
+        case NutritionColumn::ID:      return {"nutrition_id", SqlParam::Kind::INT};
+        case NutritionColumn::FAMILY:  return {"family", SqlParam::Kind::TEXT};
+        case NutritionColumn::WATER:   return {"water", SqlParam::Kind::DOUBLE};
+        case NutritionColumn::CARBS:   return {"carbs", SqlParam::Kind::DOUBLE};
+        case NutritionColumn::FAT:     return {"fat", SqlParam::Kind::DOUBLE};
+        case NutritionColumn::PROTEIN: return {"protein", SqlParam::Kind::DOUBLE};
+        case NutritionColumn::SUGAR:   return {"sugar", SqlParam::Kind::DOUBLE};
+        default:                       return {"meal_date", SqlParam::Kind::TEXT};
+    }
+}
+
+inline ColumnInfo columnInfo(RecoveryColumn column) {
+    switch (column) {
+        case RecoveryColumn::ID:       return {"recovery_id", SqlParam::Kind::INT};
+        case RecoveryColumn::DATE:     return {"recovery_date", SqlParam::Kind::TEXT};
+        case RecoveryColumn::DURATION: return {"duration", SqlParam::Kind::INT};
+        default:                       return {"type", SqlParam::Kind::TEXT};
+    }
+}
+
+inline ColumnInfo columnInfo(EquipmentColumn column) {
+    switch (column) {
+        case EquipmentColumn::ID:       return {"equipment_id", SqlParam::Kind::INT};
+        case EquipmentColumn::NAME:     return {"name", SqlParam::Kind::TEXT};
+        case EquipmentColumn::CATEGORY: return {"category", SqlParam::Kind::TEXT};
+        default:                        return {"target", SqlParam::Kind::TEXT};
+    }
+}
+
+template<typename Column>
+class QueryFilter {
+public:
+    // One condition in structured form, for backends that do not speak SQL
+    struct Condition {
+        Column column;
+        CompareOp op;
+        SqlParam value;
+    };
+
+private:
+    std::vector<std::string> conditions;
+    std::vector<SqlParam> params;
+    std::vector<Condition> terms;
+    std::string orderColumn;
+    Column orderKey{};
+    bool orderDescending = false;
+    int rowLimit = 0;
+    std::string error;
+
+    static const char* opText(CompareOp op) {
+        switch (op) {
+            case CompareOp::EQ: return " = ?";
+            case CompareOp::NE: return " <> ?";
+            case CompareOp::LT: return " < ?";
+            case CompareOp::LE: return " <= ?";
+            case CompareOp::GT: return " > ?";
+            case CompareOp::GE: return " >= ?";
+            default:            return " LIKE ?";
+        }
+    }
+
+    QueryFilter& add(Column column, CompareOp op, const SqlParam& value) {
+        ColumnInfo info = columnInfo(column);
+
+        // Integers widen to DOUBLE columns; anything else must match exactly
+        bool compatible = info.kind == value.kind ||
+                          (info.kind == SqlParam::Kind::DOUBLE && value.kind == SqlParam::Kind::INT);
+        // NaN and infinity have no SQL literal and compare false against every row
+        bool finite = value.kind != SqlParam::Kind::DOUBLE || std::isfinite(value.doubleValue);
+        if (!compatible || !finite || (op == CompareOp::LIKE && info.kind != SqlParam::Kind::TEXT)) {
+            error = std::string("Invalid value for column ") + info.name;
+            return *this;
+        }
+
+        conditions.push_back(std::string(info.name) + opText(op));
+        params.push_back(value);
+        terms.push_back(Condition{column, op, value});
+        return *this;
+    }
+
+public:
+    QueryFilter& where(Column column, CompareOp op, int value) {
+        return add(column, op, SqlParam::fromInt(value));
+    }
+
+    QueryFilter& where(Column column, CompareOp op, double value) {
+        return add(column, op, SqlParam::fromDouble(value));
+    }
+
+    QueryFilter& where(Column column, CompareOp op, const std::string& value) {
+        return add(column, op, SqlParam::fromText(value));
+    }
+
+    QueryFilter& where(Column column, CompareOp op, const char* value) {
+        return add(column, op, SqlParam::fromText(value));
+    }
+
+    // Inclusive range: lower <= column <= upper
+    template<typename T>
+    QueryFilter& between(Column column, const T& lower, const T& upper) {
+        where(column, CompareOp::GE, lower);
+        return where(column, CompareOp::LE, upper);
+    }
+
+    QueryFilter& orderBy(Column column, bool descending = false) {
+        orderColumn = columnInfo(column).name;
+        orderKey = column;
+        orderDescending = descending;
+        return *this;
+    }
+
+    QueryFilter& limit(int rows) {
+        rowLimit = rows > 0 ? rows : 0;
+        return *this;
+    }
+
+    bool isValid() const { return error.empty(); }
+    const std::string& getError() const { return error; }
+    // True when the filter would not change a plain "read all"
+    bool isEmpty() const { return conditions.empty() && orderColumn.empty() && rowLimit == 0; }
+    const std::vector<SqlParam>& getParams() const { return params; }
+    const std::vector<Condition>& getConditions() const { return terms; }
+    bool hasOrder() const { return !orderColumn.empty(); }
+    Column getOrderColumn() const { return orderKey; }
+    bool isOrderDescending() const { return orderDescending; }
+    int getLimit() const { return rowLimit; }
+
+    // " WHERE a >= ? AND b = ? ORDER BY c DESC LIMIT n" (empty parts omitted).
+    // defaultOrder is used when no orderBy() was given.
+    std::string toSql(const std::string& defaultOrder = "") const {
+        std::string sql;
+        for (size_t i = 0; i < conditions.size(); ++i) {
+            sql += (i == 0 ? " WHERE " : " AND ") + conditions[i];
+        }
+        if (!orderColumn.empty()) {
+            sql += " ORDER BY " + orderColumn + (orderDescending ? " DESC" : " ASC");
+        } else if (!defaultOrder.empty()) {
+            sql += " ORDER BY " + defaultOrder;
+        }
+        if (rowLimit > 0) {
+            sql += " LIMIT " + std::to_string(rowLimit);
+        }
+        return sql;
+    }
+};
+
+typedef QueryFilter<WorkoutColumn> WorkoutFilter;
+typedef QueryFilter<MuscleGroupColumn> MuscleGroupFilter;
+typedef QueryFilter<NutritionColumn> NutritionFilter;
+typedef QueryFilter<RecoveryColumn> RecoveryFilter;
+typedef QueryFilter<EquipmentColumn> EquipmentFilter;
+
+#endif // QUERYFILTER_H
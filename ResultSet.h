@@ -0,0 +1,72 @@
+// ResultSet.h
+// Workout Tracking System - Owning, contiguous container for query results
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef RESULTSET_H
+#define RESULTSET_H
+
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+/*
+ * A ResultSet<T> holds the rows of one query by value in a single contiguous
+ * buffer. It is move-only: returning one from the DAO hands over the buffer
+ * without copying, and everything is released when it goes out of scope, so
+ * there is nothing for callers to delete.
+ *
+ *   ResultSet<Workout> workouts = dao.readAllWorkouts();
+ *   for (const Workout& w : workouts) { ... }
+ */
+template<typename T>
+class ResultSet {
+private:
+    std::vector<T> rows;
+
+public:
+    typedef typename std::vector<T>::iterator iterator;
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    ResultSet() = default;
+    ResultSet(ResultSet&&) = default;
+    ResultSet& operator=(ResultSet&&) = default;
+    ResultSet(const ResultSet&) = delete;
+    ResultSet& operator=(const ResultSet&) = delete;
+
+    void reserve(size_t count) { rows.reserve(count); }
+
+    // Append a default-constructed row and return it for filling in
+    T& add() {
+        rows.emplace_back();
+        return rows.back();
+    }
+
+    void add(T&& row) { rows.push_back(std::move(row)); }
+
+    // Drop rows that fail a predicate, keeping the order of the rest
+    template<typename Predicate>
+    void keepIf(Predicate keep) {
+        size_t kept = 0;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (keep(static_cast<const T&>(rows[i]))) {
+                if (kept != i) rows[kept] = std::move(rows[i]);
+                ++kept;
+            }
+        }
+        rows.erase(rows.begin() + kept, rows.end());
+    }
+
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+
+    T& operator[](size_t index) { return rows[index]; }
+    const T& operator[](size_t index) const { return rows[index]; }
+
+    iterator begin() { return rows.begin(); }
+    iterator end() { return rows.end(); }
+    const_iterator begin() const { return rows.begin(); }
+    const_iterator end() const { return rows.end(); }
+};
+
+#endif // RESULTSET_H
@@ -0,0 +1,219 @@
+// RowMapping.h
+// Workout Tracking System - Column descriptors and row decoding for DAO reads
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef ROWMAPPING_H
+#define ROWMAPPING_H
+
+#include "Workout.h"
+#include "MuscleGroup.h"
+#include "Nutrition.h"
+#include "Recovery.h"
+#include "Equipment.h"
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*
+ * Each entity has a RowMapping<T> specialization listing the columns the DAO
+ * reads, in SELECT order, together with the setter that stores each one
+ * and the getter that formats it back to text (used by LocalStoreDAO).
+ * The same table drives both the column list and the decoder, so a query
+ * can never fetch columns in a different order than they are parsed:
+ *
+ *   std::string sql = selectFrom<Workout>() + " WHERE workout_id = 7";
+ *   ...
+ *   Workout workout;
+ *   decodeRow(row, workout);
+ *
+ * Numbers are parsed with std::from_chars: no exceptions, no locale.
+ * A NULL or malformed number leaves the field at 0.
+ */
+
+// Parse helpers: fall back to 0 when the value is NULL or not a number
+inline int parseIntField(const char* value) {
+    int result = 0;
+    if (value) std::from_chars(value, value + std::strlen(value), result);
+    return result;
+}
+
+inline double parseDoubleField(const char* value) {
+    double result = 0.0;
+    if (value) std::from_chars(value, value + std::strlen(value), result);
+    return result;
+}
+
+inline const char* textField(const char* value) {
+    return value ? value : "";
+}
+
+// Format helpers: the text form a column would have in a result row
+inline std::string formatIntField(int value) {
+    return std::to_string(value);
+}
+
+inline std::string formatDoubleField(double value) {
+    char buffer[32];
+    auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    return std::string(buffer, end);
+}
+
+// One selected column, how to store it on T and how to read it back
+template<typename T>
+struct FieldMapping {
+    const char* column;
+    void (*apply)(T&, const char*);
+    std::string (*read)(const T&);
+};
+
+template<typename T>
+struct RowMapping;
+
+template<>
+struct RowMapping<Workout> {
+    static constexpr const char* table = "Workout";
+    static constexpr FieldMapping<Workout> fields[] = {
+        {"workout_id", [](Workout& w, const char* v) { w.setWorkoutId(parseIntField(v)); },
+         [](const Workout& w) { return formatIntField(w.getWorkoutId()); }},
+        {"workout_date", [](Workout& w, const char* v) { w.setWorkoutDate(textField(v)); },
+         [](const Workout& w) { return w.getWorkoutDate(); }},
+        {"workout_time", [](Workout& w, const char* v) { w.setWorkoutTime(textField(v)); },
+         [](const Workout& w) { return w.getWorkoutTime(); }},
+        {"duration", [](Workout& w, const char* v) { w.setDuration(parseIntField(v)); },
+         [](const Workout& w) { return formatIntField(w.getDuration()); }},
+        {"type_description", [](Workout& w, const char* v) { w.setTypeDescription(textField(v)); },
+         [](const Workout& w) { return w.getTypeDescription(); }},
+        {"calories_burned", [](Workout& w, const char* v) { w.setCaloriesBurned(parseDoubleField(v)); },
+         [](const Workout& w) { return formatDoubleField(w.getCaloriesBurned()); }},
+        {"rate_perceived_exhaustion", [](Workout& w, const char* v) { w.setRatePerceivedExhaustion(parseIntField(v)); },
+         [](const Workout& w) { return formatIntField(w.getRatePerceivedExhaustion()); }},
+        {"muscle_group_id", [](Workout& w, const char* v) { w.setMuscleGroupId(parseIntField(v)); },
+         [](const Workout& w) { return formatIntField(w.getMuscleGroupId()); }},
+    };
+};
+
+template<>
+struct RowMapping<MuscleGroup> {
+    static constexpr const char* table = "MuscleGroup";
+    static constexpr FieldMapping<MuscleGroup> fields[] = {
+        {"muscle_group_id", [](MuscleGroup& m, const char* v) { m.setMuscleGroupId(parseIntField(v)); },
+         [](const MuscleGroup& m) { return formatIntField(m.getMuscleGroupId()); }},
+        {"name", [](MuscleGroup& m, const char* v) { m.setName(textField(v)); },
+         [](const MuscleGroup& m) { return m.getName(); }},
+        {"description", [](MuscleGroup& m, const char* v) { m.setDescription(textField(v)); },
+         [](const MuscleGroup& m) { return m.getDescription(); }},
+        {"days_per_week", [](MuscleGroup& m, const char* v) { m.setDaysPerWeek(parseIntField(v)); },
+         [](const MuscleGroup& m) { return formatIntField(m.getDaysPerWeek()); }},
+        {"sets", [](MuscleGroup& m, const char* v) { m.setSets(parseIntField(v)); },
+         [](const MuscleGroup& m) { return formatIntField(m.getSets()); }},
+        {"reps", [](MuscleGroup& m, const char* v) { m.setReps(parseIntField(v)); },
+         [](const MuscleGroup& m) { return formatIntField(m.getReps()); }},
+        {"weight_amount", [](MuscleGroup& m, const char* v) { m.setWeightAmount(parseDoubleField(v)); },
+         [](const MuscleGroup& m) { return formatDoubleField(m.getWeightAmount()); }},
+    };
+};
+
+template<>
+struct RowMapping<Nutrition> {
+    static constexpr const char* table = "Nutrition";
+    static constexpr FieldMapping<Nutrition> fields[] = {
+        {"nutrition_id", [](Nutrition& n, const char* v) { n.setNutritionId(parseIntField(v)); },
+         [](const Nutrition& n) { return formatIntField(n.getNutritionId()); }},
+        {"family", [](Nutrition& n, const char* v) { n.setFamilyFromString(textField(v)); },
+         [](const Nutrition& n) { return n.getFamilyString(); }},
+        {"water", [](Nutrition& n, const char* v) { n.setWater(parseDoubleField(v)); },
+         [](const Nutrition& n) { return formatDoubleField(n.getWater()); }},
+        {"carbs", [](Nutrition& n, const char* v) { n.setCarbs(parseDoubleField(v)); },
+         [](const Nutrition& n) { return formatDoubleField(n.getCarbs()); }},
+        {"fat", [](Nutrition& n, const char* v) { n.setFat(parseDoubleField(v)); },
+         [](const Nutrition& n) { return formatDoubleField(n.getFat()); }},
+        {"protein", [](Nutrition& n, const char* v) { n.setProtein(parseDoubleField(v)); },
+         [](const Nutrition& n) { return formatDoubleField(n.getProtein()); }},
+        {"sugar", [](Nutrition& n, const char* v) { n.setSugar(parseDoubleField(v)); },
+         [](const Nutrition& n) { return formatDoubleField(n.getSugar()); }},
+        {"meal_date", [](Nutrition& n, const char* v) { n.setMealDate(textField(v)); },
+         [](const Nutrition& n) { return n.getMealDate(); }},
+    };
+};
+
+template<>
+struct RowMapping<Recovery> {
+    static constexpr const char* table = "Recovery";
+    static constexpr FieldMapping<Recovery> fields[] = {
+        {"recovery_id", [](Recovery& r, const char* v) { r.setRecoveryId(parseIntField(v)); },
+         [](const Recovery& r) { return formatIntField(r.getRecoveryId()); }},
+        {"recovery_date", [](Recovery& r, const char* v) { r.setRecoveryDate(textField(v)); },
+         [](const Recovery& r) { return r.getRecoveryDate(); }},
+        {"duration", [](Recovery& r, const char* v) { r.setDuration(parseIntField(v)); },
+         [](const Recovery& r) { return formatIntField(r.getDuration()); }},
+        {"type", [](Recovery& r, const char* v) { r.setType(textField(v)); },
+         [](const Recovery& r) { return r.getType(); }},
+        {"helpers", [](Recovery& r, const char* v) { r.setHelpers(textField(v)); },
+         [](const Recovery& r) { return r.getHelpers(); }},
+    };
+};
+
+template<>
+struct RowMapping<Equipment> {
+    static constexpr const char* table = "Equipment";
+    static constexpr FieldMapping<Equipment> fields[] = {
+        {"equipment_id", [](Equipment& e, const char* v) { e.setEquipmentId(parseIntField(v)); },
+         [](const Equipment& e) { return formatIntField(e.getEquipmentId()); }},
+        {"name", [](Equipment& e, const char* v) { e.setName(textField(v)); },
+         [](const Equipment& e) { return e.getName(); }},
+        {"description", [](Equipment& e, const char* v) { e.setDescription(textField(v)); },
+         [](const Equipment& e) { return e.getDescription(); }},
+        {"category", [](Equipment& e, const char* v) { e.setCategory(textField(v)); },
+         [](const Equipment& e) { return e.getCategory(); }},
+        {"target", [](Equipment& e, const char* v) { e.setTarget(textField(v)); },
+         [](const Equipment& e) { return e.getTarget(); }},
+    };
+};
+
+// "SELECT a, b, c FROM Table" for an entity, built once
+template<typename T>
+const std::string& selectFrom() {
+    static const std::string sql = [] {
+        std::string columns;
+        for (const FieldMapping<T>& field : RowMapping<T>::fields) {
+            if (!columns.empty()) columns += ", ";
+            columns += field.column;
+        }
+        return "SELECT " + columns + " FROM " + RowMapping<T>::table;
+    }();
+    return sql;
+}
+
+// Fill a T from a row selected with selectFrom<T>()
+template<typename T>
+void decodeRow(const char* const* row, T& entity) {
+    size_t index = 0;
+    for (const FieldMapping<T>& field : RowMapping<T>::fields) {
+        field.apply(entity, row[index++]);
+    }
+}
+
+// The inverse of decodeRow: one text value per column, in SELECT order
+template<typename T>
+std::vector<std::string> encodeRow(const T& entity) {
+    std::vector<std::string> row;
+    for (const FieldMapping<T>& field : RowMapping<T>::fields) {
+        row.push_back(field.read(entity));
+    }
+    return row;
+}
+
+// Position of a column in RowMapping<T>::fields, or -1
+template<typename T>
+int fieldIndex(const char* column) {
+    int index = 0;
+    for (const FieldMapping<T>& field : RowMapping<T>::fields) {
+        if (std::strcmp(field.column, column) == 0) return index;
+        ++index;
+    }
+    return -1;
+}
+
+#endif // ROWMAPPING_H
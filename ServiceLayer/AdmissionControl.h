@@ -0,0 +1,187 @@
+// AdmissionControl.h
+// Adaptive concurrency limits and load shedding for the REST API
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef ADMISSIONCONTROL_H
+#define ADMISSIONCONTROL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+// Settings, overridable through environment variables:
+//   WORKOUT_ADMISSION            set to 0 to admit every request (default on)
+//   WORKOUT_ADMISSION_TARGET_MS  latency a class may reach before it backs off (default 100);
+//                                a class whose unloaded latency is higher uses twice that instead
+//   WORKOUT_ADMISSION_MAX        upper bound for any class's concurrency limit (default 64)
+struct AdmissionConfig {
+    bool enabled = true;
+    double targetMs = 100.0;
+    int maxLimit = 64;
+
+    static AdmissionConfig fromEnvironment() {
+        AdmissionConfig config;
+        const char* enabled = std::getenv("WORKOUT_ADMISSION");
+        const char* target = std::getenv("WORKOUT_ADMISSION_TARGET_MS");
+        const char* maxLimit = std::getenv("WORKOUT_ADMISSION_MAX");
+
+        if (enabled && std::string(enabled) == "0") config.enabled = false;
+        if (target && std::atof(target) > 0) config.targetMs = std::atof(target);
+        if (maxLimit && std::atoi(maxLimit) > 0) config.maxLimit = std::atoi(maxLimit);
+        return config;
+    }
+};
+
+// Requests are limited separately by what they cost and how much they matter
+enum class RouteClass {
+    READ,    // one record, ticket status
+    LIST,    // whole collections (bulk reads, shed first)
+    WRITE    // POST / PUT / DELETE
+};
+
+/*
+ * One concurrency limit, adjusted AIMD-style from the latency of the
+ * requests it admits:
+ *
+ *   - a request slower than the threshold cuts the limit by 10%, at most
+ *     once per threshold interval (so one slow burst is one decrease)
+ *   - a fast request while at least half the limit is in use adds 1/limit,
+ *     i.e. about +1 per round of requests
+ *
+ * The threshold is the configured target, or twice the class's baseline
+ * latency when that is higher: the baseline follows the fastest recent
+ * requests, so an endpoint that is always slow is not mistaken for an
+ * overloaded one, while queueing (latency growing against the baseline)
+ * still is.
+ */
+class AdaptiveLimit {
+    mutable std::mutex mutex;
+    double limit;
+    double minLimit;
+    double maxLimit;
+    int inFlight = 0;
+    double baselineMs = 0.0;   // 0 until the first sample
+    std::chrono::steady_clock::time_point lastDecrease;
+    uint64_t admitted = 0;
+    uint64_t rejected = 0;
+
+    void decrease(std::chrono::steady_clock::time_point now) {
+        limit = std::max(minLimit, limit * 0.9);
+        lastDecrease = now;
+    }
+
+public:
+    AdaptiveLimit(double initial = 8, double minimum = 1, double maximum = 64)
+        : limit(initial), minLimit(minimum), maxLimit(maximum) {}
+
+    void configure(double initial, double minimum, double maximum) {
+        std::lock_guard<std::mutex> lock(mutex);
+        minLimit = minimum;
+        maxLimit = std::max(minimum, maximum);
+        limit = std::min(std::max(initial, minLimit), maxLimit);
+    }
+
+    bool tryAcquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (inFlight >= static_cast<int>(limit)) {
+            ++rejected;
+            return false;
+        }
+        ++inFlight;
+        ++admitted;
+        return true;
+    }
+
+    void release(double latencyMs, double targetMs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool wasBusy = inFlight * 2 >= static_cast<int>(limit);
+        --inFlight;
+
+        // Baseline drops to any faster sample and creeps up slowly otherwise
+        baselineMs = baselineMs == 0.0 || latencyMs < baselineMs
+            ? latencyMs : baselineMs + (latencyMs - baselineMs) / 256.0;
+
+        double thresholdMs = std::max(targetMs, 2.0 * baselineMs);
+        auto now = std::chrono::steady_clock::now();
+        if (latencyMs > thresholdMs) {
+            if (now - lastDecrease >= std::chrono::duration<double, std::milli>(thresholdMs)) {
+                decrease(now);
+            }
+        } else if (wasBusy) {
+            limit = std::min(maxLimit, limit + 1.0 / limit);
+        }
+    }
+
+    // Give up capacity now, on behalf of a more important class
+    void yield() {
+        std::lock_guard<std::mutex> lock(mutex);
+        decrease(std::chrono::steady_clock::now());
+    }
+
+    std::string toJson() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return "{\"limit\":" + std::to_string(static_cast<int>(limit)) +
+               ",\"inFlight\":" + std::to_string(inFlight) +
+               ",\"admitted\":" + std::to_string(admitted) +
+               ",\"rejected\":" + std::to_string(rejected) +
+               ",\"baselineMs\":" + std::to_string(static_cast<int>(baselineMs)) + "}";
+    }
+};
+
+/*
+ * Per-class limits for the REST server. Callers admit() before doing any
+ * work and answer 503 with Retry-After straight away when it says no, so
+ * an overloaded server sheds the excess in microseconds instead of queueing
+ * it until clients time out and retry.
+ *
+ * Writes are preferred over bulk lists: they keep a higher floor, and a
+ * write that is turned away makes the list class yield capacity at once.
+ */
+class AdmissionController {
+    AdmissionConfig config;
+    AdaptiveLimit limits[3];
+
+    AdaptiveLimit& limitFor(RouteClass routeClass) {
+        return limits[static_cast<int>(routeClass)];
+    }
+
+public:
+    void configure(const AdmissionConfig& settings) {
+        config = settings;
+        double top = settings.maxLimit;
+        limitFor(RouteClass::READ).configure(16, 2, top);
+        limitFor(RouteClass::LIST).configure(8, 1, top);
+        limitFor(RouteClass::WRITE).configure(8, 4, top);
+    }
+
+    bool isEnabled() const {
+        return config.enabled;
+    }
+
+    bool admit(RouteClass routeClass) {
+        if (!config.enabled) return true;
+        if (limitFor(routeClass).tryAcquire()) return true;
+        if (routeClass == RouteClass::WRITE) {
+            limitFor(RouteClass::LIST).yield();
+        }
+        return false;
+    }
+
+    // Report how long an admitted request took
+    void complete(RouteClass routeClass, double latencyMs) {
+        if (!config.enabled) return;
+        limitFor(routeClass).release(latencyMs, config.targetMs);
+    }
+
+    std::string toJson() const {
+        return "{\"reads\":" + limits[static_cast<int>(RouteClass::READ)].toJson() +
+               ",\"lists\":" + limits[static_cast<int>(RouteClass::LIST)].toJson() +
+               ",\"writes\":" + limits[static_cast<int>(RouteClass::WRITE)].toJson() + "}";
+    }
+};
+
+#endif // ADMISSIONCONTROL_H
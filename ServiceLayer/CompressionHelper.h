@@ -0,0 +1,257 @@
+// CompressionHelper.h
+// Response compression utilities (gzip/deflate) for the REST API and CGI
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef COMPRESSIONHELPER_H
+#define COMPRESSIONHELPER_H
+
+#include <zlib.h>
+#include <algorithm>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include <cstdlib>
+#include <cctype>
+
+// Content codings we can produce, in order of preference
+enum class ContentEncoding {
+    IDENTITY,
+    GZIP,
+    DEFLATE
+};
+
+// Compression settings, overridable through environment variables:
+//   WORKOUT_COMPRESSION_LEVEL      zlib level 1-9 (default 6)
+//   WORKOUT_COMPRESSION_MIN_BYTES  bodies smaller than this go out as-is (default 1024, at least 1)
+//   WORKOUT_COMPRESSION_DISABLED   set to 1 to turn compression off
+struct CompressionConfig {
+    bool enabled;
+    int level;
+    size_t minBytes;
+
+    CompressionConfig(bool e = true, int l = 6, size_t m = 1024)
+        : enabled(e), level(l), minBytes(m) {}
+
+    static CompressionConfig fromEnvironment() {
+        CompressionConfig config;
+        const char* level = std::getenv("WORKOUT_COMPRESSION_LEVEL");
+        const char* minBytes = std::getenv("WORKOUT_COMPRESSION_MIN_BYTES");
+        const char* disabled = std::getenv("WORKOUT_COMPRESSION_DISABLED");
+
+        if (level) {
+            int parsed = std::atoi(level);
+            if (parsed >= 1 && parsed <= 9) config.level = parsed;
+        }
+        if (minBytes) {
+            long parsed = std::atol(minBytes);
+            if (parsed >= 1) config.minBytes = static_cast<size_t>(parsed);
+        }
+        if (disabled && std::string(disabled) == "1") {
+            config.enabled = false;
+        }
+        return config;
+    }
+};
+
+class CompressionHelper {
+public:
+    // Pick an encoding from an Accept-Encoding header value. The coding with
+    // the highest q-value wins, wherever it appears in the header; "*" covers
+    // the codings not listed by name, and q=0 refuses a coding. Ties go to
+    // gzip, then deflate, then identity. Identity stays acceptable unless
+    // refused, but below any coding the client named.
+    static ContentEncoding negotiate(const std::string& acceptEncoding) {
+        // -1: not listed
+        double gzip = -1.0;
+        double deflate = -1.0;
+        double identity = -1.0;
+        double any = -1.0;
+
+        size_t start = 0;
+        while (start < acceptEncoding.size()) {
+            size_t end = acceptEncoding.find(',', start);
+            if (end == std::string::npos) end = acceptEncoding.size();
+
+            std::string token = acceptEncoding.substr(start, end - start);
+            start = end + 1;
+
+            // Split "coding;q=value"
+            std::string coding = token;
+            double q = 1.0;
+            size_t semi = token.find(';');
+            if (semi != std::string::npos) {
+                coding = token.substr(0, semi);
+                q = qValue(token.substr(semi + 1));
+            }
+            coding = trimLower(coding);
+
+            if (coding == "gzip" || coding == "x-gzip") gzip = std::max(gzip, q);
+            else if (coding == "deflate") deflate = q;
+            else if (coding == "identity") identity = q;
+            else if (coding == "*") any = q;
+        }
+
+        if (gzip < 0.0) gzip = any < 0.0 ? 0.0 : any;
+        if (deflate < 0.0) deflate = any < 0.0 ? 0.0 : any;
+        if (identity < 0.0) identity = any < 0.0 ? 0.001 : any;
+
+        if (gzip > 0.0 && gzip >= deflate && gzip >= identity) return ContentEncoding::GZIP;
+        if (deflate > 0.0 && deflate >= identity) return ContentEncoding::DEFLATE;
+        return ContentEncoding::IDENTITY;
+    }
+
+    // Header token for an encoding ("" for identity)
+    static std::string encodingName(ContentEncoding encoding) {
+        switch (encoding) {
+            case ContentEncoding::GZIP:    return "gzip";
+            case ContentEncoding::DEFLATE: return "deflate";
+            default:                       return "";
+        }
+    }
+
+    // Compress a buffer. Returns false (leaving out untouched) on zlib failure.
+    static bool compress(const std::string& in, ContentEncoding encoding, int level, std::string& out) {
+        if (encoding == ContentEncoding::IDENTITY) return false;
+
+        z_stream stream{};
+        // 15 = 32K window; +16 selects the gzip wrapper instead of zlib
+        int windowBits = (encoding == ContentEncoding::GZIP) ? 15 + 16 : 15;
+        if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+
+        std::string buffer;
+        buffer.resize(deflateBound(&stream, static_cast<uLong>(in.size())));
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+        stream.avail_in = static_cast<uInt>(in.size());
+        stream.next_out = reinterpret_cast<Bytef*>(&buffer[0]);
+        stream.avail_out = static_cast<uInt>(buffer.size());
+
+        int rc = deflate(&stream, Z_FINISH);
+        size_t written = buffer.size() - stream.avail_out;
+        deflateEnd(&stream);
+
+        if (rc != Z_STREAM_END) return false;
+
+        buffer.resize(written);
+        out.swap(buffer);
+        return true;
+    }
+
+    // True when a body of this size and content type is worth compressing.
+    // Never for an empty body, nor for text/event-stream: a stream is written
+    // chunk by chunk after this decision, so its body here is empty and a
+    // Content-Encoding header would describe bytes that are never encoded.
+    static bool shouldCompress(const CompressionConfig& config, size_t size, const std::string& contentType) {
+        if (!config.enabled || size == 0 || size < config.minBytes) return false;
+        if (contentType.compare(0, 17, "text/event-stream") == 0) return false;
+        return contentType.compare(0, 5, "text/") == 0 ||
+               contentType.find("json") != std::string::npos ||
+               contentType.find("javascript") != std::string::npos ||
+               contentType.find("xml") != std::string::npos;
+    }
+
+private:
+    // q from the parameters after a coding ("q=0.5", "level=1;q=0"); 1 when absent
+    static double qValue(const std::string& params) {
+        size_t start = 0;
+        while (start < params.size()) {
+            size_t end = params.find(';', start);
+            if (end == std::string::npos) end = params.size();
+            std::string param = trimLower(params.substr(start, end - start));
+            start = end + 1;
+
+            if (param.compare(0, 2, "q=") == 0) {
+                double q = std::atof(param.c_str() + 2);
+                return q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+            }
+        }
+        return 1.0;
+    }
+
+    static std::string trimLower(const std::string& str) {
+        size_t first = str.find_first_not_of(" \t");
+        if (first == std::string::npos) return "";
+        size_t last = str.find_last_not_of(" \t");
+
+        std::string result = str.substr(first, last - first + 1);
+        for (char& c : result) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return result;
+    }
+};
+
+// Small LRU of already-compressed bodies for reference data such as
+// /api/musclegroups and /api/equipment. An entry is only reused while the
+// freshly produced body is byte-identical to the one it was built from, so a
+// stale entry can never be served; writes to a path also drop it eagerly.
+class CompressedCache {
+private:
+    struct Entry {
+        std::string raw;
+        std::string compressed;
+    };
+
+    size_t capacity;
+    std::list<std::string> order;  // most recently used at the front
+    std::map<std::string, std::pair<Entry, std::list<std::string>::iterator>> entries;
+    std::mutex mutex;
+
+    static std::string makeKey(const std::string& path, ContentEncoding encoding) {
+        return CompressionHelper::encodingName(encoding) + " " + path;
+    }
+
+public:
+    explicit CompressedCache(size_t cap = 16) : capacity(cap) {}
+
+    // Look up a compressed body for (path, encoding) matching raw exactly
+    bool lookup(const std::string& path, ContentEncoding encoding,
+                const std::string& raw, std::string& compressed) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(makeKey(path, encoding));
+        if (it == entries.end() || it->second.first.raw != raw) {
+            return false;
+        }
+        order.splice(order.begin(), order, it->second.second);
+        compressed = it->second.first.compressed;
+        return true;
+    }
+
+    void store(const std::string& path, ContentEncoding encoding,
+               const std::string& raw, const std::string& compressed) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string key = makeKey(path, encoding);
+
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            order.erase(it->second.second);
+            entries.erase(it);
+        }
+
+        order.push_front(key);
+        entries[key] = std::make_pair(Entry{raw, compressed}, order.begin());
+
+        while (entries.size() > capacity) {
+            entries.erase(order.back());
+            order.pop_back();
+        }
+    }
+
+    // Drop every encoding cached for a path
+    void invalidate(const std::string& path) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (ContentEncoding encoding : {ContentEncoding::GZIP, ContentEncoding::DEFLATE}) {
+            auto it = entries.find(makeKey(path, encoding));
+            if (it != entries.end()) {
+                order.erase(it->second.second);
+                entries.erase(it);
+            }
+        }
+    }
+};
+
+#endif // COMPRESSIONHELPER_H
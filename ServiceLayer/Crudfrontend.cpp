@@ -183,6 +183,7 @@ void demonstrateMuscleGroupCRUD(httplib::Client& client) {
         std::cout << "   Response: " << res->body << std::endl;
     } else {
         std::cerr << "\n✗ FAILED to create muscle group" << std::endl;
+        if (res) std::cerr << "   Response: " << res->body << std::endl;
         return;
     }
     
@@ -210,7 +211,10 @@ void demonstrateMuscleGroupCRUD(httplib::Client& client) {
     printSmallSeparator();
     std::cout << "Request: POST http://localhost:8080/api/musclegroups" << std::endl;
     
-    res = client.Post("/api/musclegroups", "", "application/json");
+    // Posting the id updates the group; without it this would be a second
+    // group with the same (unique) name
+    std::string update = "{\"muscle_group_id\":" + std::to_string(createdId) + ",\"sets\":4}";
+    res = client.Post("/api/musclegroups", update, "application/json");
     
     if (res && res->status == 200) {
         std::cout << "\n✓ SUCCESS! Muscle Group updated" << std::endl;
@@ -361,7 +365,8 @@ void demonstrateEquipmentCRUD(httplib::Client& client) {
     
     std::cout << "\n[STEP 3] UPDATE EQUIPMENT" << std::endl;
     printSmallSeparator();
-    res = client.Post("/api/equipment", "", "application/json");
+    std::string update = "{\"equipment_id\":" + std::to_string(createdId) + ",\"category\":\"Accessories\"}";
+    res = client.Post("/api/equipment", update, "application/json");
     std::cout << (res && res->status == 200 ? "✓ Updated" : "✗ Failed") << std::endl;
     
     pauseForUser();
@@ -0,0 +1,224 @@
+// EventStream.h
+// Live feed of entity changes for Server-Sent Events (GET /api/stream)
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef EVENTSTREAM_H
+#define EVENTSTREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Settings, overridable through environment variables:
+//   WORKOUT_STREAM_CLIENTS   subscribers at once; each holds a server thread while
+//                            connected (default 8, 0 turns GET /api/stream off)
+//   WORKOUT_STREAM_BUFFER    events queued per subscriber before it has to resync (default 256)
+//   WORKOUT_STREAM_HISTORY   recent events kept for Last-Event-ID resume (default 1024)
+struct StreamConfig {
+    size_t maxSubscribers = 8;
+    size_t bufferSize = 256;
+    size_t historySize = 1024;
+
+    static StreamConfig fromEnvironment() {
+        StreamConfig config;
+        const char* clients = std::getenv("WORKOUT_STREAM_CLIENTS");
+        const char* buffer = std::getenv("WORKOUT_STREAM_BUFFER");
+        const char* history = std::getenv("WORKOUT_STREAM_HISTORY");
+
+        if (clients && std::atoi(clients) >= 0) config.maxSubscribers = static_cast<size_t>(std::atoi(clients));
+        if (buffer && std::atoi(buffer) > 0) config.bufferSize = static_cast<size_t>(std::atoi(buffer));
+        if (history && std::atoi(history) > 0) config.historySize = static_cast<size_t>(std::atoi(history));
+        return config;
+    }
+};
+
+struct StreamEvent {
+    unsigned long long seq;
+    std::string type;
+    std::string data;   // one line of JSON
+};
+
+/*
+ * Fan-out of events to Server-Sent Events subscribers.
+ *
+ * publish() numbers an event, keeps it in a bounded history and copies it
+ * into every subscriber's ring buffer. It never waits for a subscriber: when
+ * a ring is full the subscriber has fallen behind, so its buffer is dropped
+ * and it is sent a "resync" event instead, telling the client to refetch
+ * what it shows (a conditional GET) and carry on from there. One slow
+ * dashboard therefore costs a bounded amount of memory and never delays a
+ * write.
+ *
+ * Event IDs are "<epoch>-<sequence>", the epoch being fixed per server run.
+ * A client reconnecting with Last-Event-ID gets the events it missed from
+ * the history; if they are no longer there, or the ID is from an earlier
+ * run, it gets a resync first.
+ */
+class EventStream {
+public:
+    class Subscriber {
+        friend class EventStream;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::vector<StreamEvent> ring;
+        size_t head = 0;
+        size_t count = 0;
+        bool resync = false;
+        unsigned long long resyncSeq = 0;
+
+        explicit Subscriber(size_t capacity) : ring(capacity) {}
+
+        // Queue an event, or drop the backlog and flag a resync when full.
+        // Returns false on overflow. The caller holds mutex.
+        bool push(const StreamEvent& event) {
+            if (count == ring.size()) {
+                head = count = 0;
+                resync = true;
+                resyncSeq = event.seq;
+                return false;
+            }
+            ring[(head + count) % ring.size()] = event;
+            ++count;
+            return true;
+        }
+
+    public:
+        enum Wait { EVENT, RESYNC, IDLE };
+
+        // Wait up to timeout for the next event. RESYNC comes before the
+        // events that followed an overflow, with event.seq set to where the
+        // client's refetch picks up.
+        Wait next(std::chrono::milliseconds timeout, StreamEvent& event) {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!ready.wait_for(lock, timeout, [this] { return resync || count > 0; })) {
+                return IDLE;
+            }
+            if (resync) {
+                resync = false;
+                event.seq = resyncSeq;
+                return RESYNC;
+            }
+            event = std::move(ring[head]);
+            head = (head + 1) % ring.size();
+            --count;
+            return EVENT;
+        }
+    };
+
+    typedef std::shared_ptr<Subscriber> SubscriberPtr;
+
+private:
+    StreamConfig config;
+    std::string epoch;
+    std::mutex mutex;
+    std::vector<SubscriberPtr> subscribers;
+    std::deque<StreamEvent> history;
+    unsigned long long lastSeq = 0;
+    std::atomic<uint64_t> published{0};
+    std::atomic<uint64_t> resyncs{0};
+
+    // "<epoch>-<seq>" -> seq, when the epoch is this run's
+    bool parseEventId(const std::string& id, unsigned long long& seq) const {
+        if (id.size() <= epoch.size() + 1 || id.compare(0, epoch.size(), epoch) != 0 || id[epoch.size()] != '-') {
+            return false;
+        }
+        char* end = nullptr;
+        seq = std::strtoull(id.c_str() + epoch.size() + 1, &end, 10);
+        return *end == '\0';
+    }
+
+public:
+    void configure(const StreamConfig& settings, const std::string& runEpoch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        config = settings;
+        epoch = runEpoch;
+    }
+
+    bool isEnabled() const {
+        return config.maxSubscribers > 0;
+    }
+
+    size_t getMaxSubscribers() const {
+        return config.maxSubscribers;
+    }
+
+    std::string eventId(unsigned long long seq) const {
+        return epoch + "-" + std::to_string(seq);
+    }
+
+    void publish(const std::string& type, const std::string& data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        StreamEvent event{++lastSeq, type, data};
+        history.push_back(event);
+        if (history.size() > config.historySize) history.pop_front();
+        published.fetch_add(1, std::memory_order_relaxed);
+
+        for (const SubscriberPtr& subscriber : subscribers) {
+            {
+                std::lock_guard<std::mutex> subscriberLock(subscriber->mutex);
+                if (!subscriber->push(event)) resyncs.fetch_add(1, std::memory_order_relaxed);
+            }
+            subscriber->ready.notify_one();
+        }
+    }
+
+    // A new subscriber, already holding what it missed since lastEventId (an
+    // empty ID means "from now on"); nullptr when maxSubscribers are connected
+    SubscriberPtr subscribe(const std::string& lastEventId) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (subscribers.size() >= config.maxSubscribers) return nullptr;
+
+        SubscriberPtr subscriber(new Subscriber(config.bufferSize));
+        if (!lastEventId.empty()) {
+            unsigned long long seq = 0;
+            unsigned long long oldest = history.empty() ? lastSeq + 1 : history.front().seq;
+            if (!parseEventId(lastEventId, seq) || seq > lastSeq || seq + 1 < oldest) {
+                subscriber->resync = true;
+                subscriber->resyncSeq = lastSeq;
+                resyncs.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                for (const StreamEvent& event : history) {
+                    if (event.seq > seq && !subscriber->push(event)) resyncs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        subscribers.push_back(subscriber);
+        return subscriber;
+    }
+
+    void unsubscribe(const SubscriberPtr& subscriber) {
+        std::lock_guard<std::mutex> lock(mutex);
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), subscriber), subscribers.end());
+    }
+
+    // An event in the text/event-stream wire format
+    std::string format(const StreamEvent& event) const {
+        return "id: " + eventId(event.seq) + "\nevent: " + event.type + "\ndata: " + event.data + "\n\n";
+    }
+
+    size_t getSubscriberCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return subscribers.size();
+    }
+
+    uint64_t getPublished() const {
+        return published.load(std::memory_order_relaxed);
+    }
+
+    // Subscribers told to resync (overflowed, or resumed from too far back)
+    uint64_t getResyncs() const {
+        return resyncs.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // EVENTSTREAM_H
@@ -0,0 +1,182 @@
+// FormDecoder.h
+// Single-pass decoder for URL query strings and form bodies (CGI and REST)
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef FORMDECODER_H
+#define FORMDECODER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Hex digit value of each byte, or 0xFF for a byte that is not one
+struct HexDigitTable {
+    uint8_t value[256];
+
+    constexpr HexDigitTable() : value() {
+        for (int c = 0; c < 256; ++c) value[c] = 0xFF;
+        for (int c = 0; c < 10; ++c) value['0' + c] = static_cast<uint8_t>(c);
+        for (int c = 0; c < 6; ++c) {
+            value['a' + c] = static_cast<uint8_t>(10 + c);
+            value['A' + c] = static_cast<uint8_t>(10 + c);
+        }
+    }
+
+    constexpr uint8_t operator[](char c) const {
+        return value[static_cast<uint8_t>(c)];
+    }
+};
+
+inline constexpr HexDigitTable hexDigits{};
+static_assert(hexDigits['7'] == 7 && hexDigits['c'] == 12 && hexDigits['F'] == 15 && hexDigits['g'] == 0xFF,
+              "hex digit table");
+
+/*
+ * Decodes "a=1&b=x%20y" (application/x-www-form-urlencoded) in one pass.
+ * Every decoded key and value is written into a single arena buffer and
+ * exposed as a std::string_view, kept in a small flat list in input order:
+ *
+ *   FormDecoder form;
+ *   form.parse(body);
+ *   std::string_view date = form.get("date");
+ *
+ * Decoding never makes text longer, so the arena is sized to the input once
+ * and no per-field strings are built; a reused decoder does not allocate
+ * at all once it has seen an input of that size. Plain runs between special
+ * characters are found 16 bytes at a time with SSE2 (scalar elsewhere) and
+ * copied with memcpy; %XX escapes go through a lookup table.
+ *
+ * '+' decodes to a space. A malformed escape ("%G1", or '%' at the end) is
+ * kept as-is. Pairs without '=' are ignored.
+ *
+ * A repeated key ("a=1&a=2") keeps its first value in get() and find(), as
+ * httplib's get_param_value does for the REST server. The CGI's old
+ * std::map parser kept the last one; getFields() still lists every pair.
+ *
+ * Views stay valid until the next parse() and point into this decoder's
+ * arena, so a decoder can be moved (the buffer goes with it) but not copied.
+ */
+class FormDecoder {
+public:
+    struct Field {
+        std::string_view key;
+        std::string_view value;
+    };
+
+private:
+    std::vector<char> arena;
+    std::vector<Field> fields;
+
+    static bool isSpecial(char c) {
+        return c == '&' || c == '=' || c == '%' || c == '+';
+    }
+
+    // Offset of the next '&', '=', '%' or '+' at or after pos, or size
+    static size_t nextSpecial(const char* data, size_t pos, size_t size) {
+#if defined(__SSE2__)
+        const __m128i amp = _mm_set1_epi8('&');
+        const __m128i equals = _mm_set1_epi8('=');
+        const __m128i percent = _mm_set1_epi8('%');
+        const __m128i plus = _mm_set1_epi8('+');
+        for (; pos + 16 <= size; pos += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, amp), _mm_cmpeq_epi8(chunk, equals)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(chunk, percent), _mm_cmpeq_epi8(chunk, plus)));
+            int mask = _mm_movemask_epi8(hits);
+            if (mask != 0) return pos + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+#endif
+        while (pos < size && !isSpecial(data[pos])) ++pos;
+        return pos;
+    }
+
+public:
+    FormDecoder() = default;
+    FormDecoder(const FormDecoder&) = delete;
+    FormDecoder& operator=(const FormDecoder&) = delete;
+    FormDecoder(FormDecoder&&) = default;
+    FormDecoder& operator=(FormDecoder&&) = default;
+
+    // Decode input, replacing whatever the previous parse() held
+    void parse(std::string_view input) {
+        fields.clear();
+        if (arena.size() < input.size()) arena.resize(input.size());
+
+        const char* in = input.data();
+        const size_t size = input.size();
+        char* out = arena.data();
+        size_t pos = 0;
+        size_t written = 0;
+        size_t keyStart = 0;
+        size_t keyEnd = 0;
+        bool inValue = false;
+
+        auto finishPair = [&]() {
+            if (inValue) {
+                fields.push_back({std::string_view(out + keyStart, keyEnd - keyStart),
+                                  std::string_view(out + keyEnd, written - keyEnd)});
+            } else {
+                written = keyStart;  // no '=': drop the pair
+            }
+            keyStart = written;
+            inValue = false;
+        };
+
+        while (pos < size) {
+            size_t special = nextSpecial(in, pos, size);
+            std::memcpy(out + written, in + pos, special - pos);
+            written += special - pos;
+            pos = special;
+            if (pos == size) break;
+
+            char c = in[pos++];
+            if (c == '&') {
+                finishPair();
+            } else if (c == '=' && !inValue) {
+                keyEnd = written;
+                inValue = true;
+            } else if (c == '+') {
+                out[written++] = ' ';
+            } else if (c == '%' && pos + 2 <= size && (hexDigits[in[pos]] | hexDigits[in[pos + 1]]) < 16) {
+                out[written++] = static_cast<char>(hexDigits[in[pos]] * 16 + hexDigits[in[pos + 1]]);
+                pos += 2;
+            } else {
+                out[written++] = c;  // '=' inside a value, or a malformed escape
+            }
+        }
+        if (size > 0) finishPair();
+    }
+
+    // First value for key, or an empty view
+    std::string_view get(std::string_view key) const {
+        const Field* field = find(key);
+        return field ? field->value : std::string_view();
+    }
+
+    const Field* find(std::string_view key) const {
+        for (const Field& field : fields) {
+            if (field.key == key) return &field;
+        }
+        return nullptr;
+    }
+
+    bool has(std::string_view key) const {
+        return find(key) != nullptr;
+    }
+
+    const std::vector<Field>& getFields() const {
+        return fields;
+    }
+
+    size_t size() const {
+        return fields.size();
+    }
+};
+
+#endif // FORMDECODER_H
@@ -0,0 +1,231 @@
+// IdempotencyStore.h
+// Idempotency-Key support for POST endpoints of the REST API
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef IDEMPOTENCYSTORE_H
+#define IDEMPOTENCYSTORE_H
+
+#include "../WorkoutDAO.h"
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+
+// Settings, overridable through environment variables:
+//   WORKOUT_IDEMPOTENCY_TTL_SECONDS  how long a saved response is replayed (default 86400)
+//   WORKOUT_IDEMPOTENCY_CAPACITY     keys kept in memory (default 1024)
+struct IdempotencyConfig {
+    long long ttlSeconds;
+    size_t capacity;
+
+    IdempotencyConfig(long long ttl = 86400, size_t cap = 1024)
+        : ttlSeconds(ttl), capacity(cap) {}
+
+    static IdempotencyConfig fromEnvironment() {
+        IdempotencyConfig config;
+        const char* ttl = std::getenv("WORKOUT_IDEMPOTENCY_TTL_SECONDS");
+        const char* capacity = std::getenv("WORKOUT_IDEMPOTENCY_CAPACITY");
+
+        if (ttl) {
+            long long parsed = std::atoll(ttl);
+            if (parsed > 0) config.ttlSeconds = parsed;
+        }
+        if (capacity) {
+            long parsed = std::atol(capacity);
+            if (parsed > 0) config.capacity = static_cast<size_t>(parsed);
+        }
+        return config;
+    }
+};
+
+/*
+ * Remembers the response to each POST that carried an Idempotency-Key and
+ * replays it when the same key comes back within the TTL. Recent keys live
+ * in a bounded LRU; every completed response is also written to the
+ * IdempotencyKey table so replays survive restarts and LRU eviction.
+ *
+ * Keys are per client: callers pass scopedKey(client, key), so two clients
+ * picking the same Idempotency-Key neither block each other (409/422) nor
+ * receive each other's saved responses.
+ *
+ *   begin(key, fingerprint, record)
+ *     PROCEED     - first time: run the request, then complete() or abandon()
+ *     REPLAY      - record holds the saved response
+ *     IN_PROGRESS - the same key is being processed right now
+ *     MISMATCH    - the key was used for a different request
+ */
+class IdempotencyStore {
+public:
+    enum class Outcome {
+        PROCEED,
+        REPLAY,
+        IN_PROGRESS,
+        MISMATCH
+    };
+
+private:
+    struct Entry {
+        IdempotencyRecord record;
+        bool inFlight;
+        std::list<std::string>::iterator position;
+    };
+
+    WorkoutDAO* dao;
+    IdempotencyConfig config;
+    std::list<std::string> order;  // most recently used at the front
+    std::map<std::string, Entry> entries;
+    std::mutex mutex;
+    unsigned completedSincePurge;
+
+    bool expired(const IdempotencyRecord& record, long long now) const {
+        return record.createdAt + config.ttlSeconds < now;
+    }
+
+    void erase(std::map<std::string, Entry>::iterator it) {
+        order.erase(it->second.position);
+        entries.erase(it);
+    }
+
+    // Evict least recently used completed entries; in-flight ones stay
+    void evict() {
+        auto victim = order.end();
+        while (entries.size() > config.capacity && victim != order.begin()) {
+            --victim;
+            auto it = entries.find(*victim);
+            if (it->second.inFlight) continue;
+            victim = order.erase(victim);
+            entries.erase(it);
+        }
+    }
+
+    Outcome classify(const Entry& entry, const std::string& fingerprint, IdempotencyRecord& record) const {
+        if (entry.record.fingerprint != fingerprint) return Outcome::MISMATCH;
+        if (entry.inFlight) return Outcome::IN_PROGRESS;
+        record = entry.record;
+        return Outcome::REPLAY;
+    }
+
+public:
+    explicit IdempotencyStore(WorkoutDAO* dataAccess = nullptr,
+                              const IdempotencyConfig& settings = IdempotencyConfig())
+        : dao(dataAccess), config(settings), completedSincePurge(0) {}
+
+    void configure(WorkoutDAO* dataAccess, const IdempotencyConfig& settings) {
+        std::lock_guard<std::mutex> lock(mutex);
+        dao = dataAccess;
+        config = settings;
+    }
+
+    // "<client> <key>". Client names longer than 64 characters are replaced
+    // by their hash, so a scoped key always fits the table's 255 characters.
+    static std::string scopedKey(const std::string& client, const std::string& key) {
+        std::string scope = client.size() > 64 ? "hash:" + fingerprint("", "", client) : client;
+        return scope + " " + key;
+    }
+
+    // Stable 64-bit FNV-1a hash of the request, as 16 hex digits
+    static std::string fingerprint(const std::string& method, const std::string& path,
+                                   const std::string& body) {
+        unsigned long long hash = 1469598103934665603ULL;
+        auto mix = [&hash](const std::string& part) {
+            for (unsigned char c : part) {
+                hash ^= c;
+                hash *= 1099511628211ULL;
+            }
+            hash ^= 0xff;  // separator so "ab"+"c" differs from "a"+"bc"
+            hash *= 1099511628211ULL;
+        };
+        mix(method);
+        mix(path);
+        mix(body);
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx", hash);
+        return hex;
+    }
+
+    Outcome begin(const std::string& key, const std::string& fingerprint, IdempotencyRecord& record) {
+        long long now = static_cast<long long>(std::time(nullptr));
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(key);
+            if (it != entries.end()) {
+                if (it->second.inFlight || !expired(it->second.record, now)) {
+                    order.splice(order.begin(), order, it->second.position);
+                    return classify(it->second, fingerprint, record);
+                }
+                erase(it);
+            }
+
+            // Claim the key before going to the database so a concurrent
+            // retry sees IN_PROGRESS instead of running the request twice
+            order.push_front(key);
+            Entry& entry = entries[key];
+            entry.record.fingerprint = fingerprint;
+            entry.inFlight = true;
+            entry.position = order.begin();
+            evict();
+        }
+
+        IdempotencyRecord stored;
+        bool found = dao && dao->readIdempotencyRecord(key, stored) && !expired(stored, now);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (!found || it == entries.end()) {
+            return Outcome::PROCEED;
+        }
+        it->second.record = stored;
+        it->second.inFlight = false;
+        return classify(it->second, fingerprint, record);
+    }
+
+    // Save the response of a request that got PROCEED
+    void complete(const std::string& key, int status, const std::string& contentType,
+                  const std::string& body) {
+        IdempotencyRecord record;
+        bool purge = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(key);
+            if (it == entries.end() || !it->second.inFlight) return;
+
+            it->second.record.status = status;
+            it->second.record.contentType = contentType;
+            it->second.record.body = body;
+            it->second.record.createdAt = static_cast<long long>(std::time(nullptr));
+            it->second.inFlight = false;
+            record = it->second.record;
+            evict();
+
+            if (++completedSincePurge >= 256) {
+                completedSincePurge = 0;
+                purge = true;
+            }
+        }
+
+        if (dao) {
+            dao->saveIdempotencyRecord(key, record);
+            if (purge) {
+                dao->purgeIdempotencyRecords(record.createdAt - config.ttlSeconds);
+            }
+        }
+    }
+
+    // Forget a request that failed in a way the client should retry (5xx)
+    void abandon(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second.inFlight) {
+            erase(it);
+        }
+    }
+};
+
+#endif // IDEMPOTENCYSTORE_H
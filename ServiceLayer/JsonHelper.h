@@ -11,162 +11,197 @@
 #include "../Nutrition.h"
 #include "../Recovery.h"
 #include "../Equipment.h"
+#include "../ResultSet.h"
 #include <string>
 #include <sstream>
 #include <vector>
+#include <cstdlib>
 
 class JsonHelper {
 public:
-    // Escape special characters for JSON
-    static std::string escapeJson(const std::string& str) {
-        std::ostringstream oss;
-        for (char c : str) {
+    // Streams a string JSON-escaped, without building an escaped copy:
+    //   json << "\"name\":\"" << escaped(name) << "\""
+    struct Escaped {
+        const std::string& text;
+    };
+    
+    static Escaped escaped(const std::string& text) {
+        return Escaped{text};
+    }
+    
+    friend std::ostream& operator<<(std::ostream& out, const Escaped& value) {
+        for (char c : value.text) {
             switch (c) {
-                case '"':  oss << "\\\""; break;
-                case '\\': oss << "\\\\"; break;
-                case '\b': oss << "\\b"; break;
-                case '\f': oss << "\\f"; break;
-                case '\n': oss << "\\n"; break;
-                case '\r': oss << "\\r"; break;
-                case '\t': oss << "\\t"; break;
-                default:   oss << c; break;
+                case '"':  out << "\\\""; break;
+                case '\\': out << "\\\\"; break;
+                case '\b': out << "\\b"; break;
+                case '\f': out << "\\f"; break;
+                case '\n': out << "\\n"; break;
+                case '\r': out << "\\r"; break;
+                case '\t': out << "\\t"; break;
+                default:   out << c; break;
             }
         }
+        return out;
+    }
+    
+    // Escape special characters for JSON
+    static std::string escapeJson(const std::string& str) {
+        std::ostringstream oss;
+        oss << escaped(str);
         return oss.str();
     }
     
-    // Convert Workout to JSON
-    static std::string workoutToJson(const Workout& workout) {
+    // Every row written straight into one stream: no per-row strings
+    template<typename T>
+    static std::string toJsonArray(const ResultSet<T>& rows, void (*write)(std::ostream&, const T&)) {
         std::ostringstream json;
+        json << "[";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            if (i > 0) json << ",";
+            write(json, rows[i]);
+        }
+        json << "]";
+        return json.str();
+    }
+    
+    // Write Workout as a JSON object
+    static void writeWorkout(std::ostream& json, const Workout& workout) {
+        json << "{";
+        writeWorkoutFields(json, workout);
+        json << "}";
+    }
+    
+    // Write Workout with its muscle group object (already JSON) inlined as
+    // "muscle_group", or null when there is none
+    static void writeWorkout(std::ostream& json, const Workout& workout, const std::string* muscleGroup) {
         json << "{";
+        writeWorkoutFields(json, workout);
+        json << ",\"muscle_group\":";
+        if (muscleGroup) json << *muscleGroup; else json << "null";
+        json << "}";
+    }
+    
+    // Members of a Workout object, without the braces
+    static void writeWorkoutFields(std::ostream& json, const Workout& workout) {
         json << "\"workout_id\":" << workout.getWorkoutId() << ",";
-        json << "\"workout_date\":\"" << escapeJson(workout.getWorkoutDate()) << "\",";
-        json << "\"workout_time\":\"" << escapeJson(workout.getWorkoutTime()) << "\",";
+        json << "\"workout_date\":\"" << escaped(workout.getWorkoutDate()) << "\",";
+        json << "\"workout_time\":\"" << escaped(workout.getWorkoutTime()) << "\",";
         json << "\"duration\":" << workout.getDuration() << ",";
-        json << "\"type_description\":\"" << escapeJson(workout.getTypeDescription()) << "\",";
+        json << "\"type_description\":\"" << escaped(workout.getTypeDescription()) << "\",";
         json << "\"calories_burned\":" << workout.getCaloriesBurned() << ",";
         json << "\"rate_perceived_exhaustion\":" << workout.getRatePerceivedExhaustion() << ",";
         json << "\"muscle_group_id\":" << workout.getMuscleGroupId();
-        json << "}";
-        return json.str();
     }
     
-    // Convert MuscleGroup to JSON
-    static std::string muscleGroupToJson(const MuscleGroup& mg) {
+    // Convert Workout to JSON
+    static std::string workoutToJson(const Workout& workout) {
         std::ostringstream json;
+        writeWorkout(json, workout);
+        return json.str();
+    }
+    
+    // Write MuscleGroup as a JSON object
+    static void writeMuscleGroup(std::ostream& json, const MuscleGroup& mg) {
         json << "{";
         json << "\"muscle_group_id\":" << mg.getMuscleGroupId() << ",";
-        json << "\"name\":\"" << escapeJson(mg.getName()) << "\",";
-        json << "\"description\":\"" << escapeJson(mg.getDescription()) << "\",";
+        json << "\"name\":\"" << escaped(mg.getName()) << "\",";
+        json << "\"description\":\"" << escaped(mg.getDescription()) << "\",";
         json << "\"days_per_week\":" << mg.getDaysPerWeek() << ",";
         json << "\"sets\":" << mg.getSets() << ",";
         json << "\"reps\":" << mg.getReps() << ",";
         json << "\"weight_amount\":" << mg.getWeightAmount();
         json << "}";
-        return json.str();
     }
     
-    // Convert Nutrition to JSON
-    static std::string nutritionToJson(const Nutrition& nutrition) {
+    // Convert MuscleGroup to JSON
+    static std::string muscleGroupToJson(const MuscleGroup& mg) {
         std::ostringstream json;
+        writeMuscleGroup(json, mg);
+        return json.str();
+    }
+    
+    // Write Nutrition as a JSON object
+    static void writeNutrition(std::ostream& json, const Nutrition& nutrition) {
         json << "{";
         json << "\"nutrition_id\":" << nutrition.getNutritionId() << ",";
-        json << "\"family\":\"" << escapeJson(nutrition.getFamilyString()) << "\",";
+        json << "\"family\":\"" << escaped(nutrition.getFamilyString()) << "\",";
         json << "\"water\":" << nutrition.getWater() << ",";
         json << "\"carbs\":" << nutrition.getCarbs() << ",";
         json << "\"fat\":" << nutrition.getFat() << ",";
         json << "\"protein\":" << nutrition.getProtein() << ",";
         json << "\"sugar\":" << nutrition.getSugar() << ",";
-        json << "\"meal_date\":\"" << escapeJson(nutrition.getMealDate()) << "\",";
+        json << "\"meal_date\":\"" << escaped(nutrition.getMealDate()) << "\",";
         json << "\"total_calories\":" << nutrition.calculateTotalCalories();
         json << "}";
-        return json.str();
     }
     
-    // Convert Recovery to JSON
-    static std::string recoveryToJson(const Recovery& recovery) {
+    // Convert Nutrition to JSON
+    static std::string nutritionToJson(const Nutrition& nutrition) {
         std::ostringstream json;
+        writeNutrition(json, nutrition);
+        return json.str();
+    }
+    
+    // Write Recovery as a JSON object
+    static void writeRecovery(std::ostream& json, const Recovery& recovery) {
         json << "{";
         json << "\"recovery_id\":" << recovery.getRecoveryId() << ",";
-        json << "\"recovery_date\":\"" << escapeJson(recovery.getRecoveryDate()) << "\",";
+        json << "\"recovery_date\":\"" << escaped(recovery.getRecoveryDate()) << "\",";
         json << "\"duration\":" << recovery.getDuration() << ",";
-        json << "\"type\":\"" << escapeJson(recovery.getType()) << "\",";
-        json << "\"helpers\":\"" << escapeJson(recovery.getHelpers()) << "\"";
+        json << "\"type\":\"" << escaped(recovery.getType()) << "\",";
+        json << "\"helpers\":\"" << escaped(recovery.getHelpers()) << "\"";
         json << "}";
-        return json.str();
     }
     
-    // Convert Equipment to JSON
-    static std::string equipmentToJson(const Equipment& equipment) {
+    // Convert Recovery to JSON
+    static std::string recoveryToJson(const Recovery& recovery) {
         std::ostringstream json;
+        writeRecovery(json, recovery);
+        return json.str();
+    }
+    
+    // Write Equipment as a JSON object
+    static void writeEquipment(std::ostream& json, const Equipment& equipment) {
         json << "{";
         json << "\"equipment_id\":" << equipment.getEquipmentId() << ",";
-        json << "\"name\":\"" << escapeJson(equipment.getName()) << "\",";
-        json << "\"description\":\"" << escapeJson(equipment.getDescription()) << "\",";
-        json << "\"category\":\"" << escapeJson(equipment.getCategory()) << "\",";
-        json << "\"target\":\"" << escapeJson(equipment.getTarget()) << "\"";
+        json << "\"name\":\"" << escaped(equipment.getName()) << "\",";
+        json << "\"description\":\"" << escaped(equipment.getDescription()) << "\",";
+        json << "\"category\":\"" << escaped(equipment.getCategory()) << "\",";
+        json << "\"target\":\"" << escaped(equipment.getTarget()) << "\"";
         json << "}";
-        return json.str();
     }
     
-    // Convert vector of Workouts to JSON array
-    static std::string workoutsToJsonArray(const std::vector<Workout*>& workouts) {
+    // Convert Equipment to JSON
+    static std::string equipmentToJson(const Equipment& equipment) {
         std::ostringstream json;
-        json << "[";
-        for (size_t i = 0; i < workouts.size(); ++i) {
-            json << workoutToJson(*workouts[i]);
-            if (i < workouts.size() - 1) json << ",";
-        }
-        json << "]";
+        writeEquipment(json, equipment);
         return json.str();
     }
     
-    // Convert vector of MuscleGroups to JSON array
-    static std::string muscleGroupsToJsonArray(const std::vector<MuscleGroup*>& groups) {
-        std::ostringstream json;
-        json << "[";
-        for (size_t i = 0; i < groups.size(); ++i) {
-            json << muscleGroupToJson(*groups[i]);
-            if (i < groups.size() - 1) json << ",";
-        }
-        json << "]";
-        return json.str();
+    // Convert result set of Workouts to JSON array
+    static std::string workoutsToJsonArray(const ResultSet<Workout>& workouts) {
+        return toJsonArray(workouts, writeWorkout);
     }
     
-    // Convert vector of Nutrition to JSON array
-    static std::string nutritionToJsonArray(const std::vector<Nutrition*>& nutrition) {
-        std::ostringstream json;
-        json << "[";
-        for (size_t i = 0; i < nutrition.size(); ++i) {
-            json << nutritionToJson(*nutrition[i]);
-            if (i < nutrition.size() - 1) json << ",";
-        }
-        json << "]";
-        return json.str();
+    // Convert result set of MuscleGroups to JSON array
+    static std::string muscleGroupsToJsonArray(const ResultSet<MuscleGroup>& groups) {
+        return toJsonArray(groups, writeMuscleGroup);
     }
     
-    // Convert vector of Recovery to JSON array
-    static std::string recoveryToJsonArray(const std::vector<Recovery*>& recovery) {
-        std::ostringstream json;
-        json << "[";
-        for (size_t i = 0; i < recovery.size(); ++i) {
-            json << recoveryToJson(*recovery[i]);
-            if (i < recovery.size() - 1) json << ",";
-        }
-        json << "]";
-        return json.str();
+    // Convert result set of Nutrition to JSON array
+    static std::string nutritionToJsonArray(const ResultSet<Nutrition>& nutrition) {
+        return toJsonArray(nutrition, writeNutrition);
     }
     
-    // Convert vector of Equipment to JSON array
-    static std::string equipmentToJsonArray(const std::vector<Equipment*>& equipment) {
-        std::ostringstream json;
-        json << "[";
-        for (size_t i = 0; i < equipment.size(); ++i) {
-            json << equipmentToJson(*equipment[i]);
-            if (i < equipment.size() - 1) json << ",";
-        }
-        json << "]";
-        return json.str();
+    // Convert result set of Recovery to JSON array
+    static std::string recoveryToJsonArray(const ResultSet<Recovery>& recovery) {
+        return toJsonArray(recovery, writeRecovery);
+    }
+    
+    // Convert result set of Equipment to JSON array
+    static std::string equipmentToJsonArray(const ResultSet<Equipment>& equipment) {
+        return toJsonArray(equipment, writeEquipment);
     }
     
     // Create error response JSON
@@ -186,6 +221,140 @@ public:
         json << "}";
         return json.str();
     }
+    
+    // ==================== REQUEST PARSING ====================
+    // Minimal readers for request bodies: each looks up a key among the
+    // top-level members of a JSON object and returns false when the key is
+    // missing or holds a different type.
+    
+    static bool getString(const std::string& json, const std::string& key, std::string& out) {
+        size_t pos = findMember(json, key);
+        if (pos == std::string::npos || json[pos] != '"') return false;
+        
+        std::string value;
+        for (size_t i = pos + 1; i < json.size(); ++i) {
+            char c = json[i];
+            if (c == '"') {
+                out = value;
+                return true;
+            }
+            if (c == '\\' && i + 1 < json.size()) {
+                char e = json[++i];
+                switch (e) {
+                    case 'n': value += '\n'; break;
+                    case 't': value += '\t'; break;
+                    case 'r': value += '\r'; break;
+                    case 'b': value += '\b'; break;
+                    case 'f': value += '\f'; break;
+                    case 'u': i += 4; value += '?'; break;  // non-ASCII escapes not needed here
+                    default:  value += e; break;
+                }
+            } else {
+                value += c;
+            }
+        }
+        return false;
+    }
+    
+    static bool getNumber(const std::string& json, const std::string& key, double& out) {
+        size_t pos = findMember(json, key);
+        if (pos == std::string::npos) return false;
+        
+        const char* start = json.c_str() + pos;
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start) return false;
+        out = value;
+        return true;
+    }
+    
+    static bool getInt(const std::string& json, const std::string& key, int& out) {
+        double value;
+        if (!getNumber(json, key, value)) return false;
+        out = static_cast<int>(value);
+        return true;
+    }
+    
+    // Raw text of a nested object, e.g. "{...}"
+    static bool getObject(const std::string& json, const std::string& key, std::string& out) {
+        size_t pos = findMember(json, key);
+        if (pos == std::string::npos || json[pos] != '{') return false;
+        out = json.substr(pos, skipValue(json, pos) - pos);
+        return true;
+    }
+    
+    // Raw text of each object in an array of objects
+    static bool getObjectArray(const std::string& json, const std::string& key,
+                               std::vector<std::string>& out) {
+        size_t pos = findMember(json, key);
+        if (pos == std::string::npos || json[pos] != '[') return false;
+        
+        size_t i = skipSpace(json, pos + 1);
+        while (i < json.size() && json[i] != ']') {
+            if (json[i] != '{') return false;
+            size_t end = skipValue(json, i);
+            out.push_back(json.substr(i, end - i));
+            i = skipSpace(json, end);
+            if (i < json.size() && json[i] == ',') i = skipSpace(json, i + 1);
+        }
+        return i < json.size();
+    }
+
+private:
+    static size_t skipSpace(const std::string& json, size_t i) {
+        while (i < json.size() && (json[i] == ' ' || json[i] == '\t' ||
+                                   json[i] == '\n' || json[i] == '\r')) {
+            ++i;
+        }
+        return i;
+    }
+    
+    // Index just past the value starting at i (string, object, array or scalar)
+    static size_t skipValue(const std::string& json, size_t i) {
+        int depth = 0;
+        bool inString = false;
+        for (; i < json.size(); ++i) {
+            char c = json[i];
+            if (inString) {
+                if (c == '\\') ++i;
+                else if (c == '"') {
+                    inString = false;
+                    if (depth == 0) return i + 1;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) return i;
+                if (--depth == 0) return i + 1;
+            } else if (depth == 0 && (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t')) {
+                return i;
+            }
+        }
+        return i;
+    }
+    
+    // Position of the value for key in the outermost object, or npos
+    static size_t findMember(const std::string& json, const std::string& key) {
+        size_t i = skipSpace(json, 0);
+        if (i >= json.size() || json[i] != '{') return std::string::npos;
+        i = skipSpace(json, i + 1);
+        
+        while (i < json.size() && json[i] == '"') {
+            size_t nameEnd = skipValue(json, i);
+            std::string name = json.substr(i + 1, nameEnd - i - 2);
+            
+            i = skipSpace(json, nameEnd);
+            if (i >= json.size() || json[i] != ':') return std::string::npos;
+            i = skipSpace(json, i + 1);
+            if (name == key) return i;
+            
+            i = skipSpace(json, skipValue(json, i));
+            if (i < json.size() && json[i] == ',') i = skipSpace(json, i + 1);
+        }
+        return std::string::npos;
+    }
 };
 
 #endif // JSONHELPER_H
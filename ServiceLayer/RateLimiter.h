@@ -0,0 +1,263 @@
+// RateLimiter.h
+// Per-client token-bucket rate limiting for the REST API
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include "AdmissionControl.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+// Requests per second a client may sustain, and how many it may send at once
+struct RateBudget {
+    double perSecond;
+    int burst;
+};
+
+// Settings, overridable through environment variables:
+//   WORKOUT_RATE_LIMIT          set to 1 to limit each client (default off)
+//   WORKOUT_RATE_LIMIT_READS    budget for single-record GETs, "per-second/burst" (default 50/100)
+//   WORKOUT_RATE_LIMIT_LISTS    budget for collection GETs (default 5/10)
+//   WORKOUT_RATE_LIMIT_WRITES   budget for POST/PUT/DELETE (default 10/20)
+//   WORKOUT_RATE_LIMIT_CLIENTS  clients tracked at once; the longest idle is forgotten (default 4096)
+//   WORKOUT_RATE_LIMIT_KEYS     API keys accepted in X-API-Key, comma-separated (default none)
+struct RateLimitConfig {
+    bool enabled = false;
+    RateBudget budgets[3] = {{50, 100}, {5, 10}, {10, 20}};   // indexed by RouteClass
+    size_t maxClients = 4096;
+    std::unordered_set<std::string> apiKeys;
+
+    // "10/20" -> 10 per second, burst 20; "10" -> burst of one second's worth
+    static bool parseBudget(const char* text, RateBudget& budget) {
+        if (!text) return false;
+        char* end = nullptr;
+        double perSecond = std::strtod(text, &end);
+        int burst = *end == '/' ? std::atoi(end + 1) : static_cast<int>(perSecond);
+        if (perSecond <= 0 || burst < 1) return false;
+        budget = {perSecond, burst};
+        return true;
+    }
+
+    // "k1, k2" -> {"k1", "k2"}
+    static std::unordered_set<std::string> parseKeys(const std::string& list) {
+        std::unordered_set<std::string> keys;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos) end = list.size();
+
+            size_t first = list.find_first_not_of(" \t", start);
+            size_t last = list.find_last_not_of(" \t", end - 1);
+            if (first < end && last != std::string::npos && last >= first) {
+                keys.insert(list.substr(first, last - first + 1));
+            }
+            start = end + 1;
+        }
+        return keys;
+    }
+
+    static RateLimitConfig fromEnvironment() {
+        RateLimitConfig config;
+        const char* enabled = std::getenv("WORKOUT_RATE_LIMIT");
+        const char* clients = std::getenv("WORKOUT_RATE_LIMIT_CLIENTS");
+
+        config.enabled = enabled && std::string(enabled) == "1";
+        parseBudget(std::getenv("WORKOUT_RATE_LIMIT_READS"), config.budgets[static_cast<int>(RouteClass::READ)]);
+        parseBudget(std::getenv("WORKOUT_RATE_LIMIT_LISTS"), config.budgets[static_cast<int>(RouteClass::LIST)]);
+        parseBudget(std::getenv("WORKOUT_RATE_LIMIT_WRITES"), config.budgets[static_cast<int>(RouteClass::WRITE)]);
+        if (clients && std::atol(clients) > 0) config.maxClients = static_cast<size_t>(std::atol(clients));
+        if (const char* keys = std::getenv("WORKOUT_RATE_LIMIT_KEYS")) config.apiKeys = parseKeys(keys);
+        return config;
+    }
+};
+
+// Outcome of one request, with what the RateLimit-* headers report
+struct RateDecision {
+    bool allowed;
+    int limit;             // burst size of the budget
+    int remaining;         // requests left right now
+    int resetSeconds;      // until the bucket is full again
+    int retryAfterSeconds; // until the next request would be allowed (when refused)
+    int windowSeconds;     // burst / rate, for RateLimit-Policy
+};
+
+/*
+ * One token bucket per client and route class, in a table of fixed size.
+ *
+ * Buckets use GCRA: each holds a single "theoretical arrival time" (TAT).
+ * A request is allowed when pushing the TAT one interval (1/rate) forward
+ * keeps it within burst intervals of now, so refill is implicit in the
+ * clock and taking a token is one compare and one store.
+ *
+ * Clients live in SHARD_COUNT shards chosen by key hash. A shard's mutex
+ * covers its index, its LRU list and its clients' TATs: the lookup and the
+ * GCRA update happen under one lock, so a record cannot be recycled for
+ * another key between the two. The critical section is a hash lookup and a
+ * few arithmetic operations. Each shard and each client record is
+ * cache-line aligned so busy clients in different shards do not share
+ * lines. Every shard owns maxClients / SHARD_COUNT preallocated records,
+ * and a new client takes over the least recently seen one when its shard is
+ * full, so memory stays constant no matter how many clients come and go. A
+ * forgotten client starts again with a full bucket.
+ */
+class RateLimiter {
+public:
+    static const size_t SHARD_COUNT = 16;
+
+private:
+    struct alignas(64) Client {
+        int64_t arrival[3] = {0, 0, 0};   // TAT per route class, steady-clock ns
+        std::string key;
+        Client* newer = nullptr;
+        Client* older = nullptr;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Client*> index;
+        std::unique_ptr<Client[]> clients;
+        size_t used = 0;
+        Client* newest = nullptr;
+        Client* oldest = nullptr;
+    };
+
+    RateLimitConfig config;
+    size_t perShard = 0;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<uint64_t> limited{0};
+    std::atomic<uint64_t> evictions{0};
+
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static int ceilSeconds(int64_t ns) {
+        return ns <= 0 ? 0 : static_cast<int>((ns + 999999999) / 1000000000);
+    }
+
+    static void unlink(Shard& shard, Client* client) {
+        (client->newer ? client->newer->older : shard.oldest) = client->older;
+        (client->older ? client->older->newer : shard.newest) = client->newer;
+        client->newer = client->older = nullptr;
+    }
+
+    static void pushNewest(Shard& shard, Client* client) {
+        client->older = shard.newest;
+        client->newer = nullptr;
+        (shard.newest ? shard.newest->newer : shard.oldest) = client;
+        shard.newest = client;
+    }
+
+    // The client's record, created or recycled as needed; marks it most recent.
+    // The caller holds shard.mutex and must not keep the pointer past it.
+    Client* find(Shard& shard, const std::string& key) {
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            if (shard.newest != found->second) {
+                unlink(shard, found->second);
+                pushNewest(shard, found->second);
+            }
+            return found->second;
+        }
+
+        Client* client;
+        if (shard.used < perShard) {
+            client = &shard.clients[shard.used++];
+        } else {
+            client = shard.oldest;
+            unlink(shard, client);
+            shard.index.erase(client->key);
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (int64_t& arrival : client->arrival) arrival = 0;
+        client->key = key;
+        shard.index.emplace(key, client);
+        pushNewest(shard, client);
+        return client;
+    }
+
+public:
+    void configure(const RateLimitConfig& settings) {
+        config = settings;
+        if (!settings.enabled) return;
+        perShard = std::max<size_t>(1, (settings.maxClients + SHARD_COUNT - 1) / SHARD_COUNT);
+        shards.reset(new Shard[SHARD_COUNT]);
+        for (size_t i = 0; i < SHARD_COUNT; ++i) {
+            shards[i].clients.reset(new Client[perShard]);
+            shards[i].index.reserve(perShard);
+        }
+    }
+
+    bool isEnabled() const {
+        return config.enabled && shards;
+    }
+
+    // Is key one of the configured API keys (WORKOUT_RATE_LIMIT_KEYS)?
+    bool isKnownKey(const std::string& key) const {
+        return !key.empty() && config.apiKeys.count(key) > 0;
+    }
+
+    // Take one token from key's bucket for the route class
+    RateDecision take(const std::string& key, RouteClass routeClass) {
+        const RateBudget& budget = config.budgets[static_cast<int>(routeClass)];
+        const int64_t interval = static_cast<int64_t>(1e9 / budget.perSecond);
+        const int64_t tolerance = interval * budget.burst;
+        RateDecision decision = {false, budget.burst, 0, 0, 0,
+                                 std::max(1, static_cast<int>(budget.burst / budget.perSecond))};
+        int64_t current;
+        int64_t next;
+        int64_t now;
+        {
+            Shard& shard = shards[std::hash<std::string>()(key) % SHARD_COUNT];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            int64_t& arrival = find(shard, key)->arrival[static_cast<int>(routeClass)];
+            now = nowNs();
+            current = arrival;
+            next = std::max(current, now) + interval;
+            decision.allowed = next - now <= tolerance;
+            if (decision.allowed) arrival = next;
+        }
+
+        if (!decision.allowed) {
+            // Refused: the bucket is empty until the TAT comes back in range
+            decision.resetSeconds = ceilSeconds(current - now);
+            decision.retryAfterSeconds = std::max(1, ceilSeconds(next - now - tolerance));
+            limited.fetch_add(1, std::memory_order_relaxed);
+            return decision;
+        }
+        decision.remaining = static_cast<int>((tolerance - (next - now)) / interval);
+        decision.resetSeconds = ceilSeconds(next - now);
+        return decision;
+    }
+
+    size_t getClientCount() {
+        size_t count = 0;
+        for (size_t i = 0; i < SHARD_COUNT && shards; ++i) {
+            std::lock_guard<std::mutex> lock(shards[i].mutex);
+            count += shards[i].index.size();
+        }
+        return count;
+    }
+
+    uint64_t getLimited() const {
+        return limited.load(std::memory_order_relaxed);
+    }
+
+    uint64_t getEvictions() const {
+        return evictions.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // RATELIMITER_H
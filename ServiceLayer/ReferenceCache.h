@@ -0,0 +1,82 @@
+// ReferenceCache.h
+// Serialized rows of a reference table, kept for embedding in other responses
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef REFERENCECACHE_H
+#define REFERENCECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * JSON of single rows from a small table that rarely changes (muscle
+ * groups), keyed by ID and tagged with the version of the table they were
+ * read at - the REST server uses the table's ETag:
+ *
+ *   std::unordered_map<int, std::string> groups;
+ *   std::vector<int> missing = cache.lookup(version, ids, groups);
+ *   ... read the missing rows in one query, cache.store(version, id, json) each ...
+ *
+ * Entries are only returned to callers asking for the version they were
+ * stored under, and storing under another version drops everything else, so
+ * a write to the table is never hidden by an older copy. When the cache is
+ * full it is cleared; a reference table fits many times over.
+ */
+class ReferenceCache {
+    std::mutex mutex;
+    std::string version;
+    std::unordered_map<int, std::string> rows;
+    size_t maxRows;
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+
+public:
+    explicit ReferenceCache(size_t maximum = 4096) : maxRows(maximum) {}
+
+    // Copy the cached rows among ids into found; returns the IDs that are not cached
+    std::vector<int> lookup(const std::string& tableVersion, const std::vector<int>& ids,
+                            std::unordered_map<int, std::string>& found) {
+        std::vector<int> missing;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bool current = tableVersion == version;
+            for (int id : ids) {
+                auto row = current ? rows.find(id) : rows.end();
+                if (row != rows.end()) {
+                    found.emplace(id, row->second);
+                } else {
+                    missing.push_back(id);
+                }
+            }
+        }
+        hits.fetch_add(ids.size() - missing.size(), std::memory_order_relaxed);
+        misses.fetch_add(missing.size(), std::memory_order_relaxed);
+        return missing;
+    }
+
+    void store(const std::string& tableVersion, int id, const std::string& json) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tableVersion != version || rows.size() >= maxRows) {
+            rows.clear();
+            version = tableVersion;
+        }
+        rows[id] = json;
+    }
+
+    // Rows served from the cache
+    uint64_t getHits() const {
+        return hits.load(std::memory_order_relaxed);
+    }
+
+    // Rows that had to be read from the database
+    uint64_t getMisses() const {
+        return misses.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // REFERENCECACHE_H
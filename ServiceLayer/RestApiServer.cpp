@@ -63,14 +63,624 @@
 #include "httplib.h"
 #include "../BusinessLayer/WorkoutManager.h"
 #include "JsonHelper.h"
+#include "CompressionHelper.h"
+#include "IdempotencyStore.h"
+#include "WriteBehindQueue.h"
+#include "Validation.h"
+#include "FormDecoder.h"
+#include "SingleFlight.h"
+#include "AdmissionControl.h"
+#include "RateLimiter.h"
+#include "ReferenceCache.h"
+#include "EventStream.h"
+#include "../LocalStoreDAO.h"
 #include <iostream>
 #include <sstream>
 #include <memory>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <charconv>
+#include <cmath>
+#include <ctime>
 
 // Global WorkoutManager instance
 std::unique_ptr<WorkoutDAO> dao;
 std::unique_ptr<WorkoutManager> manager;
 
+// Response compression settings and cache of compressed reference lists
+CompressionConfig compressionConfig;
+CompressedCache compressedCache;
+
+// Saved responses for POSTs sent with an Idempotency-Key header
+IdempotencyStore idempotencyStore;
+
+// Key claimed by the request this thread is handling (pre- to post-routing)
+thread_local std::string pendingIdempotencyKey;
+
+// Concurrent identical list requests share one query and one serialized body
+SingleFlight listFlights;
+
+// Adaptive concurrency limits per route class; the class a request was
+// admitted under (-1 if none) and when, from pre- to post-routing
+AdmissionController admission;
+thread_local int admittedClass = -1;
+thread_local std::chrono::steady_clock::time_point admittedAt;
+
+// Per-client request budgets (off unless WORKOUT_RATE_LIMIT=1)
+RateLimiter rateLimiter;
+
+// Muscle group JSON by ID for ?expand=muscle_group, for one version of the table
+ReferenceCache muscleGroupCache;
+
+// Creates, updates and deletes pushed to GET /api/stream subscribers
+EventStream changeStream;
+
+// Optional write-behind mode for POST /api/workouts. With MySQL the flusher has
+// its own DAO (and connection) so it never shares a MYSQL handle with request
+// threads; with the local store it uses the shared dao.
+// Declared before the queue so they outlive its final flush at exit.
+WriteBehindConfig writeBehindConfig;
+std::unique_ptr<WorkoutDAO> flushDao;
+std::unique_ptr<WorkoutManager> flushManager;
+WriteBehindQueue writeBehind;
+
+// Reference data that rarely changes - worth keeping compressed
+const std::set<std::string> cacheablePaths = {
+    "/api/musclegroups",
+    "/api/equipment"
+};
+
+// ==================== RESPONSE COMPRESSION ====================
+
+// Post-routing hook: gzip/deflate the body when the client accepts it
+void compressResponse(const httplib::Request& req, httplib::Response& res) {
+    bool cacheable = cacheablePaths.count(req.path) > 0;
+    
+    // Any write to a cached collection drops its compressed copies
+    if (cacheable && req.method != "GET") {
+        compressedCache.invalidate(req.path);
+        return;
+    }
+    
+    std::string contentType = res.get_header_value("Content-Type");
+    if (res.has_header("Content-Encoding") ||
+        !CompressionHelper::shouldCompress(compressionConfig, res.body.size(), contentType)) {
+        return;
+    }
+    
+    res.set_header("Vary", "Accept-Encoding");
+    ContentEncoding encoding = CompressionHelper::negotiate(req.get_header_value("Accept-Encoding"));
+    if (encoding == ContentEncoding::IDENTITY) {
+        return;
+    }
+    
+    std::string compressed;
+    bool cached = cacheable && res.status == 200 &&
+                  compressedCache.lookup(req.path, encoding, res.body, compressed);
+    
+    if (!cached) {
+        if (!CompressionHelper::compress(res.body, encoding, compressionConfig.level, compressed)) {
+            return;
+        }
+        if (cacheable && res.status == 200) {
+            compressedCache.store(req.path, encoding, res.body, compressed);
+        }
+    }
+    
+    res.body.swap(compressed);
+    res.set_header("Content-Encoding", CompressionHelper::encodingName(encoding));
+}
+
+// ==================== DATABASE HEALTH ====================
+
+// Circuit breaker state and round trip counters of the DAO as a JSON object
+std::string databaseHealthJson() {
+    const CircuitBreaker& breaker = dao->getCircuitBreaker();
+    ConnectionStats stats = dao->getConnectionStats();
+    std::ostringstream json;
+    json << "{\"circuit\":\"" << CircuitBreaker::stateName(breaker.getState()) << "\","
+         << "\"consecutiveFailures\":" << breaker.getConsecutiveFailures() << ","
+         << "\"timesOpened\":" << breaker.getTimesOpened() << ","
+         << "\"retryAfterMs\":" << breaker.retryAfterMs() << ","
+         << "\"queries\":" << stats.queries << ","
+         << "\"pings\":" << stats.pings << ","
+         << "\"connects\":" << stats.connects << ","
+         << "\"retries\":" << stats.retries << ","
+         << "\"replicaReads\":" << stats.replicaReads << "}";
+    return json.str();
+}
+
+// Pre-routing check: while the circuit is open, answer API calls with 503
+// straight away instead of letting each one wait for a connect timeout
+bool rejectWhileDatabaseDown(const httplib::Request& req, httplib::Response& res) {
+    if (req.path.compare(0, 5, "/api/") != 0) return false;
+    
+    // The change stream never touches the database
+    if (req.path == "/api/stream") return false;
+    
+    // Queued writes and ticket polls do not need the database
+    if (writeBehind.isRunning() &&
+        ((req.method == "POST" && req.path == "/api/workouts") || req.path.compare(0, 13, "/api/tickets/") == 0)) {
+        return false;
+    }
+    
+    const CircuitBreaker& breaker = dao->getCircuitBreaker();
+    if (!breaker.isRejecting()) return false;
+    
+    int retryAfterSec = (breaker.retryAfterMs() + 999) / 1000;
+    res.set_content(JsonHelper::errorResponse("Database unavailable"), "application/json");
+    res.status = 503;
+    res.set_header("Retry-After", std::to_string(retryAfterSec > 0 ? retryAfterSec : 1));
+    return true;
+}
+
+// ==================== ADMISSION CONTROL ====================
+
+// Collections whose GET returns every row: the first to be shed
+const std::set<std::string> listPaths = {
+    "/api/workouts",
+    "/api/musclegroups",
+    "/api/nutrition",
+    "/api/recovery",
+    "/api/equipment"
+};
+
+RouteClass classifyRequest(const httplib::Request& req) {
+    if (req.path == "/api/batch") return RouteClass::LIST;  // a bundle of reads, though POSTed
+    if (req.method == "POST" || req.method == "PUT" || req.method == "DELETE" || req.method == "PATCH") {
+        return RouteClass::WRITE;
+    }
+    return listPaths.count(req.path) > 0 ? RouteClass::LIST : RouteClass::READ;
+}
+
+// Pre-routing check: past its class's current limit an API call gets 503
+// at once, before it can add to the queue in front of the database
+bool rejectWhenSaturated(const httplib::Request& req, httplib::Response& res) {
+    admittedClass = -1;
+    if (req.path.compare(0, 5, "/api/") != 0 || !admission.isEnabled()) return false;
+    
+    RouteClass routeClass = classifyRequest(req);
+    if (!admission.admit(routeClass)) {
+        res.set_content(JsonHelper::errorResponse("Server busy, retry shortly"), "application/json");
+        res.status = 503;
+        res.set_header("Retry-After", "1");
+        return true;
+    }
+    admittedClass = static_cast<int>(routeClass);
+    admittedAt = std::chrono::steady_clock::now();
+    return false;
+}
+
+// Post-routing: the request's latency tunes its class's limit
+void releaseAdmission() {
+    if (admittedClass < 0) return;
+    double latencyMs = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - admittedAt).count();
+    admission.complete(static_cast<RouteClass>(admittedClass), latencyMs);
+    admittedClass = -1;
+}
+
+// ==================== RATE LIMITING ====================
+
+// Who a request is accounted to: its remote address, or its X-API-Key when
+// that is one of the configured keys. An unknown key is ignored, so sending
+// a new one each time does not earn a fresh bucket.
+std::string clientKey(const httplib::Request& req) {
+    std::string apiKey = req.get_header_value("X-API-Key");
+    return rateLimiter.isKnownKey(apiKey) ? "key:" + apiKey : "addr:" + req.remote_addr;
+}
+
+// Spend a token from key's budget for the route class. An empty bucket
+// fills res with a 429 and returns false.
+bool spendToken(const std::string& key, RouteClass routeClass, httplib::Response& res) {
+    RateDecision decision = rateLimiter.take(key, routeClass);
+    res.set_header("RateLimit-Limit", std::to_string(decision.limit));
+    res.set_header("RateLimit-Remaining", std::to_string(decision.remaining));
+    res.set_header("RateLimit-Reset", std::to_string(decision.resetSeconds));
+    res.set_header("RateLimit-Policy", std::to_string(decision.limit) + ";w=" + std::to_string(decision.windowSeconds));
+    if (decision.allowed) return true;
+    
+    res.set_content(JsonHelper::errorResponse("Rate limit exceeded"), "application/json");
+    res.status = 429;
+    res.set_header("Retry-After", std::to_string(decision.retryAfterSeconds));
+    return false;
+}
+
+// Pre-routing check: every API call spends a token from its client's budget
+// for the route class; an empty bucket means 429 until the next token is due.
+// A batch is charged by runBatch, one token per request inside it.
+bool rejectOverRateLimit(const httplib::Request& req, httplib::Response& res) {
+    if (req.path.compare(0, 5, "/api/") != 0 || !rateLimiter.isEnabled()) return false;
+    if (req.path == "/api/batch") return false;
+    
+    return !spendToken(clientKey(req), classifyRequest(req), res);
+}
+
+// GET /health: 503 while the database circuit is open
+void healthCheck(const httplib::Request&, httplib::Response& res) {
+    bool rejecting = dao->getCircuitBreaker().isRejecting();
+    std::string json = std::string("{\"status\":\"") + (rejecting ? "degraded" : "healthy") + "\","
+                       "\"database\":" + databaseHealthJson();
+    if (writeBehind.isRunning()) {
+        json += ",\"ingestQueue\":" + std::to_string(writeBehind.getDepth());
+    }
+    json += ",\"coalescing\":{\"executions\":" + std::to_string(listFlights.getExecutions()) +
+            ",\"coalesced\":" + std::to_string(listFlights.getCoalesced()) +
+            ",\"inFlight\":" + std::to_string(listFlights.getInFlight()) + "}";
+    if (admission.isEnabled()) {
+        json += ",\"admission\":" + admission.toJson();
+    }
+    json += ",\"expansion\":{\"cached\":" + std::to_string(muscleGroupCache.getHits()) +
+            ",\"loaded\":" + std::to_string(muscleGroupCache.getMisses()) + "}";
+    if (changeStream.isEnabled()) {
+        json += ",\"stream\":{\"subscribers\":" + std::to_string(changeStream.getSubscriberCount()) +
+                ",\"published\":" + std::to_string(changeStream.getPublished()) +
+                ",\"resyncs\":" + std::to_string(changeStream.getResyncs()) + "}";
+    }
+    if (rateLimiter.isEnabled()) {
+        json += ",\"rateLimit\":{\"clients\":" + std::to_string(rateLimiter.getClientCount()) +
+                ",\"limited\":" + std::to_string(rateLimiter.getLimited()) +
+                ",\"evictions\":" + std::to_string(rateLimiter.getEvictions()) + "}";
+    }
+    res.status = rejecting ? 503 : 200;
+    res.set_content(json + "}", "application/json");
+}
+
+// ==================== READ-YOUR-WRITES ====================
+
+// Deadline the client sent back (0 if none); reset per request since worker threads are reused
+thread_local long long requestPrimaryReadsUntil = 0;
+
+long long nowMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Pre-routing: reads go to the primary while the client's last write may
+// not have reached the replicas yet
+void restorePrimaryReads(const httplib::Request& req) {
+    requestPrimaryReadsUntil = ReadYourWritesCookie::parse(req.get_header_value("Cookie"), nowMillis(),
+                                                           dao->getConnectionPolicy().stickyMs);
+    WorkoutDAO::setPrimaryReadsUntil(requestPrimaryReadsUntil);
+}
+
+// Post-routing: hand a deadline extended by this request's writes back to the client
+void savePrimaryReads(httplib::Response& res) {
+    long long until = WorkoutDAO::getPrimaryReadsUntil();
+    if (until > requestPrimaryReadsUntil && dao->getReplicaCount() > 0) {
+        res.set_header("Set-Cookie", ReadYourWritesCookie::format(until, nowMillis()));
+    }
+}
+
+// ==================== IDEMPOTENCY KEYS ====================
+
+// Pre-routing hook: replay the saved response for a repeated Idempotency-Key
+httplib::Server::HandlerResponse checkIdempotencyKey(const httplib::Request& req, httplib::Response& res) {
+    if (req.method != "POST" || !req.has_header("Idempotency-Key")) {
+        return httplib::Server::HandlerResponse::Unhandled;
+    }
+    
+    std::string key = req.get_header_value("Idempotency-Key");
+    if (key.empty() || key.size() > 128) {
+        res.set_content(JsonHelper::errorResponse("Idempotency-Key must be 1-128 characters"), "application/json");
+        res.status = 400;
+        return httplib::Server::HandlerResponse::Handled;
+    }
+    
+    // Scoped to the client (its address, or a configured API key), so keys
+    // chosen by different clients never meet
+    IdempotencyRecord saved;
+    std::string scoped = IdempotencyStore::scopedKey(clientKey(req), key);
+    std::string fingerprint = IdempotencyStore::fingerprint(req.method, req.path, req.body);
+    
+    switch (idempotencyStore.begin(scoped, fingerprint, saved)) {
+        case IdempotencyStore::Outcome::PROCEED:
+            pendingIdempotencyKey = scoped;
+            return httplib::Server::HandlerResponse::Unhandled;
+        case IdempotencyStore::Outcome::REPLAY:
+            std::cout << "[API] Replaying response for Idempotency-Key " << key << std::endl;
+            res.set_content(saved.body, saved.contentType.empty() ? "application/json" : saved.contentType);
+            res.status = saved.status;
+            res.set_header("Idempotent-Replayed", "true");
+            break;
+        case IdempotencyStore::Outcome::IN_PROGRESS:
+            res.set_content(JsonHelper::errorResponse("A request with this Idempotency-Key is in progress"), "application/json");
+            res.status = 409;
+            res.set_header("Retry-After", "1");
+            break;
+        case IdempotencyStore::Outcome::MISMATCH:
+            res.set_content(JsonHelper::errorResponse("Idempotency-Key was already used for a different request"), "application/json");
+            res.status = 422;
+            break;
+    }
+    return httplib::Server::HandlerResponse::Handled;
+}
+
+// Save the response of a request that claimed a key. Server errors are not
+// saved, so the client's retry runs the request again.
+void recordIdempotentResponse(httplib::Response& res) {
+    if (pendingIdempotencyKey.empty()) return;
+    
+    if (res.status >= 500) {
+        idempotencyStore.abandon(pendingIdempotencyKey);
+    } else {
+        idempotencyStore.complete(pendingIdempotencyKey, res.status,
+                                  res.get_header_value("Content-Type"), res.body);
+    }
+    pendingIdempotencyKey.clear();
+}
+
+// Pre-routing hook: runs on every request, before the route handler
+httplib::Server::HandlerResponse preRoute(const httplib::Request& req, httplib::Response& res) {
+    pendingIdempotencyKey.clear();
+    restorePrimaryReads(req);
+    if (rejectWhileDatabaseDown(req, res) || rejectOverRateLimit(req, res) || rejectWhenSaturated(req, res)) {
+        return httplib::Server::HandlerResponse::Handled;
+    }
+    return checkIdempotencyKey(req, res);
+}
+
+// Post-routing hook: runs on every response, before it is written
+void finishResponse(const httplib::Request& req, httplib::Response& res) {
+    recordIdempotentResponse(res);
+    savePrimaryReads(res);
+    compressResponse(req, res);
+    releaseAdmission();
+}
+
+// ==================== CONDITIONAL GET ====================
+
+// Weak ETag for a whole table (valid across gzip/identity representations)
+std::string tableETag(TableId table) {
+    return "W/" + manager->getTableETag(table);
+}
+
+// Weak ETag for one row of a table
+std::string rowETag(TableId table, int id) {
+    std::string tag = tableETag(table);
+    return tag.substr(0, tag.size() - 1) + "-" + std::to_string(id) + "\"";
+}
+
+// Set the ETag header and answer 304 when If-None-Match already names it.
+// Returns true when the response is complete and the handler should stop.
+bool notModified(const httplib::Request& req, httplib::Response& res, const std::string& etag) {
+    res.set_header("ETag", etag);
+    if (!req.has_header("If-None-Match")) {
+        return false;
+    }
+    
+    // Weak comparison: ignore W/ prefixes on both sides
+    std::string opaque = etag.compare(0, 2, "W/") == 0 ? etag.substr(2) : etag;
+    std::string header = req.get_header_value("If-None-Match");
+    
+    size_t start = 0;
+    while (start < header.size()) {
+        size_t end = header.find(',', start);
+        if (end == std::string::npos) end = header.size();
+        
+        std::string candidate = header.substr(start, end - start);
+        start = end + 1;
+        
+        size_t first = candidate.find_first_not_of(" \t");
+        size_t last = candidate.find_last_not_of(" \t");
+        if (first == std::string::npos) continue;
+        candidate = candidate.substr(first, last - first + 1);
+        if (candidate.compare(0, 2, "W/") == 0) candidate = candidate.substr(2);
+        
+        if (candidate == "*" || candidate == opaque) {
+            res.status = 304;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==================== REQUEST COALESCING ====================
+
+// Body of a list response, built once for all identical requests in flight.
+// The key holds the table ETag, so a request arriving after a write never
+// joins a read that started before it, plus the whole target (path and
+// query) and whether this client's reads are pinned to the primary.
+SingleFlight::Result coalescedBody(const httplib::Request& req, const std::string& etag,
+                                   const std::function<std::string()>& build) {
+    std::string key = etag + " " + req.target;
+    if (requestPrimaryReadsUntil > nowMillis()) key += " primary";
+    bool joined = false;
+    return listFlights.run(key, build, joined);
+}
+
+// ==================== QUERY FILTERS ====================
+
+// The request's query string, decoded once with FormDecoder. Filters read
+// it instead of req.params: lookups return views into one buffer and
+// numbers are parsed in place with std::from_chars.
+FormDecoder decodeQuery(const httplib::Request& req) {
+    FormDecoder query;
+    size_t mark = req.target.find('?');
+    if (mark != std::string::npos) {
+        query.parse(std::string_view(req.target).substr(mark + 1));
+    }
+    return query;
+}
+
+// Parse all of text as a number
+template<typename T>
+bool parseWhole(std::string_view text, T& value) {
+    const char* last = text.data() + text.size();
+    auto result = std::from_chars(text.data(), last, value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == last;
+}
+
+// Add "column op value" to a filter when the query parameter is present.
+// Returns false (with error set) when the value is not a valid number.
+template<typename Column>
+bool filterInt(const FormDecoder& query, const char* name, QueryFilter<Column>& filter,
+               Column column, CompareOp op, std::string& error) {
+    const FormDecoder::Field* field = query.find(name);
+    if (!field) return true;
+    int value = 0;
+    if (!parseWhole(field->value, value)) {
+        error = std::string("Invalid integer for '") + name + "'";
+        return false;
+    }
+    filter.where(column, op, value);
+    return true;
+}
+
+template<typename Column>
+bool filterDouble(const FormDecoder& query, const char* name, QueryFilter<Column>& filter,
+                  Column column, CompareOp op, std::string& error) {
+    const FormDecoder::Field* field = query.find(name);
+    if (!field) return true;
+    double value = 0.0;
+    // from_chars accepts "nan" and "inf"; neither is a usable bound
+    if (!parseWhole(field->value, value) || !std::isfinite(value)) {
+        error = std::string("Invalid number for '") + name + "'";
+        return false;
+    }
+    filter.where(column, op, value);
+    return true;
+}
+
+template<typename Column>
+bool filterText(const FormDecoder& query, const char* name, QueryFilter<Column>& filter,
+                Column column, CompareOp op, std::string& /*error*/) {
+    if (const FormDecoder::Field* field = query.find(name)) {
+        filter.where(column, op, std::string(field->value));
+    }
+    return true;
+}
+
+// Like filterText, but the value must be a real YYYY-MM-DD date
+template<typename Column>
+bool filterDate(const FormDecoder& query, const char* name, QueryFilter<Column>& filter,
+                Column column, CompareOp op, std::string& error) {
+    const FormDecoder::Field* field = query.find(name);
+    if (!field) return true;
+    if (!isValidDate(field->value)) {
+        error = std::string("Invalid date for '") + name + "' (expected YYYY-MM-DD)";
+        return false;
+    }
+    filter.where(column, op, std::string(field->value));
+    return true;
+}
+
+// ?limit=n caps the number of rows returned
+template<typename Column>
+bool filterLimit(const FormDecoder& query, QueryFilter<Column>& filter, std::string& error) {
+    const FormDecoder::Field* field = query.find("limit");
+    if (!field) return true;
+    int limit = 0;
+    if (!parseWhole(field->value, limit)) {
+        error = "Invalid integer for 'limit'";
+        return false;
+    }
+    filter.limit(limit);
+    return true;
+}
+
+// ?ids=1,2,3: at most MAX_IDS positive IDs
+const size_t MAX_IDS = 100;
+
+bool parseIdList(std::string_view text, std::vector<int>& ids, std::string& error) {
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        int id = 0;
+        if (!parseWhole(text.substr(0, comma), id) || id <= 0) {
+            error = "Invalid ID list for 'ids'";
+            return false;
+        }
+        ids.push_back(id);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    if (ids.empty() || ids.size() > MAX_IDS) {
+        error = "'ids' takes 1 to " + std::to_string(MAX_IDS) + " IDs";
+        return false;
+    }
+    return true;
+}
+
+// Send a 400 for a bad filter parameter
+void badRequest(httplib::Response& res, const std::string& error) {
+    res.set_content(JsonHelper::errorResponse(error), "application/json");
+    res.status = 400;
+}
+
+// ==================== EMBEDDED RELATIONS ====================
+
+typedef std::unordered_map<int, std::string> MuscleGroupJson;
+
+// ?expand=muscle_group inlines each workout's muscle group; it is the only
+// relation that can be expanded so far
+bool parseExpand(const FormDecoder& query, bool& expand, std::string& error) {
+    const FormDecoder::Field* field = query.find("expand");
+    expand = field != nullptr;
+    if (field && field->value != "muscle_group") {
+        error = "Unknown expansion '" + std::string(field->value) + "' (expected muscle_group)";
+        return false;
+    }
+    return true;
+}
+
+// ETag of a workout response with muscle groups inlined: changes with either table
+std::string expandedETag(const std::string& etag, const std::string& groupsETag) {
+    return etag.substr(0, etag.size() - 1) + "+" + groupsETag.substr(3);
+}
+
+// JSON of the muscle groups with the referenced IDs. Groups cached for this
+// version of the table come from muscleGroupCache and the rest from one
+// IN (...) query, so expanding a page costs at most one query however many
+// workouts it holds. IDs of 0 (none) and groups that no longer exist are
+// left out.
+MuscleGroupJson loadMuscleGroups(const std::vector<int>& referenced, const std::string& groupsETag) {
+    std::vector<int> ids;
+    for (int id : referenced) {
+        if (id > 0 && std::find(ids.begin(), ids.end(), id) == ids.end()) {
+            ids.push_back(id);
+        }
+    }
+    
+    MuscleGroupJson groups;
+    std::vector<int> missing = muscleGroupCache.lookup(groupsETag, ids, groups);
+    if (!missing.empty()) {
+        ResultSet<MuscleGroup> loaded = manager->getMuscleGroupsByIds(missing);
+        for (size_t i = 0; i < loaded.size(); ++i) {
+            std::string json = JsonHelper::muscleGroupToJson(loaded[i]);
+            muscleGroupCache.store(groupsETag, loaded[i].getMuscleGroupId(), json);
+            groups.emplace(loaded[i].getMuscleGroupId(), std::move(json));
+        }
+    }
+    return groups;
+}
+
+// Write one workout with its muscle group from groups (null when absent)
+void writeExpandedWorkout(std::ostream& json, const Workout& workout, const MuscleGroupJson& groups) {
+    auto group = groups.find(workout.getMuscleGroupId());
+    JsonHelper::writeWorkout(json, workout, group != groups.end() ? &group->second : nullptr);
+}
+
+// Workouts as a JSON array with their muscle groups inlined
+std::string expandedWorkoutsJson(const ResultSet<Workout>& workouts, const std::string& groupsETag) {
+    std::vector<int> referenced;
+    referenced.reserve(workouts.size());
+    for (size_t i = 0; i < workouts.size(); ++i) {
+        referenced.push_back(workouts[i].getMuscleGroupId());
+    }
+    
+    MuscleGroupJson groups = loadMuscleGroups(referenced, groupsETag);
+    std::ostringstream json;
+    json << "[";
+    for (size_t i = 0; i < workouts.size(); ++i) {
+        if (i > 0) json << ",";
+        writeExpandedWorkout(json, workouts[i], groups);
+    }
+    json << "]";
+    return json.str();
+}
+
 // ==================== WORKOUT CONTROLLER ====================
 
 // GET /api/workouts - Get all workouts
@@ -78,13 +688,68 @@ void getAllWorkouts(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/workouts" << std::endl;
     
     try {
-        std::vector<Workout*> workouts = manager->getAllWorkouts();
-        std::string json = JsonHelper::workoutsToJsonArray(workouts);
+        FormDecoder query = decodeQuery(req);
+        std::string error;
+        bool expand = false;
+        if (!parseExpand(query, expand, error)) {
+            badRequest(res, error);
+            return;
+        }
+        
+        std::string groupsETag = expand ? tableETag(TableId::MUSCLE_GROUP) : "";
+        std::string etag = tableETag(TableId::WORKOUT);
+        if (expand) etag = expandedETag(etag, groupsETag);
+        if (notModified(req, res, etag)) {
+            return;
+        }
+        
+        // Rows to JSON, with muscle groups inlined when asked to
+        auto toJson = [&](const ResultSet<Workout>& workouts) {
+            return expand ? expandedWorkoutsJson(workouts, groupsETag)
+                          : JsonHelper::workoutsToJsonArray(workouts);
+        };
+        
+        // ?ids=1,2,3 reads exactly those workouts, in that order, with one query
+        if (query.has("ids")) {
+            std::vector<int> ids;
+            if (query.size() > (expand ? 2u : 1u)) {
+                badRequest(res, "'ids' can only be combined with 'expand'");
+                return;
+            }
+            if (!parseIdList(query.get("ids"), ids, error)) {
+                badRequest(res, error);
+                return;
+            }
+            SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+                return toJson(manager->getWorkoutsByIds(ids));
+            });
+            res.set_content(*json, "application/json");
+            res.status = 200;
+            return;
+        }
+        
+        WorkoutFilter filter;
+        if (!(filterDate(query, "from", filter, WorkoutColumn::DATE, CompareOp::GE, error) &&
+              filterDate(query, "to", filter, WorkoutColumn::DATE, CompareOp::LE, error) &&
+              filterInt(query, "min_rpe", filter, WorkoutColumn::RPE, CompareOp::GE, error) &&
+              filterInt(query, "max_rpe", filter, WorkoutColumn::RPE, CompareOp::LE, error) &&
+              filterDouble(query, "min_calories", filter, WorkoutColumn::CALORIES, CompareOp::GE, error) &&
+              filterDouble(query, "max_calories", filter, WorkoutColumn::CALORIES, CompareOp::LE, error) &&
+              filterInt(query, "min_duration", filter, WorkoutColumn::DURATION, CompareOp::GE, error) &&
+              filterInt(query, "muscle_group", filter, WorkoutColumn::MUSCLE_GROUP, CompareOp::EQ, error) &&
+              filterLimit(query, filter, error))) {
+            badRequest(res, error);
+            return;
+        }
         
-        // Cleanup
-        for (auto* w : workouts) delete w;
+        SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+            ResultSet<Workout> workouts = filter.isEmpty()
+                ? manager->getAllWorkouts()
+                : manager->getWorkoutsWhere(filter);
+            return toJson(workouts);
+        });
         
-        res.set_content(json, "application/json");
+        res.set_content(*json, "application/json");
         res.status = 200;
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -98,9 +763,31 @@ void getWorkoutById(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/workouts/" << id << std::endl;
     
     try {
+        FormDecoder query = decodeQuery(req);
+        std::string error;
+        bool expand = false;
+        if (!parseExpand(query, expand, error)) {
+            badRequest(res, error);
+            return;
+        }
+        
+        std::string groupsETag = expand ? tableETag(TableId::MUSCLE_GROUP) : "";
+        std::string etag = rowETag(TableId::WORKOUT, id);
+        if (notModified(req, res, expand ? expandedETag(etag, groupsETag) : etag)) {
+            return;
+        }
+        
         Workout* workout = manager->getWorkout(id);
         if (workout) {
-            std::string json = JsonHelper::workoutToJson(*workout);
+            std::string json;
+            if (expand) {
+                std::ostringstream expanded;
+                writeExpandedWorkout(expanded, *workout,
+                                     loadMuscleGroups({workout->getMuscleGroupId()}, groupsETag));
+                json = expanded.str();
+            } else {
+                json = JsonHelper::workoutToJson(*workout);
+            }
             delete workout;
             res.set_content(json, "application/json");
             res.status = 200;
@@ -159,12 +846,17 @@ void getAllMuscleGroups(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/musclegroups" << std::endl;
     
     try {
-        std::vector<MuscleGroup*> groups = manager->getAllMuscleGroups();
-        std::string json = JsonHelper::muscleGroupsToJsonArray(groups);
+        std::string etag = tableETag(TableId::MUSCLE_GROUP);
+        if (notModified(req, res, etag)) {
+            return;
+        }
         
-        for (auto* mg : groups) delete mg;
+        SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+            ResultSet<MuscleGroup> groups = manager->getAllMuscleGroups();
+            return JsonHelper::muscleGroupsToJsonArray(groups);
+        });
         
-        res.set_content(json, "application/json");
+        res.set_content(*json, "application/json");
         res.status = 200;
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -178,6 +870,10 @@ void getMuscleGroupById(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/musclegroups/" << id << std::endl;
     
     try {
+        if (notModified(req, res, rowETag(TableId::MUSCLE_GROUP, id))) {
+            return;
+        }
+        
         MuscleGroup* mg = manager->getMuscleGroup(id);
         if (mg) {
             std::string json = JsonHelper::muscleGroupToJson(*mg);
@@ -194,20 +890,62 @@ void getMuscleGroupById(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+// Read a muscle group from a JSON body. Fields left out keep the endpoint's
+// demo values; a muscle_group_id above 0 updates that group.
+bool parseMuscleGroup(const std::string& json, MuscleGroup& mg, std::string& error) {
+    int id = 0, days = 2, sets = 3, reps = 12;
+    double weight = 50.0;
+    std::string name = "API Test Muscle", description = "Test muscle group from API";
+    JsonHelper::getInt(json, "muscle_group_id", id);
+    JsonHelper::getString(json, "name", name);
+    JsonHelper::getString(json, "description", description);
+    JsonHelper::getInt(json, "days_per_week", days);
+    JsonHelper::getInt(json, "sets", sets);
+    JsonHelper::getInt(json, "reps", reps);
+    JsonHelper::getNumber(json, "weight_amount", weight);
+    
+    if (name.empty()) {
+        error = "name must not be empty";
+        return false;
+    }
+    if (id < 0 || days < 0 || days > 7 || sets < 0 || reps < 0 || weight < 0.0) {
+        error = "days_per_week must be 0-7; sets, reps and weight_amount not negative";
+        return false;
+    }
+    
+    mg = MuscleGroup(id, name, description, days, sets, reps, weight);
+    return true;
+}
+
+// A save that failed because the name is taken is the client's to fix
+void saveFailed(httplib::Response& res, const std::string& entity, const std::string& name) {
+    if (manager->isDuplicateName()) {
+        res.set_content(JsonHelper::errorResponse("The " + entity + " name '" + name + "' is already in use"), "application/json");
+        res.status = 409;
+        return;
+    }
+    res.set_content(JsonHelper::errorResponse("Failed to save " + entity), "application/json");
+    res.status = 500;
+}
+
 // POST /api/musclegroups - Save muscle group
 void saveMuscleGroup(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] POST /api/musclegroups" << std::endl;
     
     try {
-        MuscleGroup mg(0, "API Test Muscle", "Test muscle group from API", 2, 3, 12, 50.0);
+        MuscleGroup mg;
+        std::string error;
+        if (!parseMuscleGroup(req.body, mg, error)) {
+            badRequest(res, error);
+            return;
+        }
         bool success = manager->saveMuscleGroup(mg);
         
         if (success) {
             res.set_content(JsonHelper::successResponse("MuscleGroup saved", mg.getMuscleGroupId()), "application/json");
             res.status = 200;
         } else {
-            res.set_content(JsonHelper::errorResponse("Failed to save muscle group"), "application/json");
-            res.status = 500;
+            saveFailed(res, "muscle group", mg.getName());
         }
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -222,12 +960,32 @@ void getAllNutrition(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/nutrition" << std::endl;
     
     try {
-        std::vector<Nutrition*> nutrition = manager->getAllNutrition();
-        std::string json = JsonHelper::nutritionToJsonArray(nutrition);
+        std::string etag = tableETag(TableId::NUTRITION);
+        if (notModified(req, res, etag)) {
+            return;
+        }
         
-        for (auto* n : nutrition) delete n;
+        FormDecoder query = decodeQuery(req);
+        NutritionFilter filter;
+        std::string error;
+        if (!(filterDate(query, "from", filter, NutritionColumn::DATE, CompareOp::GE, error) &&
+              filterDate(query, "to", filter, NutritionColumn::DATE, CompareOp::LE, error) &&
+              filterText(query, "family", filter, NutritionColumn::FAMILY, CompareOp::EQ, error) &&
+              filterDouble(query, "min_protein", filter, NutritionColumn::PROTEIN, CompareOp::GE, error) &&
+              filterDouble(query, "max_sugar", filter, NutritionColumn::SUGAR, CompareOp::LE, error) &&
+              filterLimit(query, filter, error))) {
+            badRequest(res, error);
+            return;
+        }
         
-        res.set_content(json, "application/json");
+        SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+            ResultSet<Nutrition> nutrition = filter.isEmpty()
+                ? manager->getAllNutrition()
+                : manager->getNutritionWhere(filter);
+            return JsonHelper::nutritionToJsonArray(nutrition);
+        });
+        
+        res.set_content(*json, "application/json");
         res.status = 200;
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -241,6 +999,10 @@ void getNutritionById(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/nutrition/" << id << std::endl;
     
     try {
+        if (notModified(req, res, rowETag(TableId::NUTRITION, id))) {
+            return;
+        }
+        
         Nutrition* nutrition = manager->getNutrition(id);
         if (nutrition) {
             std::string json = JsonHelper::nutritionToJson(*nutrition);
@@ -285,12 +1047,31 @@ void getAllRecovery(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/recovery" << std::endl;
     
     try {
-        std::vector<Recovery*> recovery = manager->getAllRecovery();
-        std::string json = JsonHelper::recoveryToJsonArray(recovery);
+        std::string etag = tableETag(TableId::RECOVERY);
+        if (notModified(req, res, etag)) {
+            return;
+        }
         
-        for (auto* r : recovery) delete r;
+        FormDecoder query = decodeQuery(req);
+        RecoveryFilter filter;
+        std::string error;
+        if (!(filterDate(query, "from", filter, RecoveryColumn::DATE, CompareOp::GE, error) &&
+              filterDate(query, "to", filter, RecoveryColumn::DATE, CompareOp::LE, error) &&
+              filterText(query, "type", filter, RecoveryColumn::TYPE, CompareOp::EQ, error) &&
+              filterInt(query, "min_duration", filter, RecoveryColumn::DURATION, CompareOp::GE, error) &&
+              filterLimit(query, filter, error))) {
+            badRequest(res, error);
+            return;
+        }
         
-        res.set_content(json, "application/json");
+        SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+            ResultSet<Recovery> recovery = filter.isEmpty()
+                ? manager->getAllRecovery()
+                : manager->getRecoveryWhere(filter);
+            return JsonHelper::recoveryToJsonArray(recovery);
+        });
+        
+        res.set_content(*json, "application/json");
         res.status = 200;
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -304,6 +1085,10 @@ void getRecoveryById(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/recovery/" << id << std::endl;
     
     try {
+        if (notModified(req, res, rowETag(TableId::RECOVERY, id))) {
+            return;
+        }
+        
         Recovery* recovery = manager->getRecovery(id);
         if (recovery) {
             std::string json = JsonHelper::recoveryToJson(*recovery);
@@ -348,12 +1133,29 @@ void getAllEquipment(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/equipment" << std::endl;
     
     try {
-        std::vector<Equipment*> equipment = manager->getAllEquipment();
-        std::string json = JsonHelper::equipmentToJsonArray(equipment);
+        std::string etag = tableETag(TableId::EQUIPMENT);
+        if (notModified(req, res, etag)) {
+            return;
+        }
         
-        for (auto* e : equipment) delete e;
+        FormDecoder query = decodeQuery(req);
+        EquipmentFilter filter;
+        std::string error;
+        if (!(filterText(query, "category", filter, EquipmentColumn::CATEGORY, CompareOp::EQ, error) &&
+              filterText(query, "target", filter, EquipmentColumn::TARGET, CompareOp::EQ, error) &&
+              filterLimit(query, filter, error))) {
+            badRequest(res, error);
+            return;
+        }
         
-        res.set_content(json, "application/json");
+        SingleFlight::Result json = coalescedBody(req, etag, [&]() {
+            ResultSet<Equipment> equipment = filter.isEmpty()
+                ? manager->getAllEquipment()
+                : manager->getEquipmentWhere(filter);
+            return JsonHelper::equipmentToJsonArray(equipment);
+        });
+        
+        res.set_content(*json, "application/json");
         res.status = 200;
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -367,6 +1169,10 @@ void getEquipmentById(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] GET /api/equipment/" << id << std::endl;
     
     try {
+        if (notModified(req, res, rowETag(TableId::EQUIPMENT, id))) {
+            return;
+        }
+        
         Equipment* equipment = manager->getEquipment(id);
         if (equipment) {
             std::string json = JsonHelper::equipmentToJson(*equipment);
@@ -383,20 +1189,45 @@ void getEquipmentById(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+// Read equipment from a JSON body. Fields left out keep the endpoint's demo
+// values; an equipment_id above 0 updates that entry.
+bool parseEquipment(const std::string& json, Equipment& equipment, std::string& error) {
+    int id = 0;
+    std::string name = "API Test Equipment", description = "Test equipment from API";
+    std::string category = "Test Category", target = "Test Target";
+    JsonHelper::getInt(json, "equipment_id", id);
+    JsonHelper::getString(json, "name", name);
+    JsonHelper::getString(json, "description", description);
+    JsonHelper::getString(json, "category", category);
+    JsonHelper::getString(json, "target", target);
+    
+    if (name.empty() || id < 0) {
+        error = "name must not be empty";
+        return false;
+    }
+    
+    equipment = Equipment(id, name, description, category, target);
+    return true;
+}
+
 // POST /api/equipment - Save equipment
 void saveEquipment(const httplib::Request& req, httplib::Response& res) {
     std::cout << "[API] POST /api/equipment" << std::endl;
     
     try {
-        Equipment equipment(0, "API Test Equipment", "Test equipment from API", "Test Category", "Test Target");
+        Equipment equipment;
+        std::string error;
+        if (!parseEquipment(req.body, equipment, error)) {
+            badRequest(res, error);
+            return;
+        }
         bool success = manager->saveEquipment(equipment);
         
         if (success) {
             res.set_content(JsonHelper::successResponse("Equipment saved", equipment.getEquipmentId()), "application/json");
             res.status = 200;
         } else {
-            res.set_content(JsonHelper::errorResponse("Failed to save equipment"), "application/json");
-            res.status = 500;
+            saveFailed(res, "equipment", equipment.getName());
         }
     } catch (const std::exception& e) {
         res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
@@ -521,6 +1352,419 @@ void deleteEquipment(const httplib::Request& req, httplib::Response& res) {
     }
 }
 
+// ==================== WRITE-BEHIND INGEST ====================
+
+// Read a workout from a JSON object; date, time and duration are required, and
+// the checks are the ones validateWorkouts and WorkoutService apply
+bool parseWorkout(const std::string& json, Workout& workout, std::string& error) {
+    std::string date, time, type;
+    int duration = 0, rpe = 0, muscleGroupId = 0;
+    double calories = 0.0;
+    if (!JsonHelper::getString(json, "workout_date", date) ||
+        !JsonHelper::getString(json, "workout_time", time) ||
+        !JsonHelper::getInt(json, "duration", duration)) {
+        error = "workout requires workout_date, workout_time and duration";
+        return false;
+    }
+    JsonHelper::getString(json, "type_description", type);
+    JsonHelper::getNumber(json, "calories_burned", calories);
+    JsonHelper::getInt(json, "rate_perceived_exhaustion", rpe);
+    JsonHelper::getInt(json, "muscle_group_id", muscleGroupId);
+    
+    if (!isValidDate(date)) {
+        error = "workout_date must be YYYY-MM-DD";
+        return false;
+    }
+    if (!isValidTime(time)) {
+        error = "workout_time must be HH:MM:SS";
+        return false;
+    }
+    if (!isValidRPE(rpe)) {
+        error = "RPE must be between 1 and 10";
+        return false;
+    }
+    if (duration <= 0 || calories < 0.0 || muscleGroupId < 0) {
+        error = "duration must be positive, calories_burned not negative";
+        return false;
+    }
+    
+    workout = Workout(0, date, time, duration, type, calories, rpe, muscleGroupId);
+    return true;
+}
+
+// {"ticket":12,"status":"committed","workout_id":345}
+std::string ticketJson(unsigned long long ticket, const WriteBehindQueue::Status& status) {
+    std::ostringstream json;
+    json << "{\"ticket\":" << ticket << ",\"status\":\"" << WriteBehindQueue::stateName(status.state)
+         << "\",\"workout_id\":" << status.workoutId << "}";
+    return json.str();
+}
+
+// Group-commit a batch through the flusher's own manager
+WriteBehindQueue::FlushResult flushWorkouts(std::vector<Workout>& batch) {
+    if (flushManager->createWorkouts(batch)) {
+        manager->noteWrite(TableId::WORKOUT);
+        return WriteBehindQueue::FlushResult::WRITTEN;
+    }
+    // Failures with no connection problem behind them are bad rows
+    return flushDao && flushDao->getCircuitBreaker().getConsecutiveFailures() > 0
+        ? WriteBehindQueue::FlushResult::UNAVAILABLE
+        : WriteBehindQueue::FlushResult::REJECTED;
+}
+
+// POST /api/workouts in write-behind mode: validate, queue durably, answer 202
+void queueWorkout(const httplib::Request& req, httplib::Response& res) {
+    std::cout << "[API] POST /api/workouts (write-behind)" << std::endl;
+    
+    Workout workout;
+    std::string error;
+    if (!parseWorkout(req.body, workout, error)) {
+        badRequest(res, error);
+        return;
+    }
+    
+    unsigned long long ticket = 0;
+    switch (writeBehind.enqueue(workout, ticket)) {
+        case WriteBehindQueue::Admission::QUEUED: {
+            WriteBehindQueue::Status status;
+            status.state = WriteBehindQueue::State::QUEUED;
+            res.set_content(ticketJson(ticket, status), "application/json");
+            res.set_header("Location", "/api/tickets/" + std::to_string(ticket));
+            res.status = 202;
+            break;
+        }
+        case WriteBehindQueue::Admission::FULL:
+            res.set_content(JsonHelper::errorResponse("Ingest queue is full, retry later"), "application/json");
+            res.set_header("Retry-After", "1");
+            res.status = 503;
+            break;
+        case WriteBehindQueue::Admission::LOG_ERROR:
+            res.set_content(JsonHelper::errorResponse("Could not queue workout"), "application/json");
+            res.status = 500;
+            break;
+    }
+}
+
+// GET /api/tickets/:ticket - outcome of a queued workout
+void getTicketStatus(const httplib::Request& req, httplib::Response& res) {
+    unsigned long long ticket = std::strtoull(req.path_params.at("ticket").c_str(), nullptr, 10);
+    WriteBehindQueue::Status status = writeBehind.getStatus(ticket);
+    
+    if (status.state == WriteBehindQueue::State::UNKNOWN) {
+        res.set_content(JsonHelper::errorResponse("Unknown ticket"), "application/json");
+        res.status = 404;
+        return;
+    }
+    res.set_content(ticketJson(ticket, status), "application/json");
+    res.status = 200;
+}
+
+// ==================== TRAINING DAY CONTROLLER ====================
+
+// Build the day's entities from a POST /api/days body. Returns false with an
+// error message when a section is present but incomplete.
+bool parseDay(const std::string& body, std::unique_ptr<Workout>& workout,
+              std::vector<Nutrition>& meals, std::unique_ptr<Recovery>& recovery,
+              std::string& error) {
+    std::string section;
+    
+    if (JsonHelper::getObject(body, "workout", section)) {
+        workout.reset(new Workout());
+        if (!parseWorkout(section, *workout, error)) {
+            return false;
+        }
+    }
+    
+    std::vector<std::string> entries;
+    JsonHelper::getObjectArray(body, "nutrition", entries);
+    for (const std::string& entry : entries) {
+        std::string family, date;
+        double water = 0.0, carbs = 0.0, fat = 0.0, protein = 0.0, sugar = 0.0;
+        if (!JsonHelper::getString(entry, "family", family)) {
+            error = "each nutrition entry requires family";
+            return false;
+        }
+        JsonHelper::getString(entry, "meal_date", date);
+        JsonHelper::getNumber(entry, "water", water);
+        JsonHelper::getNumber(entry, "carbs", carbs);
+        JsonHelper::getNumber(entry, "fat", fat);
+        JsonHelper::getNumber(entry, "protein", protein);
+        JsonHelper::getNumber(entry, "sugar", sugar);
+        
+        Nutrition meal(0, FoodFamily::MIXED, water, carbs, fat, protein, sugar, date);
+        meal.setFamilyFromString(family);
+        meals.push_back(meal);
+    }
+    
+    if (JsonHelper::getObject(body, "recovery", section)) {
+        std::string date, type, helpers;
+        int duration = 0;
+        if (!JsonHelper::getString(section, "recovery_date", date) ||
+            !JsonHelper::getInt(section, "duration", duration)) {
+            error = "recovery requires recovery_date and duration";
+            return false;
+        }
+        JsonHelper::getString(section, "type", type);
+        JsonHelper::getString(section, "helpers", helpers);
+        recovery.reset(new Recovery(0, date, duration, type, helpers));
+    }
+    
+    if (!workout && meals.empty() && !recovery) {
+        error = "Nothing to log: provide workout, nutrition and/or recovery";
+        return false;
+    }
+    return true;
+}
+
+// POST /api/days - Log a workout, meals and recovery session in one transaction
+// Body: {"client_key":"...","workout":{...},"nutrition":[{...}],"recovery":{...}}
+void logDay(const httplib::Request& req, httplib::Response& res) {
+    std::cout << "[API] POST /api/days" << std::endl;
+    
+    try {
+        std::string clientKey;
+        JsonHelper::getString(req.body, "client_key", clientKey);
+        if (clientKey.size() > 64) {
+            badRequest(res, "client_key must be at most 64 characters");
+            return;
+        }
+        
+        std::unique_ptr<Workout> workout;
+        std::vector<Nutrition> meals;
+        std::unique_ptr<Recovery> recovery;
+        std::string error;
+        if (!parseDay(req.body, workout, meals, recovery, error)) {
+            badRequest(res, error);
+            return;
+        }
+        
+        // A retry must resend the same body; the key is stored with a hash
+        // of it, as for Idempotency-Key
+        DayLogResult result;
+        std::string fingerprint = IdempotencyStore::fingerprint(req.method, req.path, req.body);
+        if (!manager->logDay(clientKey, fingerprint, workout.get(), meals, recovery.get(), result)) {
+            if (result.mismatch) {
+                res.set_content(JsonHelper::errorResponse("client_key was already used for a different request"),
+                                "application/json");
+                res.status = 422;
+                return;
+            }
+            res.set_content(JsonHelper::errorResponse("Failed to log day"), "application/json");
+            res.status = 500;
+            return;
+        }
+        
+        std::ostringstream json;
+        json << "{\"success\":true,\"replayed\":" << (result.replayed ? "true" : "false");
+        json << ",\"workout_id\":" << result.workoutId;
+        json << ",\"nutrition_ids\":[";
+        for (size_t i = 0; i < result.nutritionIds.size(); ++i) {
+            if (i > 0) json << ",";
+            json << result.nutritionIds[i];
+        }
+        json << "],\"recovery_id\":" << result.recoveryId << "}";
+        
+        res.set_content(json.str(), "application/json");
+        res.status = result.replayed ? 200 : 201;
+    } catch (const std::exception& e) {
+        res.set_content(JsonHelper::errorResponse(e.what()), "application/json");
+        res.status = 500;
+    }
+}
+
+// ==================== BATCH CONTROLLER ====================
+
+const size_t MAX_BATCH_REQUESTS = 20;
+
+// Collections a batch can read, with the handlers a direct GET would use
+struct BatchRoute {
+    const char* collection;
+    void (*list)(const httplib::Request&, httplib::Response&);
+    void (*byId)(const httplib::Request&, httplib::Response&);
+};
+
+const BatchRoute batchRoutes[] = {
+    {"workouts", getAllWorkouts, getWorkoutById},
+    {"musclegroups", getAllMuscleGroups, getMuscleGroupById},
+    {"nutrition", getAllNutrition, getNutritionById},
+    {"recovery", getAllRecovery, getRecoveryById},
+    {"equipment", getAllEquipment, getEquipmentById}
+};
+
+// Run one sub-request ("/api/workouts/3", "/api/nutrition?from=...")
+// through the matching GET handler
+void runBatchItem(const httplib::Request& outer, const std::string& method, const std::string& target,
+                  httplib::Response& res) {
+    if (method != "GET") {
+        res.set_content(JsonHelper::errorResponse("Only GET requests can be batched"), "application/json");
+        res.status = 405;
+        return;
+    }
+    
+    httplib::Request sub;
+    sub.method = "GET";
+    sub.target = target;
+    sub.path = target.substr(0, target.find('?'));
+    sub.remote_addr = outer.remote_addr;
+    
+    // Each request in a batch costs what it would cost on its own
+    if (rateLimiter.isEnabled() && !spendToken(clientKey(outer), classifyRequest(sub), res)) {
+        return;
+    }
+    
+    std::string_view rest(sub.path);
+    if (rest.compare(0, 5, "/api/") == 0) {
+        rest.remove_prefix(5);
+        size_t slash = rest.find('/');
+        std::string_view collection = rest.substr(0, slash);
+        std::string_view idText = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+        
+        for (const BatchRoute& route : batchRoutes) {
+            if (collection != route.collection) continue;
+            if (slash == std::string_view::npos) {
+                route.list(sub, res);
+                return;
+            }
+            int id = 0;
+            if (parseWhole(idText, id) && id > 0) {
+                sub.path_params["id"] = std::string(idText);
+                route.byId(sub, res);
+                return;
+            }
+        }
+    }
+    res.set_content(JsonHelper::errorResponse("Unknown path: " + target), "application/json");
+    res.status = 404;
+}
+
+// POST /api/batch - Several GETs in one call
+// Body: {"requests":[{"method":"GET","path":"/api/workouts/1"},{"path":"/api/musclegroups/2"}]}
+// Reply: {"responses":[{"status":200,"body":{...}},...]} in request order
+void runBatch(const httplib::Request& req, httplib::Response& res) {
+    std::cout << "[API] POST /api/batch" << std::endl;
+    
+    std::vector<std::string> items;
+    if (!JsonHelper::getObjectArray(req.body, "requests", items) || items.empty()) {
+        badRequest(res, "Body must be {\"requests\":[{\"method\":\"GET\",\"path\":\"/api/...\"}]}");
+        return;
+    }
+    if (items.size() > MAX_BATCH_REQUESTS) {
+        badRequest(res, "A batch takes at most " + std::to_string(MAX_BATCH_REQUESTS) + " requests");
+        return;
+    }
+    
+    // The batch reports the rate limit budget left after its last request
+    const char* const rateHeaders[] = {"RateLimit-Limit", "RateLimit-Remaining", "RateLimit-Reset", "RateLimit-Policy"};
+    std::string rateValues[4];
+    
+    // Each sub-response body is JSON already: splice it in as-is
+    std::string json = "{\"responses\":[";
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::string method = "GET";
+        std::string path;
+        JsonHelper::getString(items[i], "method", method);
+        
+        httplib::Response sub;
+        if (JsonHelper::getString(items[i], "path", path)) {
+            runBatchItem(req, method, path, sub);
+        } else {
+            sub.set_content(JsonHelper::errorResponse("Missing path"), "application/json");
+            sub.status = 400;
+        }
+        for (int h = 0; h < 4; ++h) {
+            if (sub.has_header(rateHeaders[h])) rateValues[h] = sub.get_header_value(rateHeaders[h]);
+        }
+        
+        if (i > 0) json += ",";
+        json += "{\"status\":" + std::to_string(sub.status) + ",\"body\":";
+        json += sub.body.empty() ? "null" : sub.body;
+        json += "}";
+    }
+    json += "]}";
+    
+    for (int h = 0; h < 4; ++h) {
+        if (!rateValues[h].empty()) res.set_header(rateHeaders[h], rateValues[h]);
+    }
+    res.set_content(json, "application/json");
+    res.status = 200;
+}
+
+// ==================== CHANGE STREAM ====================
+
+// Comment line sent when nothing happened for a while, so proxies keep the
+// connection open and a client that went away is noticed
+const std::chrono::milliseconds STREAM_HEARTBEAT(15000);
+
+// Collection of a table, as named in its REST path
+const char* collectionName(TableId table) {
+    switch (table) {
+        case TableId::WORKOUT:      return "workouts";
+        case TableId::MUSCLE_GROUP: return "musclegroups";
+        case TableId::NUTRITION:    return "nutrition";
+        case TableId::RECOVERY:     return "recovery";
+        default:                    return "equipment";
+    }
+}
+
+const char* changeKindName(ChangeKind kind) {
+    switch (kind) {
+        case ChangeKind::CREATED: return "created";
+        case ChangeKind::UPDATED: return "updated";
+        default:                  return "deleted";
+    }
+}
+
+// Change listener of the managers: one "change" event per write
+void publishChange(const ChangeEvent& change) {
+    if (!changeStream.isEnabled()) return;
+    changeStream.publish("change", std::string("{\"table\":\"") + collectionName(change.table) +
+                                   "\",\"op\":\"" + changeKindName(change.kind) +
+                                   "\",\"id\":" + std::to_string(change.id) + "}");
+}
+
+// GET /api/stream - Server-Sent Events feed of creates, updates and deletes.
+// Each event names the collection, the operation and the row ID; a
+// "resync" event means events were dropped and the client should refetch.
+void streamChanges(const httplib::Request& req, httplib::Response& res) {
+    std::cout << "[API] GET /api/stream" << std::endl;
+    
+    EventStream::SubscriberPtr subscriber = changeStream.isEnabled()
+        ? changeStream.subscribe(req.get_header_value("Last-Event-ID"))
+        : nullptr;
+    if (!subscriber) {
+        res.set_content(JsonHelper::errorResponse("Too many stream subscribers"), "application/json");
+        res.status = 503;
+        res.set_header("Retry-After", "5");
+        return;
+    }
+    
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Accel-Buffering", "no");   // nginx: pass events through unbuffered
+    res.set_chunked_content_provider("text/event-stream",
+        [subscriber](size_t offset, httplib::DataSink& sink) {
+            // Clients reconnect after 3 s, sending the last ID they saw
+            std::string chunk = offset == 0 ? "retry: 3000\n\n" : "";
+            StreamEvent event;
+            switch (subscriber->next(STREAM_HEARTBEAT, event)) {
+                case EventStream::Subscriber::EVENT:
+                    chunk += changeStream.format(event);
+                    break;
+                case EventStream::Subscriber::RESYNC:
+                    event.type = "resync";
+                    event.data = "{}";
+                    chunk += changeStream.format(event);
+                    break;
+                case EventStream::Subscriber::IDLE:
+                    chunk += ": keepalive\n\n";
+                    break;
+            }
+            return sink.write(chunk.data(), chunk.size());
+        },
+        [subscriber](bool) {
+            changeStream.unsubscribe(subscriber);
+        });
+}
+
 // ==================== MAIN SERVER ====================
 
 int main() {
@@ -531,7 +1775,14 @@ int main() {
     
     // Initialize database connection
     std::cout << "[INIT] Connecting to database..." << std::endl;
-    dao = std::make_unique<WorkoutDAO>("localhost", "workout_user", "workout_pass", "workout_tracker");
+    // WORKOUT_DB_HOST/WORKOUT_DB_PORT name the primary; read replicas come
+    // from WORKOUT_DB_REPLICAS (see ConnectionPolicy.h). WORKOUT_STORAGE=local
+    // replaces MySQL with the embedded store (see LocalStoreDAO.h).
+    const char* dbHost = std::getenv("WORKOUT_DB_HOST");
+    const char* dbPort = std::getenv("WORKOUT_DB_PORT");
+    StorageConfig storage = StorageConfig::fromEnvironment();
+    dao = createWorkoutDAO(dbHost ? dbHost : "localhost", "workout_user", "workout_pass",
+                           "workout_tracker", dbPort ? std::atoi(dbPort) : 3306);
     manager = std::make_unique<WorkoutManager>(dao.get());
     
     if (!manager->testConnection()) {
@@ -539,22 +1790,71 @@ int main() {
         return 1;
     }
     std::cout << "[INIT] Database connected successfully!" << std::endl;
+    if (dao->getReplicaCount() > 0) {
+        std::cout << "[INIT] Routing reads to " << dao->getReplicaCount() << " replica(s)" << std::endl;
+    }
+    
+    // How often to look for writes made outside this server (ms, 0 = never)
+    if (const char* interval = std::getenv("WORKOUT_ETAG_CHECK_MS")) {
+        manager->setExternalCheckInterval(std::atoi(interval));
+    }
     std::cout << std::endl;
     
-    // Create HTTP server
+    // Push every write made through the managers to GET /api/stream
+    changeStream.configure(StreamConfig::fromEnvironment(), std::to_string(std::time(nullptr)));
+    manager->setChangeListener(publishChange);
+    
+    // Create HTTP server. Each stream subscriber keeps a worker thread for as
+    // long as it is connected, so the pool gets one extra thread per subscriber.
     httplib::Server svr;
+    size_t workerThreads = CPPHTTPLIB_THREAD_POOL_COUNT + changeStream.getMaxSubscribers();
+    svr.new_task_queue = [workerThreads] { return new httplib::ThreadPool(workerThreads); };
+    
+    // Fail fast while the database is down, a client is over its budget or the
+    // server is saturated, and replay responses for retried POSTs that carry
+    // an Idempotency-Key
+    idempotencyStore.configure(dao.get(), IdempotencyConfig::fromEnvironment());
+    admission.configure(AdmissionConfig::fromEnvironment());
+    rateLimiter.configure(RateLimitConfig::fromEnvironment());
+    svr.set_pre_routing_handler(preRoute);
+    
+    // Compress large JSON/HTML responses for clients that accept it
+    compressionConfig = CompressionConfig::fromEnvironment();
+    svr.set_post_routing_handler(finishResponse);
+    
+    // Optionally accept POST /api/workouts into a durable queue (202 + ticket)
+    writeBehindConfig = WriteBehindConfig::fromEnvironment();
+    if (writeBehindConfig.enabled) {
+        // The local store is thread-safe and single-process, so the flusher shares it
+        if (!storage.local) {
+            flushDao = std::make_unique<WorkoutDAO>(dbHost ? dbHost : "localhost", "workout_user", "workout_pass",
+                                                    "workout_tracker", dbPort ? std::atoi(dbPort) : 3306);
+        }
+        flushManager = std::make_unique<WorkoutManager>(flushDao ? flushDao.get() : dao.get());
+        flushManager->setChangeListener(publishChange);
+        if (writeBehind.start(writeBehindConfig, flushWorkouts)) {
+            std::cout << "[INIT] Write-behind queue at " << writeBehindConfig.logPath
+                      << " (" << writeBehind.getDepth() << " pending)" << std::endl;
+        } else {
+            std::cerr << "[ERROR] Cannot open " << writeBehindConfig.logPath
+                      << ", POST /api/workouts stays synchronous" << std::endl;
+        }
+    }
     
     // Enable CORS for web clients
     svr.set_default_headers({
         {"Access-Control-Allow-Origin", "*"},
         {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS"},
-        {"Access-Control-Allow-Headers", "Content-Type"}
+        {"Access-Control-Allow-Headers", "Content-Type, If-None-Match, Idempotency-Key, X-API-Key, Last-Event-ID"},
+        {"Access-Control-Expose-Headers",
+         "ETag, Idempotent-Replayed, Retry-After, RateLimit-Limit, RateLimit-Remaining, RateLimit-Reset, RateLimit-Policy"}
     });
     
     // Register Workout endpoints
     svr.Get("/api/workouts", getAllWorkouts);
     svr.Get("/api/workouts/:id", getWorkoutById);
-    svr.Post("/api/workouts", saveWorkout);
+    svr.Post("/api/workouts", writeBehind.isRunning() ? queueWorkout : saveWorkout);
+    svr.Get("/api/tickets/:ticket", getTicketStatus);
     
     // Register MuscleGroup endpoints
     svr.Get("/api/musclegroups", getAllMuscleGroups);
@@ -576,10 +1876,17 @@ int main() {
     svr.Get("/api/equipment/:id", getEquipmentById);
     svr.Post("/api/equipment", saveEquipment);
     
+    // Training day (workout + meals + recovery in one transaction)
+    svr.Post("/api/days", logDay);
+    
+    // Several GETs in one round trip
+    svr.Post("/api/batch", runBatch);
+    
+    // Live feed of changes (Server-Sent Events)
+    svr.Get("/api/stream", streamChanges);
+    
     // Health check endpoint
-    svr.Get("/health", [](const httplib::Request&, httplib::Response& res) {
-        res.set_content("{\"status\":\"healthy\"}", "application/json");
-    });
+    svr.Get("/health", healthCheck);
 
     // Register DELETE endpoints
     svr.Delete("/api/workouts/:id", deleteWorkout);
@@ -598,7 +1905,7 @@ int main() {
 <h1>Workout Tracking System REST API</h1>
 <h2>Available Endpoints:</h2>
 <ul>
-<li>GET /api/workouts - Get all workouts</li>
+<li>GET /api/workouts - Get all workouts (?ids=1,2,3 for several by ID)</li>
 <li>GET /api/workouts/:id - Get workout by ID</li>
 <li>POST /api/workouts - Save workout</li>
 <li>DELETE /api/workouts/:id - Delete workout</li>
@@ -617,6 +1924,10 @@ int main() {
 <li>GET /api/equipment/:id - Get equipment by ID</li>
 <li>POST /api/equipment - Save equipment</li>
 <li>DELETE /api/equipment/:id - Delete equipment</li>
+<li>POST /api/days - Log workout, meals and recovery together</li>
+<li>POST /api/batch - Run several GETs in one call</li>
+<li>GET /api/stream - Live feed of changes (Server-Sent Events)</li>
+<li>GET /api/tickets/:ticket - Status of a queued workout (write-behind mode)</li>
 <li>GET /health - Health check</li>
 </ul>
 </body>
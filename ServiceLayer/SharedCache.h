@@ -0,0 +1,318 @@
+// SharedCache.h
+// Cross-process result cache in POSIX shared memory (CGI workers)
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef SHAREDCACHE_H
+#define SHAREDCACHE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Settings, overridable through environment variables:
+//   WORKOUT_CGI_CACHE       set to 1 to share rendered pages between CGI processes (default off)
+//   WORKOUT_CGI_CACHE_NAME  shared memory object (default /workout_cgi_cache)
+//   WORKOUT_CGI_CACHE_TTL   seconds an entry may be served (default 30); bounds staleness
+//                           after writes the CGI does not see (REST server, mysql client)
+struct SharedCacheConfig {
+    bool enabled = false;
+    std::string name = "/workout_cgi_cache";
+    int ttlSeconds = 30;
+
+    static SharedCacheConfig fromEnvironment() {
+        SharedCacheConfig config;
+        const char* enabled = std::getenv("WORKOUT_CGI_CACHE");
+        const char* name = std::getenv("WORKOUT_CGI_CACHE_NAME");
+        const char* ttl = std::getenv("WORKOUT_CGI_CACHE_TTL");
+
+        config.enabled = enabled && std::string(enabled) == "1";
+        if (name && *name == '/') config.name = name;
+        if (ttl && std::atoi(ttl) > 0) config.ttlSeconds = std::atoi(ttl);
+        return config;
+    }
+};
+
+/*
+ * A fixed-size open-addressing table of string results, mapped by every
+ * process that opens the same shared memory object, so one CGI request can
+ * reuse what another one computed.
+ *
+ * Each slot is guarded by a seqlock: a writer makes the sequence odd (CAS),
+ * fills the slot and makes it even again; a reader copies the slot and keeps
+ * the copy only if the sequence was even and unchanged. Readers never block
+ * and never write. Writers that lose the CAS simply do not cache. A writer
+ * killed mid-store leaves its slot odd; after a second another writer may
+ * take it over.
+ *
+ * Invalidation: the segment holds one version counter per table. An entry
+ * records the counters of the tables it was built from, taken *before* the
+ * data was read (stamp()), and is served only while they are unchanged.
+ * invalidate() after a write bumps the counters, which retires every
+ * dependent entry at once.
+ *
+ * A key probes PROBE_LENGTH consecutive slots; a store reuses the key's
+ * slot, an empty or dead one, or evicts the oldest. Results larger than
+ * VALUE_BYTES are not cached.
+ */
+class SharedCache {
+public:
+    static const uint32_t SLOT_COUNT = 128;
+    static const uint32_t KEY_BYTES = 256;
+    static const uint32_t VALUE_BYTES = 128 * 1024;
+    static const uint32_t PROBE_LENGTH = 8;
+    static const int TABLE_COUNT = 8;
+
+    // Table versions captured before reading the data a result is built from
+    struct Stamp {
+        uint64_t versions[TABLE_COUNT] = {};
+    };
+
+private:
+    static const uint64_t MAGIC = 0x57544341434845ULL;  // "WTCACHE"
+    static const uint32_t LAYOUT_VERSION = 1;
+    static const int64_t STALE_LOCK_MS = 1000;
+
+    struct Slot {
+        std::atomic<uint32_t> sequence;  // odd while a writer owns the slot
+        std::atomic<int64_t> lockedAt;   // when the writer took it (ms)
+        uint64_t keyHash;
+        uint32_t keyLength;
+        uint32_t valueLength;
+        uint32_t tables;                 // bit i = depends on table i
+        int64_t storedAt;                // epoch ms, 0 = empty
+        uint64_t versions[TABLE_COUNT];
+        char key[KEY_BYTES];
+        char value[VALUE_BYTES];
+    };
+
+    struct Segment {
+        std::atomic<uint64_t> magic;     // set last by the creator
+        uint32_t layoutVersion;
+        uint32_t slotCount;
+        uint32_t slotBytes;
+        uint32_t reserved;
+        std::atomic<uint64_t> tableVersions[TABLE_COUNT];
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> stores;
+        Slot slots[SLOT_COUNT];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<int64_t>::is_always_lock_free,
+                  "shared memory atomics must be lock-free to work across processes");
+
+    Segment* segment = nullptr;
+    int64_t ttlMs = 30000;
+
+    static int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t hashKey(std::string_view key) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : key) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        return hash;
+    }
+
+    bool isCurrent(const Slot& slot, int64_t now) const {
+        if (slot.storedAt == 0 || now - slot.storedAt >= ttlMs) return false;
+        for (int table = 0; table < TABLE_COUNT; ++table) {
+            if ((slot.tables & (1u << table)) &&
+                slot.versions[table] != segment->tableVersions[table].load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Take a slot for writing; returns the odd sequence now held, or 0
+    static uint32_t lockSlot(Slot& slot, int64_t now) {
+        uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        uint32_t locked = (sequence & 1) ? sequence + 2 : sequence + 1;
+        if ((sequence & 1) && now - slot.lockedAt.load(std::memory_order_relaxed) < STALE_LOCK_MS) {
+            return 0;  // another writer is filling it
+        }
+        if (!slot.sequence.compare_exchange_strong(sequence, locked, std::memory_order_acquire)) {
+            return 0;
+        }
+        slot.lockedAt.store(now, std::memory_order_relaxed);
+        return locked;
+    }
+
+public:
+    SharedCache() = default;
+    ~SharedCache() {
+        close();
+    }
+    SharedCache(const SharedCache&) = delete;
+    SharedCache& operator=(const SharedCache&) = delete;
+
+    // Map the segment, creating and initializing it if this is the first
+    // process. Returns false (and the cache stays off) on any failure.
+    bool open(const SharedCacheConfig& config) {
+        if (segment) return true;
+        ttlMs = static_cast<int64_t>(config.ttlSeconds) * 1000;
+
+        int fd = shm_open(config.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+        bool creator = fd >= 0;
+        if (!creator) fd = shm_open(config.name.c_str(), O_RDWR, 0);
+        if (fd < 0) return false;
+
+        if (creator && ftruncate(fd, sizeof(Segment)) != 0) {
+            ::close(fd);
+            shm_unlink(config.name.c_str());
+            return false;
+        }
+
+        // Another process may have created it a moment ago: wait for its size
+        struct stat info;
+        for (int attempt = 0; attempt < 50; ++attempt) {
+            if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(Segment)) break;
+            usleep(1000);
+        }
+        if (static_cast<size_t>(info.st_size) < sizeof(Segment)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* mapping = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) return false;
+        Segment* candidate = static_cast<Segment*>(mapping);
+
+        // ftruncate zero-fills: every slot starts empty and unlocked
+        if (creator) {
+            candidate->layoutVersion = LAYOUT_VERSION;
+            candidate->slotCount = SLOT_COUNT;
+            candidate->slotBytes = sizeof(Slot);
+            candidate->magic.store(MAGIC, std::memory_order_release);
+        } else {
+            for (int attempt = 0; attempt < 50 && candidate->magic.load(std::memory_order_acquire) != MAGIC; ++attempt) {
+                usleep(1000);
+            }
+        }
+
+        if (candidate->magic.load(std::memory_order_acquire) != MAGIC ||
+            candidate->layoutVersion != LAYOUT_VERSION || candidate->slotCount != SLOT_COUNT ||
+            candidate->slotBytes != sizeof(Slot)) {
+            munmap(mapping, sizeof(Segment));
+            return false;  // a build with another layout owns this name
+        }
+        segment = candidate;
+        return true;
+    }
+
+    void close() {
+        if (segment) munmap(segment, sizeof(Segment));
+        segment = nullptr;
+    }
+
+    bool isOpen() const {
+        return segment != nullptr;
+    }
+
+    Stamp stamp() const {
+        Stamp current;
+        for (int table = 0; table < TABLE_COUNT && segment; ++table) {
+            current.versions[table] = segment->tableVersions[table].load(std::memory_order_acquire);
+        }
+        return current;
+    }
+
+    // Copy the current result for key into value; false on a miss
+    bool lookup(std::string_view key, std::string& value) {
+        if (!segment || key.size() > KEY_BYTES) return false;
+        uint64_t hash = hashKey(key);
+        int64_t now = nowMs();
+
+        for (uint32_t probe = 0; probe < PROBE_LENGTH; ++probe) {
+            Slot& slot = segment->slots[(hash + probe) % SLOT_COUNT];
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            if (slot.keyHash != hash || slot.keyLength != key.size() ||
+                std::memcmp(slot.key, key.data(), key.size()) != 0) {
+                continue;
+            }
+
+            bool current = isCurrent(slot, now);
+            uint32_t length = slot.valueLength;
+            if (current && length <= VALUE_BYTES) value.assign(slot.value, length);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before) continue;  // rewritten meanwhile
+            if (!current) break;
+
+            segment->hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        segment->misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Save a result built from the tables in the mask, as they were at stamp
+    bool store(std::string_view key, uint32_t tables, const Stamp& built, std::string_view value) {
+        if (!segment || key.size() > KEY_BYTES || value.size() > VALUE_BYTES) return false;
+        uint64_t hash = hashKey(key);
+        int64_t now = nowMs();
+
+        // Prefer the key's own slot, then an empty or dead one, then the oldest
+        Slot* target = nullptr;
+        int rank = 3;
+        for (uint32_t probe = 0; probe < PROBE_LENGTH && rank > 0; ++probe) {
+            Slot& slot = segment->slots[(hash + probe) % SLOT_COUNT];
+            int slotRank = 2;
+            if (slot.keyHash == hash && slot.keyLength == key.size() &&
+                std::memcmp(slot.key, key.data(), key.size()) == 0) {
+                slotRank = 0;
+            } else if (!isCurrent(slot, now)) {
+                slotRank = 1;
+            }
+            if (slotRank < rank || (slotRank == 2 && rank == 2 && slot.storedAt < target->storedAt)) {
+                target = &slot;
+                rank = slotRank;
+            }
+        }
+
+        uint32_t locked = lockSlot(*target, now);
+        if (locked == 0) return false;
+
+        target->keyHash = hash;
+        target->keyLength = static_cast<uint32_t>(key.size());
+        target->valueLength = static_cast<uint32_t>(value.size());
+        target->tables = tables;
+        target->storedAt = now;
+        std::memcpy(target->versions, built.versions, sizeof(target->versions));
+        std::memcpy(target->key, key.data(), key.size());
+        std::memcpy(target->value, value.data(), value.size());
+
+        target->sequence.store(locked + 1, std::memory_order_release);
+        segment->stores.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Retire every entry built from any table in the mask
+    void invalidate(uint32_t tables) {
+        for (int table = 0; table < TABLE_COUNT && segment; ++table) {
+            if (tables & (1u << table)) {
+                segment->tableVersions[table].fetch_add(1, std::memory_order_acq_rel);
+            }
+        }
+    }
+
+    uint64_t getHits() const { return segment ? segment->hits.load() : 0; }
+    uint64_t getMisses() const { return segment ? segment->misses.load() : 0; }
+    uint64_t getStores() const { return segment ? segment->stores.load() : 0; }
+};
+
+#endif // SHAREDCACHE_H
@@ -0,0 +1,98 @@
+// SingleFlight.h
+// Request coalescing for identical concurrent reads of the REST API
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+/*
+ * Runs a computation once for every caller that asks for the same key while
+ * it is in flight. The first caller (the leader) computes; callers arriving
+ * before it finishes wait for its result instead of starting their own:
+ *
+ *   bool joined;
+ *   SingleFlight::Result json = flights.run(key, [&]() { return query(); }, joined);
+ *
+ * The result is one immutable string shared by reference count, so a
+ * hundred waiters hold a hundred pointers to a single buffer. An exception
+ * thrown by the computation is rethrown in every caller of that flight.
+ *
+ * Nothing is kept once a flight lands: a caller arriving afterwards starts
+ * a new one. Keys should change whenever the underlying data does (the REST
+ * server includes the table ETag), so a request that starts after a write
+ * never joins a flight that read the data before it.
+ */
+class SingleFlight {
+public:
+    typedef std::shared_ptr<const std::string> Result;
+
+private:
+    std::mutex mutex;
+    std::map<std::string, std::shared_future<Result>> flights;
+    std::atomic<uint64_t> executions{0};
+    std::atomic<uint64_t> coalesced{0};
+
+public:
+    Result run(const std::string& key, const std::function<std::string()>& compute, bool& joined) {
+        std::promise<Result> promise;
+        std::shared_future<Result> flight;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto existing = flights.find(key);
+            joined = existing != flights.end();
+            if (joined) {
+                flight = existing->second;
+            } else {
+                flights.emplace(key, promise.get_future().share());
+            }
+        }
+
+        if (joined) {
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+            return flight.get();
+        }
+
+        executions.fetch_add(1, std::memory_order_relaxed);
+        try {
+            promise.set_value(std::make_shared<const std::string>(compute()));
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+
+        // Land the flight before handing out the result: later callers start afresh
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto landed = flights.find(key);
+            flight = landed->second;
+            flights.erase(landed);
+        }
+        return flight.get();
+    }
+
+    // Computations actually run
+    uint64_t getExecutions() const {
+        return executions.load(std::memory_order_relaxed);
+    }
+
+    // Callers served by another caller's computation
+    uint64_t getCoalesced() const {
+        return coalesced.load(std::memory_order_relaxed);
+    }
+
+    size_t getInFlight() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return flights.size();
+    }
+};
+
+#endif // SINGLEFLIGHT_H
@@ -0,0 +1,143 @@
+// Validation.h
+// Input validators shared by the service layer, REST API and CGI
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef VALIDATION_H
+#define VALIDATION_H
+
+#include "../Workout.h"
+#include "../Nutrition.h"
+#include "../Recovery.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Date and time checks are plain character-class parsers: no std::regex, no
+ * allocation, and constexpr so the cases below are checked at compile time.
+ * Unlike the old regexes they also range-check the fields, so "2026-02-30"
+ * and "24:00:00" are rejected. Dates follow MySQL's DATE range (year 1000+).
+ */
+
+constexpr bool isDigitChar(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Two digits at text[pos] as a number, or -1
+constexpr int parseTwoDigits(std::string_view text, size_t pos) {
+    return isDigitChar(text[pos]) && isDigitChar(text[pos + 1])
+        ? (text[pos] - '0') * 10 + (text[pos + 1] - '0') : -1;
+}
+
+constexpr bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+constexpr int daysInMonth(int year, int month) {
+    return month == 2 ? (isLeapYear(year) ? 29 : 28)
+         : (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+// YYYY-MM-DD with a real month and day
+constexpr bool isValidDate(std::string_view date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return false;
+    int high = parseTwoDigits(date, 0);
+    int low = parseTwoDigits(date, 2);
+    int month = parseTwoDigits(date, 5);
+    int day = parseTwoDigits(date, 8);
+    if (high < 10 || low < 0 || month < 1 || month > 12 || day < 1) return false;
+    return day <= daysInMonth(high * 100 + low, month);
+}
+
+// HH:MM:SS on a 24-hour clock
+constexpr bool isValidTime(std::string_view time) {
+    if (time.size() != 8 || time[2] != ':' || time[5] != ':') return false;
+    int hour = parseTwoDigits(time, 0);
+    int minute = parseTwoDigits(time, 3);
+    int second = parseTwoDigits(time, 6);
+    return hour >= 0 && hour <= 23 && minute >= 0 && minute <= 59 && second >= 0 && second <= 59;
+}
+
+constexpr bool isValidRPE(int rpe) {
+    return rpe >= 1 && rpe <= 10;
+}
+
+static_assert(isValidDate("2026-01-28") && isValidDate("2024-02-29"), "valid dates");
+static_assert(!isValidDate("2026-02-29") && !isValidDate("2026-13-01") && !isValidDate("2026-04-31") &&
+              !isValidDate("2026-1-28") && !isValidDate("0999-01-01") && !isValidDate("2026/01/28"),
+              "invalid dates");
+static_assert(isValidTime("00:00:00") && isValidTime("23:59:59"), "valid times");
+static_assert(!isValidTime("24:00:00") && !isValidTime("12:60:00") && !isValidTime("8:00:00"),
+              "invalid times");
+
+// ==================== BATCH VALIDATION ====================
+
+// One problem found in a batch: row index into the input, field, message
+struct ValidationError {
+    size_t row;
+    std::string field;
+    std::string message;
+
+    ValidationError(size_t r, const std::string& f, const std::string& m)
+        : row(r), field(f), message(m) {}
+};
+
+// Check every record and report all problems, not just the first one.
+// The rules are the ones WorkoutService applies to a single insert.
+inline std::vector<ValidationError> validateWorkouts(const std::vector<Workout>& workouts) {
+    std::vector<ValidationError> errors;
+    for (size_t row = 0; row < workouts.size(); ++row) {
+        const Workout& workout = workouts[row];
+        if (!isValidDate(workout.getWorkoutDate())) {
+            errors.emplace_back(row, "workout_date", "Invalid date format. Use YYYY-MM-DD");
+        }
+        if (!isValidTime(workout.getWorkoutTime())) {
+            errors.emplace_back(row, "workout_time", "Invalid time format. Use HH:MM:SS");
+        }
+        if (workout.getDuration() <= 0) {
+            errors.emplace_back(row, "duration", "Duration must be positive");
+        }
+        if (!isValidRPE(workout.getRatePerceivedExhaustion())) {
+            errors.emplace_back(row, "rate_perceived_exhaustion", "RPE must be between 1 and 10");
+        }
+        if (workout.getCaloriesBurned() < 0) {
+            errors.emplace_back(row, "calories_burned", "Calories cannot be negative");
+        }
+    }
+    return errors;
+}
+
+inline std::vector<ValidationError> validateNutrition(const std::vector<Nutrition>& meals) {
+    std::vector<ValidationError> errors;
+    for (size_t row = 0; row < meals.size(); ++row) {
+        const Nutrition& meal = meals[row];
+        if (!isValidDate(meal.getMealDate())) {
+            errors.emplace_back(row, "meal_date", "Invalid date format. Use YYYY-MM-DD");
+        }
+        if (meal.getWater() < 0 || meal.getCarbs() < 0 || meal.getFat() < 0 ||
+            meal.getProtein() < 0 || meal.getSugar() < 0) {
+            errors.emplace_back(row, "nutrition", "Nutrition values cannot be negative");
+        }
+    }
+    return errors;
+}
+
+inline std::vector<ValidationError> validateRecovery(const std::vector<Recovery>& sessions) {
+    std::vector<ValidationError> errors;
+    for (size_t row = 0; row < sessions.size(); ++row) {
+        const Recovery& session = sessions[row];
+        if (!isValidDate(session.getRecoveryDate())) {
+            errors.emplace_back(row, "recovery_date", "Invalid date format. Use YYYY-MM-DD");
+        }
+        if (session.getDuration() <= 0) {
+            errors.emplace_back(row, "duration", "Duration must be positive");
+        }
+        if (session.getType().empty()) {
+            errors.emplace_back(row, "type", "Type cannot be empty");
+        }
+    }
+    return errors;
+}
+
+#endif // VALIDATION_H
@@ -6,7 +6,6 @@
 
 #include "WorkoutService.h"
 #include <iostream>
-#include <regex>
 
 // Constructor
 WorkoutService::WorkoutService(WorkoutManager* mgr) : manager(mgr) {
@@ -21,19 +20,17 @@ WorkoutService::~WorkoutService() {
 // ==================== VALIDATION HELPERS ====================
 
 bool WorkoutService::validateDate(const std::string& date) {
-    // Simple date validation: YYYY-MM-DD
-    std::regex dateRegex("^\\d{4}-\\d{2}-\\d{2}$");
-    return std::regex_match(date, dateRegex);
+    // YYYY-MM-DD with a real month and day (see Validation.h)
+    return isValidDate(date);
 }
 
 bool WorkoutService::validateTime(const std::string& time) {
-    // Simple time validation: HH:MM:SS
-    std::regex timeRegex("^\\d{2}:\\d{2}:\\d{2}$");
-    return std::regex_match(time, timeRegex);
+    // HH:MM:SS on a 24-hour clock
+    return isValidTime(time);
 }
 
 bool WorkoutService::validateRPE(int rpe) {
-    return rpe >= 1 && rpe <= 10;
+    return isValidRPE(rpe);
 }
 
 // ==================== WORKOUT SERVICES ====================
@@ -133,10 +130,31 @@ Workout* WorkoutService::getWorkout(int id) {
     return manager->getWorkout(id);
 }
 
-std::vector<Workout*> WorkoutService::getAllWorkouts() {
+ResultSet<Workout> WorkoutService::getAllWorkouts() {
     return manager->getAllWorkouts();
 }
 
+ServiceResponse WorkoutService::insertWorkouts(std::vector<Workout>& workouts,
+                                               std::vector<ValidationError>& errors) {
+    // Check the whole batch first; nothing is written if any row is bad
+    errors = validateWorkouts(workouts);
+    if (!errors.empty()) {
+        return ServiceResponse(false, std::to_string(errors.size()) + " invalid field(s) in batch");
+    }
+    if (workouts.empty()) {
+        return ServiceResponse(false, "No workouts to insert");
+    }
+    
+    bool success = manager->createWorkouts(workouts);
+    
+    if (success) {
+        return ServiceResponse(true, std::to_string(workouts.size()) + " workouts created successfully",
+                               workouts.front().getWorkoutId());
+    } else {
+        return ServiceResponse(false, "Failed to create workouts");
+    }
+}
+
 // ==================== MUSCLEGROUP SERVICES ====================
 
 ServiceResponse WorkoutService::insertMuscleGroup(const std::string& name,
@@ -218,7 +236,7 @@ MuscleGroup* WorkoutService::getMuscleGroup(int id) {
     return manager->getMuscleGroup(id);
 }
 
-std::vector<MuscleGroup*> WorkoutService::getAllMuscleGroups() {
+ResultSet<MuscleGroup> WorkoutService::getAllMuscleGroups() {
     return manager->getAllMuscleGroups();
 }
 
@@ -317,7 +335,7 @@ Nutrition* WorkoutService::getNutrition(int id) {
     return manager->getNutrition(id);
 }
 
-std::vector<Nutrition*> WorkoutService::getAllNutrition() {
+ResultSet<Nutrition> WorkoutService::getAllNutrition() {
     return manager->getAllNutrition();
 }
 
@@ -394,7 +412,7 @@ Recovery* WorkoutService::getRecovery(int id) {
     return manager->getRecovery(id);
 }
 
-std::vector<Recovery*> WorkoutService::getAllRecovery() {
+ResultSet<Recovery> WorkoutService::getAllRecovery() {
     return manager->getAllRecovery();
 }
 
@@ -465,7 +483,7 @@ Equipment* WorkoutService::getEquipment(int id) {
     return manager->getEquipment(id);
 }
 
-std::vector<Equipment*> WorkoutService::getAllEquipment() {
+ResultSet<Equipment> WorkoutService::getAllEquipment() {
     return manager->getAllEquipment();
 }
 
@@ -476,36 +494,31 @@ bool WorkoutService::testConnection() {
 }
 
 int WorkoutService::getTotalWorkouts() {
-    std::vector<Workout*> workouts = manager->getAllWorkouts();
+    ResultSet<Workout> workouts = manager->getAllWorkouts();
     int count = workouts.size();
-    manager->cleanupVector(workouts);
     return count;
 }
 
 int WorkoutService::getTotalMuscleGroups() {
-    std::vector<MuscleGroup*> groups = manager->getAllMuscleGroups();
+    ResultSet<MuscleGroup> groups = manager->getAllMuscleGroups();
     int count = groups.size();
-    manager->cleanupVector(groups);
     return count;
 }
 
 int WorkoutService::getTotalNutrition() {
-    std::vector<Nutrition*> nutrition = manager->getAllNutrition();
+    ResultSet<Nutrition> nutrition = manager->getAllNutrition();
     int count = nutrition.size();
-    manager->cleanupVector(nutrition);
     return count;
 }
 
 int WorkoutService::getTotalRecovery() {
-    std::vector<Recovery*> recovery = manager->getAllRecovery();
+    ResultSet<Recovery> recovery = manager->getAllRecovery();
     int count = recovery.size();
-    manager->cleanupVector(recovery);
     return count;
 }
 
 int WorkoutService::getTotalEquipment() {
-    std::vector<Equipment*> equipment = manager->getAllEquipment();
+    ResultSet<Equipment> equipment = manager->getAllEquipment();
     int count = equipment.size();
-    manager->cleanupVector(equipment);
     return count;
 }
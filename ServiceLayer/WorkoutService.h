@@ -8,6 +8,7 @@
 #define WORKOUTSERVICE_H
 
 #include "../BusinessLayer/WorkoutManager.h"
+#include "Validation.h"
 #include <string>
 #include <vector>
 
@@ -70,6 +71,12 @@ public:
                                   int rpe,
                                   int muscleGroupId);
     
+    // Insert a batch of workouts in one transaction. Every row is validated
+    // first; if any fails, errors lists them all and nothing is written.
+    // On success the workouts carry their new IDs.
+    ServiceResponse insertWorkouts(std::vector<Workout>& workouts,
+                                   std::vector<ValidationError>& errors);
+    
     // Delete a workout
     ServiceResponse deleteWorkout(int id);
     
@@ -77,7 +84,7 @@ public:
     Workout* getWorkout(int id);
     
     // Get all workouts
-    std::vector<Workout*> getAllWorkouts();
+    ResultSet<Workout> getAllWorkouts();
     
     // ==================== MUSCLEGROUP SERVICES ====================
     
@@ -105,7 +112,7 @@ public:
     MuscleGroup* getMuscleGroup(int id);
     
     // Get all muscle groups
-    std::vector<MuscleGroup*> getAllMuscleGroups();
+    ResultSet<MuscleGroup> getAllMuscleGroups();
     
     // ==================== NUTRITION SERVICES ====================
     
@@ -135,7 +142,7 @@ public:
     Nutrition* getNutrition(int id);
     
     // Get all nutrition entries
-    std::vector<Nutrition*> getAllNutrition();
+    ResultSet<Nutrition> getAllNutrition();
     
     // ==================== RECOVERY SERVICES ====================
     
@@ -159,7 +166,7 @@ public:
     Recovery* getRecovery(int id);
     
     // Get all recovery sessions
-    std::vector<Recovery*> getAllRecovery();
+    ResultSet<Recovery> getAllRecovery();
     
     // ==================== EQUIPMENT SERVICES ====================
     
@@ -183,7 +190,7 @@ public:
     Equipment* getEquipment(int id);
     
     // Get all equipment
-    std::vector<Equipment*> getAllEquipment();
+    ResultSet<Equipment> getAllEquipment();
     
     // ==================== UTILITY METHODS ====================
     
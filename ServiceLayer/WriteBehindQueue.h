@@ -0,0 +1,482 @@
+// WriteBehindQueue.h
+// Durable write-behind queue for POST /api/workouts
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#ifndef WRITEBEHINDQUEUE_H
+#define WRITEBEHINDQUEUE_H
+
+#include "../Workout.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Settings, overridable through environment variables:
+//   WORKOUT_WRITE_BEHIND           set to 1 to queue POST /api/workouts (default off)
+//   WORKOUT_WRITE_BEHIND_LOG       append-only queue file (default workout_ingest.log)
+//   WORKOUT_WRITE_BEHIND_CAPACITY  queued workouts before new ones get 503 (default 10000)
+//   WORKOUT_WRITE_BEHIND_BATCH     workouts per INSERT (default 200)
+//   WORKOUT_WRITE_BEHIND_FLUSH_MS  longest wait before a partial batch is written (default 100)
+//   WORKOUT_WRITE_BEHIND_FSYNC     0 = do not fsync before answering (faster; a power
+//                                  cut can lose the last few accepted workouts)
+struct WriteBehindConfig {
+    bool enabled = false;
+    std::string logPath = "workout_ingest.log";
+    size_t capacity = 10000;
+    size_t batchSize = 200;
+    int flushIntervalMs = 100;
+    bool syncEachAppend = true;
+
+    static WriteBehindConfig fromEnvironment() {
+        WriteBehindConfig config;
+        const char* enabled = std::getenv("WORKOUT_WRITE_BEHIND");
+        const char* logPath = std::getenv("WORKOUT_WRITE_BEHIND_LOG");
+        const char* capacity = std::getenv("WORKOUT_WRITE_BEHIND_CAPACITY");
+        const char* batch = std::getenv("WORKOUT_WRITE_BEHIND_BATCH");
+        const char* interval = std::getenv("WORKOUT_WRITE_BEHIND_FLUSH_MS");
+        const char* fsync = std::getenv("WORKOUT_WRITE_BEHIND_FSYNC");
+
+        config.enabled = enabled && std::string(enabled) == "1";
+        if (logPath && *logPath) config.logPath = logPath;
+        if (capacity && std::atol(capacity) > 0) config.capacity = static_cast<size_t>(std::atol(capacity));
+        if (batch && std::atol(batch) > 0) config.batchSize = static_cast<size_t>(std::atol(batch));
+        if (interval && std::atoi(interval) > 0) config.flushIntervalMs = std::atoi(interval);
+        if (fsync && std::string(fsync) == "0") config.syncEachAppend = false;
+        return config;
+    }
+};
+
+/*
+ * Accepts workouts faster than MySQL commits them one by one. enqueue()
+ * appends the workout to a local log file and returns a ticket; a background
+ * flusher writes queued workouts to MySQL in batches (one multi-row INSERT
+ * each) and records the outcome of every ticket.
+ *
+ * The log makes accepted workouts survive a restart: on start() every queued
+ * entry without a recorded outcome is queued again. Delivery is at least
+ * once - a crash between the INSERT and the log write repeats that batch.
+ *
+ * Appends are group-committed: a writer appends its record under the mutex,
+ * then either runs the fsync for every record appended so far (outside the
+ * mutex) or, if one is already running, waits for the next one to cover it.
+ * Concurrent POSTs therefore share fsyncs instead of queueing for their own.
+ *
+ * Log records, one per line:
+ *   Q <ticket>\t<date>\t<time>\t<duration>\t<type>\t<calories>\t<rpe>\t<muscle group>
+ *   D <ticket> <workout id>      (0 = rejected by the database)
+ *   N <next ticket>              (written when the log is compacted)
+ */
+class WriteBehindQueue {
+public:
+    enum class State {
+        UNKNOWN,
+        QUEUED,
+        COMMITTED,
+        FAILED
+    };
+
+    enum class Admission {
+        QUEUED,
+        FULL,
+        LOG_ERROR
+    };
+
+    // What the batch writer reports back
+    enum class FlushResult {
+        WRITTEN,      // all rows inserted, ids written back
+        REJECTED,     // the database refused the statement (bad row)
+        UNAVAILABLE   // no database; try again later
+    };
+    typedef std::function<FlushResult(std::vector<Workout>&)> BatchWriter;
+
+    struct Status {
+        State state = State::UNKNOWN;
+        int workoutId = 0;
+    };
+
+private:
+    struct Entry {
+        unsigned long long ticket;
+        Workout workout;
+    };
+
+    WriteBehindConfig config;
+    BatchWriter writer;
+    std::FILE* log = nullptr;
+    size_t logRecords = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable synced;
+    unsigned long long appendedSeq = 0;  // records appended
+    unsigned long long syncedSeq = 0;    // records known to be on disk
+    unsigned long long failedSeq = 0;    // records covered by a failed fsync
+    bool syncing = false;                // an fsync is running outside the mutex
+    size_t admitting = 0;                // enqueues waiting for their fsync
+    std::deque<Entry> pending;
+    std::map<unsigned long long, Status> statuses;
+    std::deque<unsigned long long> finished;  // resolved tickets, oldest first
+    unsigned long long nextTicket = 1;
+    bool stopping = false;
+    std::thread flusher;
+
+    static std::string escape(const std::string& text) {
+        std::string out;
+        for (char c : text) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '\t': out += "\\t"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                default:   out += c;
+            }
+        }
+        return out;
+    }
+
+    static std::string unescape(const std::string& text) {
+        std::string out;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '\\' || i + 1 == text.size()) {
+                out += text[i];
+                continue;
+            }
+            char c = text[++i];
+            out += c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+        }
+        return out;
+    }
+
+    static std::vector<std::string> split(const std::string& line, char separator) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        while (true) {
+            size_t end = line.find(separator, start);
+            parts.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+            if (end == std::string::npos) return parts;
+            start = end + 1;
+        }
+    }
+
+    static bool syncDescriptor(int fd) {
+#ifdef _WIN32
+        return _commit(fd) == 0;
+#else
+        return fsync(fd) == 0;
+#endif
+    }
+
+    // Make every record up to seq durable. The caller holds lock; it is
+    // released while this thread runs an fsync, or while it waits for the
+    // one another thread is running.
+    bool syncThrough(std::unique_lock<std::mutex>& lock, unsigned long long seq) {
+        if (!config.syncEachAppend) return std::fflush(log) == 0;
+
+        while (syncedSeq < seq) {
+            if (failedSeq >= seq || !log) return false;
+            if (syncing) {
+                synced.wait(lock);
+                continue;
+            }
+
+            syncing = true;
+            unsigned long long target = appendedSeq;
+            bool ok = std::fflush(log) == 0;
+            int fd = fileno(log);
+            lock.unlock();
+            ok = ok && syncDescriptor(fd);
+            lock.lock();
+            syncing = false;
+            if (ok) {
+                syncedSeq = target;
+            } else {
+                failedSeq = target;
+            }
+            synced.notify_all();
+        }
+        return true;
+    }
+
+    bool appendRecord(const std::string& record) {
+        ++logRecords;
+        ++appendedSeq;
+        return std::fputs(record.c_str(), log) >= 0;
+    }
+
+    static std::string queuedRecord(unsigned long long ticket, const Workout& w) {
+        return "Q " + std::to_string(ticket) + "\t" + escape(w.getWorkoutDate()) + "\t" +
+               escape(w.getWorkoutTime()) + "\t" + std::to_string(w.getDuration()) + "\t" +
+               escape(w.getTypeDescription()) + "\t" + std::to_string(w.getCaloriesBurned()) + "\t" +
+               std::to_string(w.getRatePerceivedExhaustion()) + "\t" +
+               std::to_string(w.getMuscleGroupId()) + "\n";
+    }
+
+    void remember(unsigned long long ticket, const Status& status) {
+        statuses[ticket] = status;
+        if (status.state == State::QUEUED) return;
+        finished.push_back(ticket);
+        while (finished.size() > config.capacity) {
+            statuses.erase(finished.front());
+            finished.pop_front();
+        }
+    }
+
+    // Rebuild the queue from the log; a torn last line (crash mid-append) is ignored
+    void replay() {
+        std::map<unsigned long long, Workout> queued;
+        char buffer[4096];
+        std::string line;
+
+        std::rewind(log);
+        while (std::fgets(buffer, sizeof(buffer), log)) {
+            line += buffer;
+            if (line.empty() || line.back() != '\n') continue;
+            line.pop_back();
+            ++logRecords;
+
+            if (line.size() > 2 && line[0] == 'Q') {
+                std::vector<std::string> f = split(line.substr(2), '\t');
+                if (f.size() == 8) {
+                    unsigned long long ticket = std::strtoull(f[0].c_str(), nullptr, 10);
+                    queued[ticket] = Workout(0, unescape(f[1]), unescape(f[2]), std::atoi(f[3].c_str()),
+                                             unescape(f[4]), std::atof(f[5].c_str()),
+                                             std::atoi(f[6].c_str()), std::atoi(f[7].c_str()));
+                    if (ticket >= nextTicket) nextTicket = ticket + 1;
+                }
+            } else if (line.size() > 2 && line[0] == 'D') {
+                std::vector<std::string> f = split(line.substr(2), ' ');
+                if (f.size() == 2) {
+                    unsigned long long ticket = std::strtoull(f[0].c_str(), nullptr, 10);
+                    Status status;
+                    status.workoutId = std::atoi(f[1].c_str());
+                    status.state = status.workoutId > 0 ? State::COMMITTED : State::FAILED;
+                    queued.erase(ticket);
+                    remember(ticket, status);
+                    if (ticket >= nextTicket) nextTicket = ticket + 1;
+                }
+            } else if (line.size() > 2 && line[0] == 'N') {
+                unsigned long long next = std::strtoull(line.c_str() + 2, nullptr, 10);
+                if (next > nextTicket) nextTicket = next;
+            }
+            line.clear();
+        }
+
+        for (auto& item : queued) {
+            pending.push_back(Entry{item.first, item.second});
+            Status status;
+            status.state = State::QUEUED;
+            remember(item.first, status);
+        }
+        std::fseek(log, 0, SEEK_END);
+    }
+
+    // With nothing queued, replace a long log by the outcomes still kept in memory
+    void compact() {
+        if (!pending.empty() || syncing || admitting > 0 || logRecords < 2 * config.capacity + 1024) return;
+
+        std::string tmpPath = config.logPath + ".tmp";
+        std::FILE* out = std::fopen(tmpPath.c_str(), "wb");
+        if (!out) return;
+
+        std::string records = "N " + std::to_string(nextTicket) + "\n";
+        for (unsigned long long ticket : finished) {
+            records += "D " + std::to_string(ticket) + " " + std::to_string(statuses[ticket].workoutId) + "\n";
+        }
+        bool ok = std::fputs(records.c_str(), out) >= 0 && std::fflush(out) == 0;
+#ifndef _WIN32
+        ok = ok && fsync(fileno(out)) == 0;
+#endif
+        std::fclose(out);
+        if (!ok) {
+            std::remove(tmpPath.c_str());
+            return;
+        }
+
+        std::fclose(log);
+#ifdef _WIN32
+        std::remove(config.logPath.c_str());
+#endif
+        std::rename(tmpPath.c_str(), config.logPath.c_str());
+        log = std::fopen(config.logPath.c_str(), "ab");
+        logRecords = finished.size() + 1;
+        syncedSeq = appendedSeq;  // everything still needed was fsynced above
+    }
+
+    // Write a batch; on a rejected statement fall back to one row at a time
+    // so a single bad workout does not fail its neighbours. Returns how many
+    // leading entries got an outcome (ids[i] > 0 committed, 0 rejected); the
+    // rest stay queued because the database became unavailable.
+    size_t writeBatch(std::vector<Workout>& batch, std::vector<int>& ids) {
+        FlushResult result = writer(batch);
+        if (result == FlushResult::WRITTEN) {
+            for (size_t i = 0; i < batch.size(); ++i) ids[i] = batch[i].getWorkoutId();
+            return batch.size();
+        }
+        if (result == FlushResult::UNAVAILABLE) return 0;
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            std::vector<Workout> single(1, batch[i]);
+            result = writer(single);
+            if (result == FlushResult::UNAVAILABLE) return i;
+            ids[i] = result == FlushResult::WRITTEN ? single[0].getWorkoutId() : 0;
+        }
+        return batch.size();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait_for(lock, std::chrono::milliseconds(config.flushIntervalMs),
+                          [this] { return stopping || pending.size() >= config.batchSize; });
+            if (pending.empty()) {
+                if (stopping) return;
+                compact();
+                continue;
+            }
+
+            // Entries stay at the front of the queue until their outcome is logged
+            size_t count = pending.size() < config.batchSize ? pending.size() : config.batchSize;
+            std::vector<Workout> batch;
+            std::vector<unsigned long long> tickets;
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(pending[i].workout);
+                tickets.push_back(pending[i].ticket);
+            }
+
+            lock.unlock();
+            std::vector<int> ids(count, 0);
+            size_t resolved = writeBatch(batch, ids);
+            lock.lock();
+
+            for (size_t i = 0; i < resolved; ++i) {
+                Status status;
+                status.workoutId = ids[i];
+                status.state = ids[i] > 0 ? State::COMMITTED : State::FAILED;
+                remember(tickets[i], status);
+                appendRecord("D " + std::to_string(tickets[i]) + " " + std::to_string(ids[i]) + "\n");
+                pending.pop_front();
+            }
+            if (resolved > 0) syncThrough(lock, appendedSeq);
+
+            if (resolved < count) {
+                // Database unavailable: keep everything queued and wait a little.
+                // On shutdown the rest is left in the log for the next start.
+                if (stopping) return;
+                wake.wait_for(lock, std::chrono::seconds(1), [this] { return stopping; });
+            }
+        }
+    }
+
+public:
+    WriteBehindQueue() = default;
+    WriteBehindQueue(const WriteBehindQueue&) = delete;
+    WriteBehindQueue& operator=(const WriteBehindQueue&) = delete;
+
+    ~WriteBehindQueue() {
+        stop();
+    }
+
+    // Open (or create) the log, re-queue unfinished entries and start the flusher
+    bool start(const WriteBehindConfig& settings, BatchWriter batchWriter) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (log) return true;
+
+        config = settings;
+        writer = batchWriter;
+        log = std::fopen(config.logPath.c_str(), "a+b");
+        if (!log) return false;
+
+        replay();
+        stopping = false;
+        flusher = std::thread(&WriteBehindQueue::run, this);
+        return true;
+    }
+
+    // Flush what the database accepts, then stop the flusher
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!log) return;
+            stopping = true;
+        }
+        wake.notify_all();
+        if (flusher.joinable()) flusher.join();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        synced.wait(lock, [this] { return !syncing; });
+        std::fclose(log);
+        log = nullptr;
+        synced.notify_all();
+    }
+
+    bool isRunning() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return log != nullptr;
+    }
+
+    // Durably queue a workout. FULL means the caller should back off and retry.
+    Admission enqueue(const Workout& workout, unsigned long long& ticket) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!log || stopping) return Admission::LOG_ERROR;
+        if (pending.size() + admitting >= config.capacity) return Admission::FULL;
+
+        unsigned long long assigned = nextTicket++;
+        bool appended = appendRecord(queuedRecord(assigned, workout));
+        ++admitting;
+        bool durable = appended && syncThrough(lock, appendedSeq);
+        --admitting;
+        if (!durable) {
+            // Not accepted, so a restart must not queue it either
+            if (log) appendRecord("D " + std::to_string(assigned) + " 0\n");
+            return Admission::LOG_ERROR;
+        }
+
+        // Queued only once durable, so the flusher never writes a workout
+        // that a crash could make the client see as refused
+        pending.push_back(Entry{assigned, workout});
+        Status status;
+        status.state = State::QUEUED;
+        remember(assigned, status);
+        ticket = assigned;
+
+        bool batchReady = pending.size() >= config.batchSize;
+        lock.unlock();
+        if (batchReady) wake.notify_one();
+        return Admission::QUEUED;
+    }
+
+    Status getStatus(unsigned long long ticket) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = statuses.find(ticket);
+        return it == statuses.end() ? Status() : it->second;
+    }
+
+    size_t getDepth() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return pending.size();
+    }
+
+    static const char* stateName(State state) {
+        switch (state) {
+            case State::QUEUED:    return "queued";
+            case State::COMMITTED: return "committed";
+            case State::FAILED:    return "failed";
+            default:               return "unknown";
+        }
+    }
+};
+
+#endif // WRITEBEHINDQUEUE_H
@@ -54,10 +54,14 @@ g++ -std=c++17 \
     ../Recovery.cpp \
     ../Equipment.cpp \
     ../WorkoutDAO.cpp \
+    ../LocalStore.cpp \
+    ../LocalStoreDAO.cpp \
+    ../ColumnSnapshot.cpp \
     ../BusinessLayer/WorkoutManager.cpp \
     -L/usr/lib/x86_64-linux-gnu \
     -lmysqlclient \
     -lpthread \
+    -lz \
     -o rest_api_server
 
 if [ $? -eq 0 ]; then
@@ -0,0 +1,82 @@
+#!/bin/bash
+# load_test.sh
+# Workout Tracking System - Overload scenario for the REST API server:
+# run a mixed workload at N clients, then at 2N, and report latency per
+# route class so admission control (AdmissionControl.h) can be checked.
+# Author: Therin Emmons
+# Date: 2026-10-18
+#
+# Usage: ServiceLayer/load_test.sh [clients] [seconds]    (server must be running)
+#   clients  concurrency that roughly saturates the server (default 16)
+#   seconds  length of each phase (default 20)
+#
+# Mix per client: 50% GET /api/workouts (list), 30% GET /api/workouts/1
+# (read), 20% DELETE of a missing workout (a write that changes nothing).
+# Clients honour Retry-After on 503 and 429. All clients share one address,
+# so start the server without WORKOUT_RATE_LIMIT (or with large budgets).
+# Compare a run against a server started with WORKOUT_ADMISSION=0: without
+# admission control p99 grows with the overload, with it the excess is
+# answered 503 and p99 stays bounded.
+
+BASE_URL="${BASE_URL:-http://localhost:8080}"
+CLIENTS="${1:-16}"
+SECONDS_PER_PHASE="${2:-20}"
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+if ! curl -s -o /dev/null "$BASE_URL/health"; then
+    echo "✗ No server at $BASE_URL"
+    exit 1
+fi
+
+# One client: "class status seconds" per request until the deadline
+client() {
+    local deadline=$1 out=$2 n=0 pick class method url result
+    while [ "$(date +%s)" -lt "$deadline" ]; do
+        pick=$((n % 10))
+        n=$((n + 1))
+        if [ $pick -lt 5 ]; then
+            class=list; method=GET; url="$BASE_URL/api/workouts"
+        elif [ $pick -lt 8 ]; then
+            class=read; method=GET; url="$BASE_URL/api/workouts/1"
+        else
+            class=write; method=DELETE; url="$BASE_URL/api/workouts/2000000000"
+        fi
+        result=$(curl -s -o /dev/null -X "$method" -w "%{http_code} %{time_total}" "$url")
+        echo "$class $result" >> "$out"
+        case "${result%% *}" in 503|429) sleep 1 ;; esac
+    done
+}
+
+# Run one phase and print count, refusals (503/429), p50 and p99 of the rest per class
+phase() {
+    local clients=$1 label=$2 deadline out
+    deadline=$(( $(date +%s) + SECONDS_PER_PHASE ))
+    for i in $(seq "$clients"); do
+        client "$deadline" "$WORK_DIR/$label.$i" &
+    done
+    wait
+    out="$WORK_DIR/$label.all"
+    cat "$WORK_DIR/$label".[0-9]* > "$out"
+
+    echo "== $label: $clients clients, ${SECONDS_PER_PHASE}s =="
+    for class in list read write; do
+        awk -v c="$class" '$1 == c { total++; if ($2 == 503 || $2 == 429) shed++; else print $3 * 1000 }
+                           END { printf "%d %d\n", total, shed > "/dev/stderr" }' "$out" 2> "$WORK_DIR/counts" |
+            sort -n > "$WORK_DIR/latency"
+        read -r total shed < "$WORK_DIR/counts"
+        awk -v c="$class" -v total="$total" -v shed="$shed" '
+            { v[NR] = $1 }
+            END {
+                p50 = NR ? v[int((NR - 1) * 0.50) + 1] : 0
+                p99 = NR ? v[int((NR - 1) * 0.99) + 1] : 0
+                printf "  %-5s  requests %6d  503 %6d  p50 %8.1f ms  p99 %8.1f ms\n", c, total, shed, p50, p99
+            }' "$WORK_DIR/latency"
+    done
+}
+
+phase "$CLIENTS" "baseline"
+phase $((CLIENTS * 2)) "overload-2x"
+echo ""
+echo "Admission state:"
+curl -s "$BASE_URL/health" | grep -o '"admission":{.*}}' || echo "  (admission control is off)"
@@ -3,62 +3,341 @@
 // Author: Claude, Therin Emmons
 // Date: 2026-01-28
 #include "WorkoutDAO.h"
+#include "RowMapping.h"
+#include <mysql/mysqld_error.h>
+#include <mysql/errmsg.h>
 #include <iostream>
 #include <cstring>
+#include <cstdlib>
+#include <charconv>
+#include <thread>
+
+namespace {
+// Read-your-writes deadline for the calling thread (epoch ms)
+thread_local long long primaryReadsUntil = 0;
+
+long long epochMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+long long steadyMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Set by the last write of each thread; see lastWriteWasDuplicate()
+thread_local bool duplicateWrite = false;
+
+// See getFailureCount()
+thread_local unsigned long long failureCount = 0;
+
+unsigned long long nextSerial() {
+    static std::atomic<unsigned long long> counter{0};
+    return ++counter;
+}
+
+// {12, 13, 14} -> "12,13,14" for IN (...) and FIELD(...)
+std::string joinIds(const std::vector<int>& ids) {
+    std::string list;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i > 0) list += ",";
+        list += std::to_string(ids[i]);
+    }
+    return list;
+}
+}
 
 // Constructor
 WorkoutDAO::WorkoutDAO(const std::string& h, const std::string& u,
                        const std::string& p, const std::string& db, int pt)
-    : host(h), user(u), password(p), database(db), port(pt), connection(nullptr) {
-    connection = mysql_init(nullptr);
-    if (!connection) {
-        std::cerr << "MySQL initialization failed!" << std::endl;
+    : user(u), password(p), database(db), serial(nextSerial()),
+      policy(ConnectionPolicy::fromEnvironment()) {
+    breaker.configure(policy.breakerThreshold, policy.breakerCooldownMs);
+    primary.host = h;
+    primary.port = pt;
+    
+    for (const auto& replica : policy.replicas) {
+        addReadReplica(replica.first, replica.second);
     }
 }
 
+// Constructor for subclasses with their own storage: no MySQL handle
+WorkoutDAO::WorkoutDAO()
+    : serial(nextSerial()), policy(ConnectionPolicy::fromEnvironment()) {
+}
+
 // Destructor
 WorkoutDAO::~WorkoutDAO() {
     disconnect();
 }
 
+// Replace the connection policy; timeouts apply from the next connect
+void WorkoutDAO::setConnectionPolicy(const ConnectionPolicy& settings) {
+    policy = settings;
+    breaker.configure(policy.breakerThreshold, policy.breakerCooldownMs);
+}
+
+// Add a read replica; call during setup, before the DAO is shared
+void WorkoutDAO::addReadReplica(const std::string& replicaHost, int replicaPort) {
+    replicas.emplace_back();
+    replicas.back().host = replicaHost;
+    replicas.back().port = replicaPort;
+    
+    std::lock_guard<std::mutex> lock(linksMutex);
+    for (auto& entry : threadLinkSets) {
+        Link replica;
+        replica.server = &replicas.back();
+        entry.second->replicas.push_back(replica);
+    }
+}
+
+long long WorkoutDAO::getPrimaryReadsUntil() {
+    return primaryReadsUntil;
+}
+
+void WorkoutDAO::setPrimaryReadsUntil(long long epochMs) {
+    primaryReadsUntil = epochMs;
+}
+
+// A write just succeeded: keep this thread's reads, and for the same time
+// every other thread's, on the primary for a while
+void WorkoutDAO::notePrimaryWrite() {
+    long long until = epochMillis() + policy.stickyMs;
+    if (until > primaryReadsUntil) primaryReadsUntil = until;
+    
+    long long current = allReadsPrimaryUntil.load();
+    while (until > current && !allReadsPrimaryUntil.compare_exchange_weak(current, until)) {
+    }
+}
+
+// The calling thread's links, created on first use. The last DAO looked up
+// is cached per thread, so the map lock is only taken on a thread's first call.
+WorkoutDAO::ThreadLinks& WorkoutDAO::threadLinks() {
+    thread_local unsigned long long cachedSerial = 0;
+    thread_local ThreadLinks* cached = nullptr;
+    if (cachedSerial == serial) {
+        return *cached;
+    }
+    
+    std::lock_guard<std::mutex> lock(linksMutex);
+    std::unique_ptr<ThreadLinks>& mine = threadLinkSets[std::this_thread::get_id()];
+    if (!mine) {
+        mine.reset(new ThreadLinks());
+        mine->primary.server = &primary;
+        for (Server& replica : replicas) {
+            Link link;
+            link.server = &replica;
+            mine->replicas.push_back(link);
+        }
+    }
+    cachedSerial = serial;
+    cached = mine.get();
+    return *cached;
+}
+
 // Helper method to connect to database
 // Needed to modify the connection, if already connected
-bool WorkoutDAO::connect() {
-    // Check if already connected - if so, just return true
-    if (connection && mysql_ping(connection) == 0) {
-        return true;  // Already connected and alive
+WorkoutDAO::Link* WorkoutDAO::connect() {
+    Link& link = threadLinks().primary;
+    if (!openLink(link)) {
+        ++failureCount;
+        return nullptr;
+    }
+    return &link;
+}
+
+// Pick the server for a read: the first healthy replica, or the primary when
+// there are none, all are down, or this process or thread wrote recently
+WorkoutDAO::Link* WorkoutDAO::connectForRead() {
+    ThreadLinks& mine = threadLinks();
+    if (mine.replicas.empty()) {
+        return connect();
+    }
+    long long nowMs = epochMillis();
+    if (nowMs < primaryReadsUntil || nowMs < allReadsPrimaryUntil.load()) {
+        return connect();
+    }
+    
+    long long now = steadyMillis();
+    for (Link& replica : mine.replicas) {
+        if (now < replica.server->downUntilMs.load()) continue;
+        if (openLink(replica)) {
+            ++replicaReadCount;
+            return &replica;
+        }
+        replica.server->downUntilMs = now + policy.breakerCooldownMs;
+    }
+    return connect();
+}
+
+// Connect target if needed
+bool WorkoutDAO::openLink(Link& target) {
+    bool onPrimary = isPrimary(target);
+    
+    // Trust a connection that answered recently; only ping one that has sat
+    // idle long enough for the server to have dropped it. A connection that
+    // died anyway is caught by the query's error code (see runQuery).
+    if (target.connected && target.handle) {
+        auto idle = std::chrono::steady_clock::now() - target.lastActivity;
+        if (idle < std::chrono::seconds(policy.idlePingSec)) {
+            return true;
+        }
+        ++pingCount;
+        if (mysql_ping(target.handle) == 0) {
+            target.lastActivity = std::chrono::steady_clock::now();
+            return true;  // Already connected and alive
+        }
+    }
+    
+    // Database known to be down: fail now instead of waiting for a timeout
+    if (onPrimary && !breaker.allowRequest()) {
+        std::cerr << "Connection Error: database unavailable, retrying in "
+                  << breaker.retryAfterMs() << " ms" << std::endl;
+        return false;
+    }
+    
+    // A handle that lost its server cannot be connected again; start fresh
+    if (target.connected) {
+        closeLink(target);
     }
     
     // Initialize if not already initialized
-    if (!connection) {
-        connection = mysql_init(nullptr);
-        if (!connection) {
+    if (!target.handle) {
+        target.handle = mysql_init(nullptr);
+        if (!target.handle) {
             std::cerr << "MySQL initialization failed!" << std::endl;
+            if (onPrimary) breaker.recordFailure();
             return false;
         }
     }
     
-    // Only connect if not already connected
-    if (!mysql_real_connect(connection, host.c_str(), user.c_str(),
-                           password.c_str(), database.c_str(), port, nullptr, 0)) {
-        handleError("Connection");
+    // Bound every network wait so a hung server cannot hold a request forever
+    mysql_options(target.handle, MYSQL_OPT_CONNECT_TIMEOUT, &policy.connectTimeoutSec);
+    mysql_options(target.handle, MYSQL_OPT_READ_TIMEOUT, &policy.readTimeoutSec);
+    mysql_options(target.handle, MYSQL_OPT_WRITE_TIMEOUT, &policy.writeTimeoutSec);
+    
+    ++connectCount;
+    const Server& server = *target.server;
+    if (!mysql_real_connect(target.handle, server.host.c_str(), user.c_str(),
+                           password.c_str(), database.c_str(), server.port, nullptr, 0)) {
+        handleError(target, onPrimary ? "Connection" : "Replica Connection (" + server.host + ")");
+        if (onPrimary) breaker.recordFailure();
+        closeLink(target);
         return false;
     }
     
+    target.connected = true;
+    target.lastActivity = std::chrono::steady_clock::now();
+    if (onPrimary) breaker.recordSuccess();
     return true;
 }
 
-// Helper method to disconnect from database
+void WorkoutDAO::closeLink(Link& target) {
+    if (target.handle) {
+        mysql_close(target.handle);
+        target.handle = nullptr;
+    }
+    target.connected = false;
+    target.idStep = 0;
+}
+
+// Helper method to disconnect from database: every thread's links
 void WorkoutDAO::disconnect() {
-    if (connection) {
-        mysql_close(connection);
-        connection = nullptr;
+    std::lock_guard<std::mutex> lock(linksMutex);
+    for (auto& entry : threadLinkSets) {
+        closeLink(entry.second->primary);
+        for (Link& replica : entry.second->replicas) {
+            closeLink(replica);
+        }
+    }
+}
+
+// Client error codes meaning the connection itself is gone
+bool WorkoutDAO::isConnectionLost(unsigned int errorCode) {
+    return errorCode == CR_SERVER_GONE_ERROR || errorCode == CR_SERVER_LOST ||
+           errorCode == CR_CONN_HOST_ERROR || errorCode == CR_CONNECTION_ERROR;
+}
+
+// Send one statement. Any answer from the server proves the connection is
+// alive; a lost-connection error marks it dead so the next connect() replaces it.
+bool WorkoutDAO::sendQuery(Link& link, const std::string& query) {
+    ++queryCount;
+    if (mysql_query(link.handle, query.c_str()) == 0) {
+        link.lastActivity = std::chrono::steady_clock::now();
+        return true;
+    }
+    
+    if (isConnectionLost(mysql_errno(link.handle))) {
+        link.connected = false;
+        if (isPrimary(link)) {
+            breaker.recordFailure();
+        } else {
+            link.server->downUntilMs = steadyMillis() + policy.breakerCooldownMs;
+        }
+    } else {
+        link.lastActivity = std::chrono::steady_clock::now();
+    }
+    return false;
+}
+
+// Run a statement on link (from connect() or connectForRead()). After a lost
+// connection the statement is re-sent on a new one: reads up to
+// policy.readRetries times with jittered exponential backoff, writes once
+// and only when the statement could not be sent at all (CR_SERVER_GONE_ERROR),
+// since otherwise the server may already have applied it.
+bool WorkoutDAO::runQuery(Link*& link, const std::string& query, const std::string& operation, bool idempotent) {
+    if (!idempotent) duplicateWrite = false;
+    for (int attempt = 0; ; ++attempt) {
+        if (sendQuery(*link, query)) {
+            if (!idempotent) notePrimaryWrite();
+            return true;
+        }
+        
+        unsigned int errorCode = mysql_errno(link->handle);
+        handleError(*link, operation);
+        if (errorCode == ER_DUP_ENTRY) duplicateWrite = true;
+        if (link->connected) {
+            ++failureCount;
+            return false;  // SQL error: retrying will not help
+        }
+        
+        bool resendable = idempotent || errorCode == CR_SERVER_GONE_ERROR;
+        int maxRetries = idempotent ? policy.readRetries : 1;
+        if (!resendable || attempt >= maxRetries) {
+            ++failureCount;
+            return false;
+        }
+        
+        // The usual case is a connection the server closed while idle, so
+        // reconnect at once; back off only if that did not help. A read
+        // that lost its replica may be served by another one or the primary.
+        if (attempt > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(policy.backoffDelayMs(attempt - 1)));
+        }
+        ++retryCount;
+        Link* reconnected = isPrimary(*link) ? connect() : connectForRead();
+        if (!reconnected) {
+            return false;
+        }
+        link = reconnected;
     }
 }
 
+// Round trips made so far
+ConnectionStats WorkoutDAO::getConnectionStats() const {
+    ConnectionStats stats;
+    stats.queries = queryCount;
+    stats.pings = pingCount;
+    stats.connects = connectCount;
+    stats.retries = retryCount;
+    stats.replicaReads = replicaReadCount;
+    return stats;
+}
+
 // Helper method to handle errors
-void WorkoutDAO::handleError(const std::string& operation) {
-    std::cerr << operation << " Error: " << mysql_error(connection) << std::endl;
+void WorkoutDAO::handleError(Link& link, const std::string& operation) {
+    std::cerr << operation << " Error: " << mysql_error(link.handle) << std::endl;
 }
 
 // Test database connection
@@ -70,174 +349,197 @@ bool WorkoutDAO::testConnection() {
     return true;
 }
 
-// Get last inserted ID
-int WorkoutDAO::getLastInsertId() {
-    return static_cast<int>(mysql_insert_id(connection));
+// Id generated by the last insert on link
+int WorkoutDAO::lastInsertId(Link& link) {
+    return link.handle ? static_cast<int>(mysql_insert_id(link.handle)) : 0;
 }
 
-// ==================== WORKOUT CRUD OPERATIONS ====================
+void WorkoutDAO::setDuplicateWrite(bool duplicate) {
+    duplicateWrite = duplicate;
+}
 
-// Create Workout
-bool WorkoutDAO::createWorkout(const Workout& workout) {
-    if (!connect()) return false;
+void WorkoutDAO::noteFailure() {
+    ++failureCount;
+}
+
+unsigned long long WorkoutDAO::getFailureCount() {
+    return failureCount;
+}
+
+bool WorkoutDAO::lastWriteWasDuplicate() const {
+    return duplicateWrite;
+}
+
+// Get last inserted ID. Connections are per thread, so this is the id of
+// the calling thread's own last insert.
+int WorkoutDAO::getLastInsertId() {
+    return lastInsertId(threadLinks().primary);
+}
+
+// Run a SELECT built from selectFrom<T>() and decode every row
+template<typename T>
+ResultSet<T> WorkoutDAO::readList(Link* link, const std::string& query, const std::string& operation) {
+    ResultSet<T> list;
     
-    std::string query = "INSERT INTO Workout (workout_date, workout_time, duration, "
-                       "type_description, calories_burned, rate_perceived_exhaustion, muscle_group_id) "
-                       "VALUES ('" + workout.getWorkoutDate() + "', '" + workout.getWorkoutTime() + "', "
-                       + std::to_string(workout.getDuration()) + ", '" + workout.getTypeDescription() + "', "
-                       + std::to_string(workout.getCaloriesBurned()) + ", "
-                       + std::to_string(workout.getRatePerceivedExhaustion()) + ", ";
+    if (!runQuery(link, query, operation, true)) {
+        return list;
+    }
     
-    if (workout.getMuscleGroupId() > 0) {
-        query += std::to_string(workout.getMuscleGroupId()) + ")";
-    } else {
-        query += "NULL)";
+    MYSQL_RES* result = mysql_store_result(link->handle);
+    if (!result) {
+        ++failureCount;
+        return list;
     }
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Create Workout");
-        return false;
+    list.reserve(mysql_num_rows(result));
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        decodeRow(row, list.add());
     }
     
-    std::cout << "Workout created successfully with ID: " << getLastInsertId() << std::endl;
-    return true;
+    mysql_free_result(result);
+    return list;
 }
 
-// Read single Workout by ID
-Workout* WorkoutDAO::readWorkout(int workoutId) {
-    if (!connect()) return nullptr;
-    
-    std::string query = "SELECT * FROM Workout WHERE workout_id = " + std::to_string(workoutId);
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Workout");
+// Run a SELECT built from selectFrom<T>() and decode the first row, if any
+template<typename T>
+T* WorkoutDAO::readOne(Link* link, const std::string& query, const std::string& operation) {
+    if (!runQuery(link, query, operation, true)) {
         return nullptr;
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
+    MYSQL_RES* result = mysql_store_result(link->handle);
+    if (!result) {
+        ++failureCount;
+        return nullptr;
+    }
     
     MYSQL_ROW row = mysql_fetch_row(result);
-    Workout* workout = nullptr;
-    
+    T* entity = nullptr;
     if (row) {
-        workout = new Workout();
-        workout->setWorkoutId(std::stoi(row[0]));
-        workout->setWorkoutDate(row[1]);
-        workout->setWorkoutTime(row[2]);
-        workout->setDuration(std::stoi(row[3]));
-        workout->setTypeDescription(row[4] ? row[4] : "");
-        workout->setCaloriesBurned(row[5] ? std::stod(row[5]) : 0.0);
-        workout->setRatePerceivedExhaustion(row[6] ? std::stoi(row[6]) : 0);
-        workout->setMuscleGroupId(row[7] ? std::stoi(row[7]) : 0);
+        entity = new T();
+        decodeRow(row, *entity);
     }
     
     mysql_free_result(result);
-    return workout;
+    return entity;
 }
 
-// Read all Workouts
-std::vector<Workout*> WorkoutDAO::readAllWorkouts() {
-    std::vector<Workout*> workouts;
-    if (!connect()) return workouts;
+// Read the change counter of one of the five tables
+bool WorkoutDAO::readTableVersion(const std::string& table, long long& version) {
+    // Only the known tables have a counter (and no escaping is needed)
+    static const char* const tables[] = {"Workout", "MuscleGroup", "Nutrition", "Recovery", "Equipment"};
+    bool known = false;
+    for (const char* name : tables) {
+        if (table == name) known = true;
+    }
+    if (!known) return false;
+    
+    Link* link = connectForRead();
+    if (!link) return false;
     
-    std::string query = "SELECT * FROM Workout ORDER BY workout_date DESC, workout_time DESC";
+    std::string query = "SELECT version FROM TableVersion WHERE table_name = '" + table + "'";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read All Workouts");
-        return workouts;
+    if (!runQuery(link, query, "Read Table Version", true)) {
+        return false;
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return workouts;
+    MYSQL_RES* result = mysql_store_result(link->handle);
+    if (!result) return false;
     
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Workout* workout = new Workout();
-        workout->setWorkoutId(std::stoi(row[0]));
-        workout->setWorkoutDate(row[1]);
-        workout->setWorkoutTime(row[2]);
-        workout->setDuration(std::stoi(row[3]));
-        workout->setTypeDescription(row[4] ? row[4] : "");
-        workout->setCaloriesBurned(row[5] ? std::stod(row[5]) : 0.0);
-        workout->setRatePerceivedExhaustion(row[6] ? std::stoi(row[6]) : 0);
-        workout->setMuscleGroupId(row[7] ? std::stoi(row[7]) : 0);
-        workouts.push_back(workout);
+    MYSQL_ROW row = mysql_fetch_row(result);
+    bool found = false;
+    
+    if (row) {
+        version = row[0] ? std::stoll(row[0]) : 0;
+        found = true;
     }
     
     mysql_free_result(result);
-    return workouts;
+    return found;
 }
 
-// Read Workouts by date
-std::vector<Workout*> WorkoutDAO::readWorkoutsByDate(const std::string& date) {
-    std::vector<Workout*> workouts;
-    if (!connect()) return workouts;
+// ==================== WORKOUT CRUD OPERATIONS ====================
+
+// Create Workout
+bool WorkoutDAO::createWorkout(const Workout& workout) {
+    Link* link = connect();
+    if (!link) return false;
     
-    std::string query = "SELECT * FROM Workout WHERE workout_date = '" + date + "'";
+    std::string query = "INSERT INTO Workout (workout_date, workout_time, duration, "
+                       "type_description, calories_burned, rate_perceived_exhaustion, muscle_group_id) "
+                       "VALUES ('" + workout.getWorkoutDate() + "', '" + workout.getWorkoutTime() + "', "
+                       + std::to_string(workout.getDuration()) + ", '" + workout.getTypeDescription() + "', "
+                       + std::to_string(workout.getCaloriesBurned()) + ", "
+                       + std::to_string(workout.getRatePerceivedExhaustion()) + ", ";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Workouts by Date");
-        return workouts;
+    if (workout.getMuscleGroupId() > 0) {
+        query += std::to_string(workout.getMuscleGroupId()) + ")";
+    } else {
+        query += "NULL)";
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return workouts;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Workout* workout = new Workout();
-        workout->setWorkoutId(std::stoi(row[0]));
-        workout->setWorkoutDate(row[1]);
-        workout->setWorkoutTime(row[2]);
-        workout->setDuration(std::stoi(row[3]));
-        workout->setTypeDescription(row[4] ? row[4] : "");
-        workout->setCaloriesBurned(row[5] ? std::stod(row[5]) : 0.0);
-        workout->setRatePerceivedExhaustion(row[6] ? std::stoi(row[6]) : 0);
-        workout->setMuscleGroupId(row[7] ? std::stoi(row[7]) : 0);
-        workouts.push_back(workout);
+    if (!runQuery(link, query, "Create Workout", false)) {
+        return false;
     }
     
-    mysql_free_result(result);
-    return workouts;
+    std::cout << "Workout created successfully with ID: " << lastInsertId(*link) << std::endl;
+    return true;
 }
 
-// Read Workouts by muscle group
-std::vector<Workout*> WorkoutDAO::readWorkoutsByMuscleGroup(int muscleGroupId) {
-    std::vector<Workout*> workouts;
-    if (!connect()) return workouts;
-    
-    std::string query = "SELECT * FROM Workout WHERE muscle_group_id = " + std::to_string(muscleGroupId);
+// Read single Workout by ID
+Workout* WorkoutDAO::readWorkout(int workoutId) {
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Workouts by Muscle Group");
-        return workouts;
-    }
+    std::string query = selectFrom<Workout>() + " WHERE workout_id = " + std::to_string(workoutId);
+    return readOne<Workout>(link, query, "Read Workout");
+}
+
+// Read several Workouts by ID with one IN (...) query. Rows come back in the
+// order of the first mention of each ID; unknown IDs are skipped.
+ResultSet<Workout> WorkoutDAO::readWorkoutsByIds(const std::vector<int>& workoutIds) {
+    if (workoutIds.empty()) return ResultSet<Workout>();
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Workout>();
+    
+    std::string idList = joinIds(workoutIds);
+    std::string query = selectFrom<Workout>() + " WHERE workout_id IN (" + idList + ")" +
+                        " ORDER BY FIELD(workout_id, " + idList + ")";
+    return readList<Workout>(link, query, "Read Workouts by IDs");
+}
+
+// Read all Workouts
+ResultSet<Workout> WorkoutDAO::readAllWorkouts() {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Workout>();
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return workouts;
+    std::string query = selectFrom<Workout>() + " ORDER BY workout_date DESC, workout_time DESC";
+    return readList<Workout>(link, query, "Read All Workouts");
+}
+
+// Read Workouts by date
+ResultSet<Workout> WorkoutDAO::readWorkoutsByDate(const std::string& date) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Workout>();
     
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Workout* workout = new Workout();
-        workout->setWorkoutId(std::stoi(row[0]));
-        workout->setWorkoutDate(row[1]);
-        workout->setWorkoutTime(row[2]);
-        workout->setDuration(std::stoi(row[3]));
-        workout->setTypeDescription(row[4] ? row[4] : "");
-        workout->setCaloriesBurned(row[5] ? std::stod(row[5]) : 0.0);
-        workout->setRatePerceivedExhaustion(row[6] ? std::stoi(row[6]) : 0);
-        workout->setMuscleGroupId(row[7] ? std::stoi(row[7]) : 0);
-        workouts.push_back(workout);
-    }
+    std::string query = selectFrom<Workout>() + " WHERE workout_date = '" + date + "'";
+    return readList<Workout>(link, query, "Read Workouts by Date");
+}
+
+// Read Workouts by muscle group
+ResultSet<Workout> WorkoutDAO::readWorkoutsByMuscleGroup(int muscleGroupId) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Workout>();
     
-    mysql_free_result(result);
-    return workouts;
+    std::string query = selectFrom<Workout>() + " WHERE muscle_group_id = " + std::to_string(muscleGroupId);
+    return readList<Workout>(link, query, "Read Workouts by Muscle Group");
 }
 
 // Update Workout
 bool WorkoutDAO::updateWorkout(const Workout& workout) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "UPDATE Workout SET "
                        "workout_date = '" + workout.getWorkoutDate() + "', "
@@ -256,8 +558,7 @@ bool WorkoutDAO::updateWorkout(const Workout& workout) {
     
     query += " WHERE workout_id = " + std::to_string(workout.getWorkoutId());
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Update Workout");
+    if (!runQuery(link, query, "Update Workout", false)) {
         return false;
     }
     
@@ -267,12 +568,12 @@ bool WorkoutDAO::updateWorkout(const Workout& workout) {
 
 // Delete Workout
 bool WorkoutDAO::deleteWorkout(int workoutId) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "DELETE FROM Workout WHERE workout_id = " + std::to_string(workoutId);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Delete Workout");
+    if (!runQuery(link, query, "Delete Workout", false)) {
         return false;
     }
     
@@ -284,7 +585,8 @@ bool WorkoutDAO::deleteWorkout(int workoutId) {
 
 // Create MuscleGroup
 bool WorkoutDAO::createMuscleGroup(const MuscleGroup& muscleGroup) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "INSERT INTO MuscleGroup (name, description, days_per_week, "
                        "sets, reps, weight_amount) VALUES ('"
@@ -294,114 +596,57 @@ bool WorkoutDAO::createMuscleGroup(const MuscleGroup& muscleGroup) {
                        + std::to_string(muscleGroup.getReps()) + ", "
                        + std::to_string(muscleGroup.getWeightAmount()) + ")";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Create MuscleGroup");
+    if (!runQuery(link, query, "Create MuscleGroup", false)) {
         return false;
     }
     
-    std::cout << "MuscleGroup created successfully with ID: " << getLastInsertId() << std::endl;
+    std::cout << "MuscleGroup created successfully with ID: " << lastInsertId(*link) << std::endl;
     return true;
 }
 
 // Read single MuscleGroup by ID
 MuscleGroup* WorkoutDAO::readMuscleGroup(int muscleGroupId) {
-    if (!connect()) return nullptr;
-    
-    std::string query = "SELECT * FROM MuscleGroup WHERE muscle_group_id = " + std::to_string(muscleGroupId);
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read MuscleGroup");
-        return nullptr;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    MuscleGroup* muscleGroup = nullptr;
-    
-    if (row) {
-        muscleGroup = new MuscleGroup();
-        muscleGroup->setMuscleGroupId(std::stoi(row[0]));
-        muscleGroup->setName(row[1]);
-        muscleGroup->setDescription(row[2] ? row[2] : "");
-        muscleGroup->setDaysPerWeek(row[3] ? std::stoi(row[3]) : 0);
-        muscleGroup->setSets(row[4] ? std::stoi(row[4]) : 0);
-        muscleGroup->setReps(row[5] ? std::stoi(row[5]) : 0);
-        muscleGroup->setWeightAmount(row[6] ? std::stod(row[6]) : 0.0);
-    }
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    mysql_free_result(result);
-    return muscleGroup;
+    std::string query = selectFrom<MuscleGroup>() + " WHERE muscle_group_id = " + std::to_string(muscleGroupId);
+    return readOne<MuscleGroup>(link, query, "Read MuscleGroup");
+}
+
+// Read several MuscleGroups by ID with one query, in the order given
+ResultSet<MuscleGroup> WorkoutDAO::readMuscleGroupsByIds(const std::vector<int>& muscleGroupIds) {
+    if (muscleGroupIds.empty()) return ResultSet<MuscleGroup>();
+    Link* link = connectForRead();
+    if (!link) return ResultSet<MuscleGroup>();
+    
+    std::string idList = joinIds(muscleGroupIds);
+    std::string query = selectFrom<MuscleGroup>() + " WHERE muscle_group_id IN (" + idList + ")" +
+                        " ORDER BY FIELD(muscle_group_id, " + idList + ")";
+    return readList<MuscleGroup>(link, query, "Read MuscleGroups by IDs");
 }
 
 // Read all MuscleGroups
-std::vector<MuscleGroup*> WorkoutDAO::readAllMuscleGroups() {
-    std::vector<MuscleGroup*> muscleGroups;
-    if (!connect()) return muscleGroups;
+ResultSet<MuscleGroup> WorkoutDAO::readAllMuscleGroups() {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<MuscleGroup>();
     
-    std::string query = "SELECT * FROM MuscleGroup ORDER BY name";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read All MuscleGroups");
-        return muscleGroups;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return muscleGroups;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        MuscleGroup* muscleGroup = new MuscleGroup();
-        muscleGroup->setMuscleGroupId(std::stoi(row[0]));
-        muscleGroup->setName(row[1]);
-        muscleGroup->setDescription(row[2] ? row[2] : "");
-        muscleGroup->setDaysPerWeek(row[3] ? std::stoi(row[3]) : 0);
-        muscleGroup->setSets(row[4] ? std::stoi(row[4]) : 0);
-        muscleGroup->setReps(row[5] ? std::stoi(row[5]) : 0);
-        muscleGroup->setWeightAmount(row[6] ? std::stod(row[6]) : 0.0);
-        muscleGroups.push_back(muscleGroup);
-    }
-    
-    mysql_free_result(result);
-    return muscleGroups;
+    std::string query = selectFrom<MuscleGroup>() + " ORDER BY name";
+    return readList<MuscleGroup>(link, query, "Read All MuscleGroups");
 }
 
 // Read MuscleGroup by name
 MuscleGroup* WorkoutDAO::readMuscleGroupByName(const std::string& name) {
-    if (!connect()) return nullptr;
-    
-    std::string query = "SELECT * FROM MuscleGroup WHERE name = '" + name + "'";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read MuscleGroup by Name");
-        return nullptr;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    MuscleGroup* muscleGroup = nullptr;
-    
-    if (row) {
-        muscleGroup = new MuscleGroup();
-        muscleGroup->setMuscleGroupId(std::stoi(row[0]));
-        muscleGroup->setName(row[1]);
-        muscleGroup->setDescription(row[2] ? row[2] : "");
-        muscleGroup->setDaysPerWeek(row[3] ? std::stoi(row[3]) : 0);
-        muscleGroup->setSets(row[4] ? std::stoi(row[4]) : 0);
-        muscleGroup->setReps(row[5] ? std::stoi(row[5]) : 0);
-        muscleGroup->setWeightAmount(row[6] ? std::stod(row[6]) : 0.0);
-    }
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    mysql_free_result(result);
-    return muscleGroup;
+    std::string query = selectFrom<MuscleGroup>() + " WHERE name = '" + name + "'";
+    return readOne<MuscleGroup>(link, query, "Read MuscleGroup by Name");
 }
 
 // Update MuscleGroup
 bool WorkoutDAO::updateMuscleGroup(const MuscleGroup& muscleGroup) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "UPDATE MuscleGroup SET "
                        "name = '" + muscleGroup.getName() + "', "
@@ -412,8 +657,7 @@ bool WorkoutDAO::updateMuscleGroup(const MuscleGroup& muscleGroup) {
                        "weight_amount = " + std::to_string(muscleGroup.getWeightAmount()) +
                        " WHERE muscle_group_id = " + std::to_string(muscleGroup.getMuscleGroupId());
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Update MuscleGroup");
+    if (!runQuery(link, query, "Update MuscleGroup", false)) {
         return false;
     }
     
@@ -423,12 +667,12 @@ bool WorkoutDAO::updateMuscleGroup(const MuscleGroup& muscleGroup) {
 
 // Delete MuscleGroup
 bool WorkoutDAO::deleteMuscleGroup(int muscleGroupId) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "DELETE FROM MuscleGroup WHERE muscle_group_id = " + std::to_string(muscleGroupId);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Delete MuscleGroup");
+    if (!runQuery(link, query, "Delete MuscleGroup", false)) {
         return false;
     }
     
@@ -440,7 +684,8 @@ bool WorkoutDAO::deleteMuscleGroup(int muscleGroupId) {
 
 // Create Nutrition
 bool WorkoutDAO::createNutrition(const Nutrition& nutrition) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "INSERT INTO Nutrition (family, water, carbs, fat, protein, sugar, meal_date) "
                        "VALUES ('" + nutrition.getFamilyString() + "', "
@@ -456,150 +701,54 @@ bool WorkoutDAO::createNutrition(const Nutrition& nutrition) {
         query += "NULL)";
     }
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Create Nutrition");
+    if (!runQuery(link, query, "Create Nutrition", false)) {
         return false;
     }
     
-    std::cout << "Nutrition entry created successfully with ID: " << getLastInsertId() << std::endl;
+    std::cout << "Nutrition entry created successfully with ID: " << lastInsertId(*link) << std::endl;
     return true;
 }
 
 // Read single Nutrition by ID
 Nutrition* WorkoutDAO::readNutrition(int nutritionId) {
-    if (!connect()) return nullptr;
-    
-    std::string query = "SELECT * FROM Nutrition WHERE nutrition_id = " + std::to_string(nutritionId);
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Nutrition");
-        return nullptr;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    Nutrition* nutrition = nullptr;
-    
-    if (row) {
-        nutrition = new Nutrition();
-        nutrition->setNutritionId(std::stoi(row[0]));
-        nutrition->setFamilyFromString(row[1]);
-        nutrition->setWater(row[2] ? std::stod(row[2]) : 0.0);
-        nutrition->setCarbs(row[3] ? std::stod(row[3]) : 0.0);
-        nutrition->setFat(row[4] ? std::stod(row[4]) : 0.0);
-        nutrition->setProtein(row[5] ? std::stod(row[5]) : 0.0);
-        nutrition->setSugar(row[6] ? std::stod(row[6]) : 0.0);
-        nutrition->setMealDate(row[7] ? row[7] : "");
-    }
-    
-    mysql_free_result(result);
-    return nutrition;
+    std::string query = selectFrom<Nutrition>() + " WHERE nutrition_id = " + std::to_string(nutritionId);
+    return readOne<Nutrition>(link, query, "Read Nutrition");
 }
 
 // Read all Nutrition entries
-std::vector<Nutrition*> WorkoutDAO::readAllNutrition() {
-    std::vector<Nutrition*> nutritionList;
-    if (!connect()) return nutritionList;
+ResultSet<Nutrition> WorkoutDAO::readAllNutrition() {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Nutrition>();
     
-    std::string query = "SELECT * FROM Nutrition ORDER BY meal_date DESC";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read All Nutrition");
-        return nutritionList;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nutritionList;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Nutrition* nutrition = new Nutrition();
-        nutrition->setNutritionId(std::stoi(row[0]));
-        nutrition->setFamilyFromString(row[1]);
-        nutrition->setWater(row[2] ? std::stod(row[2]) : 0.0);
-        nutrition->setCarbs(row[3] ? std::stod(row[3]) : 0.0);
-        nutrition->setFat(row[4] ? std::stod(row[4]) : 0.0);
-        nutrition->setProtein(row[5] ? std::stod(row[5]) : 0.0);
-        nutrition->setSugar(row[6] ? std::stod(row[6]) : 0.0);
-        nutrition->setMealDate(row[7] ? row[7] : "");
-        nutritionList.push_back(nutrition);
-    }
-    
-    mysql_free_result(result);
-    return nutritionList;
+    std::string query = selectFrom<Nutrition>() + " ORDER BY meal_date DESC";
+    return readList<Nutrition>(link, query, "Read All Nutrition");
 }
 
 // Read Nutrition by date
-std::vector<Nutrition*> WorkoutDAO::readNutritionByDate(const std::string& date) {
-    std::vector<Nutrition*> nutritionList;
-    if (!connect()) return nutritionList;
-    
-    std::string query = "SELECT * FROM Nutrition WHERE meal_date = '" + date + "'";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Nutrition by Date");
-        return nutritionList;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nutritionList;
+ResultSet<Nutrition> WorkoutDAO::readNutritionByDate(const std::string& date) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Nutrition>();
     
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Nutrition* nutrition = new Nutrition();
-        nutrition->setNutritionId(std::stoi(row[0]));
-        nutrition->setFamilyFromString(row[1]);
-        nutrition->setWater(row[2] ? std::stod(row[2]) : 0.0);
-        nutrition->setCarbs(row[3] ? std::stod(row[3]) : 0.0);
-        nutrition->setFat(row[4] ? std::stod(row[4]) : 0.0);
-        nutrition->setProtein(row[5] ? std::stod(row[5]) : 0.0);
-        nutrition->setSugar(row[6] ? std::stod(row[6]) : 0.0);
-        nutrition->setMealDate(row[7] ? row[7] : "");
-        nutritionList.push_back(nutrition);
-    }
-    
-    mysql_free_result(result);
-    return nutritionList;
+    std::string query = selectFrom<Nutrition>() + " WHERE meal_date = '" + date + "'";
+    return readList<Nutrition>(link, query, "Read Nutrition by Date");
 }
 
 // Read Nutrition by family
-std::vector<Nutrition*> WorkoutDAO::readNutritionByFamily(const std::string& family) {
-    std::vector<Nutrition*> nutritionList;
-    if (!connect()) return nutritionList;
-    
-    std::string query = "SELECT * FROM Nutrition WHERE family = '" + family + "'";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Nutrition by Family");
-        return nutritionList;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nutritionList;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Nutrition* nutrition = new Nutrition();
-        nutrition->setNutritionId(std::stoi(row[0]));
-        nutrition->setFamilyFromString(row[1]);
-        nutrition->setWater(row[2] ? std::stod(row[2]) : 0.0);
-        nutrition->setCarbs(row[3] ? std::stod(row[3]) : 0.0);
-        nutrition->setFat(row[4] ? std::stod(row[4]) : 0.0);
-        nutrition->setProtein(row[5] ? std::stod(row[5]) : 0.0);
-        nutrition->setSugar(row[6] ? std::stod(row[6]) : 0.0);
-        nutrition->setMealDate(row[7] ? row[7] : "");
-        nutritionList.push_back(nutrition);
-    }
+ResultSet<Nutrition> WorkoutDAO::readNutritionByFamily(const std::string& family) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Nutrition>();
     
-    mysql_free_result(result);
-    return nutritionList;
+    std::string query = selectFrom<Nutrition>() + " WHERE family = '" + family + "'";
+    return readList<Nutrition>(link, query, "Read Nutrition by Family");
 }
 
 // Update Nutrition
 bool WorkoutDAO::updateNutrition(const Nutrition& nutrition) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "UPDATE Nutrition SET "
                        "family = '" + nutrition.getFamilyString() + "', "
@@ -618,8 +767,7 @@ bool WorkoutDAO::updateNutrition(const Nutrition& nutrition) {
     
     query += " WHERE nutrition_id = " + std::to_string(nutrition.getNutritionId());
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Update Nutrition");
+    if (!runQuery(link, query, "Update Nutrition", false)) {
         return false;
     }
     
@@ -629,12 +777,12 @@ bool WorkoutDAO::updateNutrition(const Nutrition& nutrition) {
 
 // Delete Nutrition
 bool WorkoutDAO::deleteNutrition(int nutritionId) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "DELETE FROM Nutrition WHERE nutrition_id = " + std::to_string(nutritionId);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Delete Nutrition");
+    if (!runQuery(link, query, "Delete Nutrition", false)) {
         return false;
     }
     
@@ -647,145 +795,62 @@ bool WorkoutDAO::deleteNutrition(int nutritionId) {
 
 // Create Recovery
 bool WorkoutDAO::createRecovery(const Recovery& recovery) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "INSERT INTO Recovery (recovery_date, duration, type, helpers) "
                        "VALUES ('" + recovery.getRecoveryDate() + "', "
                        + std::to_string(recovery.getDuration()) + ", '"
                        + recovery.getType() + "', '" + recovery.getHelpers() + "')";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Create Recovery");
+    if (!runQuery(link, query, "Create Recovery", false)) {
         return false;
     }
     
-    std::cout << "Recovery entry created successfully with ID: " << getLastInsertId() << std::endl;
+    std::cout << "Recovery entry created successfully with ID: " << lastInsertId(*link) << std::endl;
     return true;
 }
 
 // Read single Recovery by ID
 Recovery* WorkoutDAO::readRecovery(int recoveryId) {
-    if (!connect()) return nullptr;
-    
-    std::string query = "SELECT * FROM Recovery WHERE recovery_id = " + std::to_string(recoveryId);
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Recovery");
-        return nullptr;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
-    
-    MYSQL_ROW row = mysql_fetch_row(result);
-    Recovery* recovery = nullptr;
-    
-    if (row) {
-        recovery = new Recovery();
-        recovery->setRecoveryId(std::stoi(row[0]));
-        recovery->setRecoveryDate(row[1]);
-        recovery->setDuration(std::stoi(row[2]));
-        recovery->setType(row[3] ? row[3] : "");
-        recovery->setHelpers(row[4] ? row[4] : "");
-    }
-    
-    mysql_free_result(result);
-    return recovery;
+    std::string query = selectFrom<Recovery>() + " WHERE recovery_id = " + std::to_string(recoveryId);
+    return readOne<Recovery>(link, query, "Read Recovery");
 }
 
 // Read all Recovery entries
-std::vector<Recovery*> WorkoutDAO::readAllRecovery() {
-    std::vector<Recovery*> recoveryList;
-    if (!connect()) return recoveryList;
-    
-    std::string query = "SELECT * FROM Recovery ORDER BY recovery_date DESC";
+ResultSet<Recovery> WorkoutDAO::readAllRecovery() {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Recovery>();
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read All Recovery");
-        return recoveryList;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return recoveryList;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Recovery* recovery = new Recovery();
-        recovery->setRecoveryId(std::stoi(row[0]));
-        recovery->setRecoveryDate(row[1]);
-        recovery->setDuration(std::stoi(row[2]));
-        recovery->setType(row[3] ? row[3] : "");
-        recovery->setHelpers(row[4] ? row[4] : "");
-        recoveryList.push_back(recovery);
-    }
-    
-    mysql_free_result(result);
-    return recoveryList;
+    std::string query = selectFrom<Recovery>() + " ORDER BY recovery_date DESC";
+    return readList<Recovery>(link, query, "Read All Recovery");
 }
 
 // Read Recovery by date
-std::vector<Recovery*> WorkoutDAO::readRecoveryByDate(const std::string& date) {
-    std::vector<Recovery*> recoveryList;
-    if (!connect()) return recoveryList;
-    
-    std::string query = "SELECT * FROM Recovery WHERE recovery_date = '" + date + "'";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Recovery by Date");
-        return recoveryList;
-    }
-    
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return recoveryList;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Recovery* recovery = new Recovery();
-        recovery->setRecoveryId(std::stoi(row[0]));
-        recovery->setRecoveryDate(row[1]);
-        recovery->setDuration(std::stoi(row[2]));
-        recovery->setType(row[3] ? row[3] : "");
-        recovery->setHelpers(row[4] ? row[4] : "");
-        recoveryList.push_back(recovery);
-    }
+ResultSet<Recovery> WorkoutDAO::readRecoveryByDate(const std::string& date) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Recovery>();
     
-    mysql_free_result(result);
-    return recoveryList;
+    std::string query = selectFrom<Recovery>() + " WHERE recovery_date = '" + date + "'";
+    return readList<Recovery>(link, query, "Read Recovery by Date");
 }
 
 // Read Recovery by type
-std::vector<Recovery*> WorkoutDAO::readRecoveryByType(const std::string& type) {
-    std::vector<Recovery*> recoveryList;
-    if (!connect()) return recoveryList;
-    
-    std::string query = "SELECT * FROM Recovery WHERE type = '" + type + "'";
-    
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Recovery by Type");
-        return recoveryList;
-    }
+ResultSet<Recovery> WorkoutDAO::readRecoveryByType(const std::string& type) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Recovery>();
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return recoveryList;
-    
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Recovery* recovery = new Recovery();
-        recovery->setRecoveryId(std::stoi(row[0]));
-        recovery->setRecoveryDate(row[1]);
-        recovery->setDuration(std::stoi(row[2]));
-        recovery->setType(row[3] ? row[3] : "");
-        recovery->setHelpers(row[4] ? row[4] : "");
-        recoveryList.push_back(recovery);
-    }
-    
-    mysql_free_result(result);
-    return recoveryList;
+    std::string query = selectFrom<Recovery>() + " WHERE type = '" + type + "'";
+    return readList<Recovery>(link, query, "Read Recovery by Type");
 }
 
 // Update Recovery
 bool WorkoutDAO::updateRecovery(const Recovery& recovery) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "UPDATE Recovery SET "
                        "recovery_date = '" + recovery.getRecoveryDate() + "', "
@@ -794,8 +859,7 @@ bool WorkoutDAO::updateRecovery(const Recovery& recovery) {
                        "helpers = '" + recovery.getHelpers() + "' "
                        "WHERE recovery_id = " + std::to_string(recovery.getRecoveryId());
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Update Recovery");
+    if (!runQuery(link, query, "Update Recovery", false)) {
         return false;
     }
     
@@ -805,12 +869,12 @@ bool WorkoutDAO::updateRecovery(const Recovery& recovery) {
 
 // Delete Recovery
 bool WorkoutDAO::deleteRecovery(int recoveryId) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "DELETE FROM Recovery WHERE recovery_id = " + std::to_string(recoveryId);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Delete Recovery");
+    if (!runQuery(link, query, "Delete Recovery", false)) {
         return false;
     }
     
@@ -822,7 +886,8 @@ bool WorkoutDAO::deleteRecovery(int recoveryId) {
 
 // Create Equipment
 bool WorkoutDAO::createEquipment(const Equipment& equipment) {
-    if (!connect()) return false;
+    Link* link = connect();
+    if (!link) return false;
     
     std::string query = "INSERT INTO Equipment (name, description, category, target) "
                        "VALUES ('" + equipment.getName() + "', '"
@@ -830,166 +895,529 @@ bool WorkoutDAO::createEquipment(const Equipment& equipment) {
                        + equipment.getCategory() + "', '"
                        + equipment.getTarget() + "')";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Create Equipment");
+    if (!runQuery(link, query, "Create Equipment", false)) {
         return false;
     }
     
-    std::cout << "Equipment created successfully with ID: " << getLastInsertId() << std::endl;
+    std::cout << "Equipment created successfully with ID: " << lastInsertId(*link) << std::endl;
     return true;
 }
 
 // Read single Equipment by ID
 Equipment* WorkoutDAO::readEquipment(int equipmentId) {
-    if (!connect()) return nullptr;
+    Link* link = connectForRead();
+    if (!link) return nullptr;
     
-    std::string query = "SELECT * FROM Equipment WHERE equipment_id = " + std::to_string(equipmentId);
+    std::string query = selectFrom<Equipment>() + " WHERE equipment_id = " + std::to_string(equipmentId);
+    return readOne<Equipment>(link, query, "Read Equipment");
+}
+
+// Read all Equipment
+ResultSet<Equipment> WorkoutDAO::readAllEquipment() {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Equipment>();
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Equipment");
-        return nullptr;
+    std::string query = selectFrom<Equipment>() + " ORDER BY name";
+    return readList<Equipment>(link, query, "Read All Equipment");
+}
+
+// Read Equipment by category
+ResultSet<Equipment> WorkoutDAO::readEquipmentByCategory(const std::string& category) {
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Equipment>();
+    
+    std::string query = selectFrom<Equipment>() + " WHERE category = '" + category + "'";
+    return readList<Equipment>(link, query, "Read Equipment by Category");
+}
+
+// Read Equipment by name
+Equipment* WorkoutDAO::readEquipmentByName(const std::string& name) {
+    Link* link = connectForRead();
+    if (!link) return nullptr;
+    
+    std::string query = selectFrom<Equipment>() + " WHERE name = '" + name + "'";
+    return readOne<Equipment>(link, query, "Read Equipment by Name");
+}
+
+// Update Equipment
+bool WorkoutDAO::updateEquipment(const Equipment& equipment) {
+    Link* link = connect();
+    if (!link) return false;
+    
+    std::string query = "UPDATE Equipment SET "
+                       "name = '" + equipment.getName() + "', "
+                       "description = '" + equipment.getDescription() + "', "
+                       "category = '" + equipment.getCategory() + "', "
+                       "target = '" + equipment.getTarget() + "' "
+                       "WHERE equipment_id = " + std::to_string(equipment.getEquipmentId());
+    
+    if (!runQuery(link, query, "Update Equipment", false)) {
+        return false;
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
+    std::cout << "Equipment updated successfully!" << std::endl;
+    return true;
+}
+
+// Delete Equipment
+bool WorkoutDAO::deleteEquipment(int equipmentId) {
+    Link* link = connect();
+    if (!link) return false;
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    Equipment* equipment = nullptr;
+    std::string query = "DELETE FROM Equipment WHERE equipment_id = " + std::to_string(equipmentId);
     
-    if (row) {
-        equipment = new Equipment();
-        equipment->setEquipmentId(std::stoi(row[0]));
-        equipment->setName(row[1]);
-        equipment->setDescription(row[2] ? row[2] : "");
-        equipment->setCategory(row[3] ? row[3] : "");
-        equipment->setTarget(row[4] ? row[4] : "");
+    if (!runQuery(link, query, "Delete Equipment", false)) {
+        return false;
     }
     
-    mysql_free_result(result);
-    return equipment;
+    std::cout << "Equipment deleted successfully!" << std::endl;
+    return true;
 }
 
-// Read all Equipment
-std::vector<Equipment*> WorkoutDAO::readAllEquipment() {
-    std::vector<Equipment*> equipmentList;
-    if (!connect()) return equipmentList;
+// ==================== FILTERED QUERIES ====================
+
+// Escape a value for use inside single quotes
+std::string WorkoutDAO::escapeString(Link& link, const std::string& value) {
+    std::string escaped(value.size() * 2 + 1, '\0');
+    unsigned long length = mysql_real_escape_string(link.handle, &escaped[0],
+                                                    value.c_str(), value.size());
+    escaped.resize(length);
+    return escaped;
+}
+
+// Replace each '?' in sql with the next parameter as a SQL literal.
+// Values are written after the scan position, so a '?' inside a value is never re-bound.
+std::string WorkoutDAO::bindParams(Link& link, const std::string& sql, const std::vector<SqlParam>& params) {
+    std::string bound;
+    bound.reserve(sql.size() + params.size() * 16);
+    size_t next = 0;
+    
+    for (char c : sql) {
+        if (c != '?' || next >= params.size()) {
+            bound += c;
+            continue;
+        }
+        
+        const SqlParam& param = params[next++];
+        switch (param.kind) {
+            case SqlParam::Kind::INT:
+                bound += std::to_string(param.intValue);
+                break;
+            case SqlParam::Kind::DOUBLE: {
+                // Shortest round-trip form, independent of the C locale. The
+                // exponent makes MySQL read it as a DOUBLE, not a DECIMAL.
+                char digits[32];
+                auto result = std::to_chars(digits, digits + sizeof(digits), param.doubleValue,
+                                            std::chars_format::scientific);
+                bound.append(digits, result.ptr);
+                break;
+            }
+            case SqlParam::Kind::TEXT:
+                bound += "'" + escapeString(link, param.textValue) + "'";
+                break;
+        }
+    }
     
-    std::string query = "SELECT * FROM Equipment ORDER BY name";
+    return bound;
+}
+
+// Read Workouts matching a filter
+ResultSet<Workout> WorkoutDAO::readWorkoutsWhere(const WorkoutFilter& filter) {
+    if (!filter.isValid()) {
+        std::cerr << "Read Workouts Where Error: " << filter.getError() << std::endl;
+        return ResultSet<Workout>();
+    }
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Workout>();
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read All Equipment");
-        return equipmentList;
+    std::string query = bindParams(*link, selectFrom<Workout>() +
+                                   filter.toSql("workout_date DESC, workout_time DESC"),
+                                   filter.getParams());
+    return readList<Workout>(link, query, "Read Workouts Where");
+}
+
+// Read MuscleGroups matching a filter
+ResultSet<MuscleGroup> WorkoutDAO::readMuscleGroupsWhere(const MuscleGroupFilter& filter) {
+    if (!filter.isValid()) {
+        std::cerr << "Read MuscleGroups Where Error: " << filter.getError() << std::endl;
+        return ResultSet<MuscleGroup>();
     }
+    Link* link = connectForRead();
+    if (!link) return ResultSet<MuscleGroup>();
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return equipmentList;
+    std::string query = bindParams(*link, selectFrom<MuscleGroup>() + filter.toSql("name"),
+                                   filter.getParams());
+    return readList<MuscleGroup>(link, query, "Read MuscleGroups Where");
+}
+
+// Read Nutrition entries matching a filter
+ResultSet<Nutrition> WorkoutDAO::readNutritionWhere(const NutritionFilter& filter) {
+    if (!filter.isValid()) {
+        std::cerr << "Read Nutrition Where Error: " << filter.getError() << std::endl;
+        return ResultSet<Nutrition>();
+    }
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Nutrition>();
     
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Equipment* equipment = new Equipment();
-        equipment->setEquipmentId(std::stoi(row[0]));
-        equipment->setName(row[1]);
-        equipment->setDescription(row[2] ? row[2] : "");
-        equipment->setCategory(row[3] ? row[3] : "");
-        equipment->setTarget(row[4] ? row[4] : "");
-        equipmentList.push_back(equipment);
+    std::string query = bindParams(*link, selectFrom<Nutrition>() + filter.toSql("meal_date DESC"),
+                                   filter.getParams());
+    return readList<Nutrition>(link, query, "Read Nutrition Where");
+}
+
+// Read Recovery entries matching a filter
+ResultSet<Recovery> WorkoutDAO::readRecoveryWhere(const RecoveryFilter& filter) {
+    if (!filter.isValid()) {
+        std::cerr << "Read Recovery Where Error: " << filter.getError() << std::endl;
+        return ResultSet<Recovery>();
     }
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Recovery>();
     
-    mysql_free_result(result);
-    return equipmentList;
+    std::string query = bindParams(*link, selectFrom<Recovery>() + filter.toSql("recovery_date DESC"),
+                                   filter.getParams());
+    return readList<Recovery>(link, query, "Read Recovery Where");
 }
 
-// Read Equipment by category
-std::vector<Equipment*> WorkoutDAO::readEquipmentByCategory(const std::string& category) {
-    std::vector<Equipment*> equipmentList;
-    if (!connect()) return equipmentList;
+// Read Equipment matching a filter
+ResultSet<Equipment> WorkoutDAO::readEquipmentWhere(const EquipmentFilter& filter) {
+    if (!filter.isValid()) {
+        std::cerr << "Read Equipment Where Error: " << filter.getError() << std::endl;
+        return ResultSet<Equipment>();
+    }
+    Link* link = connectForRead();
+    if (!link) return ResultSet<Equipment>();
     
-    std::string query = "SELECT * FROM Equipment WHERE category = '" + category + "'";
+    std::string query = bindParams(*link, selectFrom<Equipment>() + filter.toSql("name"),
+                                   filter.getParams());
+    return readList<Equipment>(link, query, "Read Equipment Where");
+}
+
+// ==================== TRAINING DAY ====================
+
+// "12,13,14" -> {12, 13, 14}
+static std::vector<int> parseIdList(const std::string& ids) {
+    std::vector<int> list;
+    size_t start = 0;
+    while (start < ids.size()) {
+        size_t end = ids.find(',', start);
+        if (end == std::string::npos) end = ids.size();
+        list.push_back(parseIntField(ids.substr(start, end - start).c_str()));
+        start = end + 1;
+    }
+    return list;
+}
+
+// Quote and escape a text value, or NULL when empty
+std::string WorkoutDAO::sqlText(Link& link, const std::string& value) {
+    if (value.empty()) return "NULL";
+    return "'" + escapeString(link, value) + "'";
+}
+
+// Load the ids and request fingerprint stored for a client key by an earlier logDay
+bool WorkoutDAO::readDayLog(Link*& link, const std::string& clientKey, DayLogResult& result,
+                            std::string& fingerprint) {
+    std::string query = "SELECT workout_id, nutrition_ids, recovery_id, fingerprint FROM DayLog "
+                        "WHERE client_key = " + sqlText(*link, clientKey);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Equipment by Category");
-        return equipmentList;
+    if (!runQuery(link, query, "Read Day Log", true)) {
+        return false;
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return equipmentList;
+    MYSQL_RES* rows = mysql_store_result(link->handle);
+    if (!rows) return false;
     
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        Equipment* equipment = new Equipment();
-        equipment->setEquipmentId(std::stoi(row[0]));
-        equipment->setName(row[1]);
-        equipment->setDescription(row[2] ? row[2] : "");
-        equipment->setCategory(row[3] ? row[3] : "");
-        equipment->setTarget(row[4] ? row[4] : "");
-        equipmentList.push_back(equipment);
+    MYSQL_ROW row = mysql_fetch_row(rows);
+    bool found = false;
+    
+    if (row) {
+        result.workoutId = parseIntField(row[0]);
+        result.recoveryId = parseIntField(row[2]);
+        result.nutritionIds = parseIdList(textField(row[1]));
+        fingerprint = textField(row[3]);
+        found = true;
     }
     
-    mysql_free_result(result);
-    return equipmentList;
+    mysql_free_result(rows);
+    return found;
 }
 
-// Read Equipment by name
-Equipment* WorkoutDAO::readEquipmentByName(const std::string& name) {
-    if (!connect()) return nullptr;
+// Log a training day atomically
+bool WorkoutDAO::logDay(const std::string& clientKey, const std::string& fingerprint, const Workout* workout,
+                        const std::vector<Nutrition>& meals, const Recovery* recovery,
+                        DayLogResult& result) {
+    Link* link = connect();
+    if (!link) return false;
+    
+    // Build the whole transaction as one batch. Each new id is captured in a
+    // session variable so the DayLog row and the final SELECT can report it
+    // without extra round trips.
+    std::string batch = "START TRANSACTION;"
+                        "SET @day_workout = NULL, @day_meals = '', @day_recovery = NULL;";
+    
+    if (!clientKey.empty()) {
+        batch += "INSERT INTO DayLog (client_key, fingerprint) VALUES (" + sqlText(*link, clientKey) + ", " +
+                 sqlText(*link, fingerprint) + ");";
+    }
     
-    std::string query = "SELECT * FROM Equipment WHERE name = '" + name + "'";
+    if (workout) {
+        batch += "INSERT INTO Workout (workout_date, workout_time, duration, type_description, "
+                 "calories_burned, rate_perceived_exhaustion, muscle_group_id) VALUES ("
+                 + sqlText(*link, workout->getWorkoutDate()) + ", "
+                 + sqlText(*link, workout->getWorkoutTime()) + ", "
+                 + std::to_string(workout->getDuration()) + ", "
+                 + sqlText(*link, workout->getTypeDescription()) + ", "
+                 + std::to_string(workout->getCaloriesBurned()) + ", "
+                 + std::to_string(workout->getRatePerceivedExhaustion()) + ", "
+                 + (workout->getMuscleGroupId() > 0 ? std::to_string(workout->getMuscleGroupId()) : "NULL")
+                 + ");SET @day_workout = LAST_INSERT_ID();";
+    }
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Read Equipment by Name");
-        return nullptr;
+    for (const Nutrition& meal : meals) {
+        batch += "INSERT INTO Nutrition (family, water, carbs, fat, protein, sugar, meal_date) VALUES ("
+                 + sqlText(*link, meal.getFamilyString()) + ", "
+                 + std::to_string(meal.getWater()) + ", "
+                 + std::to_string(meal.getCarbs()) + ", "
+                 + std::to_string(meal.getFat()) + ", "
+                 + std::to_string(meal.getProtein()) + ", "
+                 + std::to_string(meal.getSugar()) + ", "
+                 + sqlText(*link, meal.getMealDate())
+                 + ");SET @day_meals = CONCAT_WS(',', NULLIF(@day_meals, ''), LAST_INSERT_ID());";
     }
     
-    MYSQL_RES* result = mysql_store_result(connection);
-    if (!result) return nullptr;
+    if (recovery) {
+        batch += "INSERT INTO Recovery (recovery_date, duration, type, helpers) VALUES ("
+                 + sqlText(*link, recovery->getRecoveryDate()) + ", "
+                 + std::to_string(recovery->getDuration()) + ", "
+                 + sqlText(*link, recovery->getType()) + ", "
+                 + sqlText(*link, recovery->getHelpers())
+                 + ");SET @day_recovery = LAST_INSERT_ID();";
+    }
     
-    MYSQL_ROW row = mysql_fetch_row(result);
-    Equipment* equipment = nullptr;
+    if (!clientKey.empty()) {
+        batch += "UPDATE DayLog SET workout_id = @day_workout, nutrition_ids = @day_meals, "
+                 "recovery_id = @day_recovery WHERE client_key = " + sqlText(*link, clientKey) + ";";
+    }
     
-    if (row) {
-        equipment = new Equipment();
-        equipment->setEquipmentId(std::stoi(row[0]));
-        equipment->setName(row[1]);
-        equipment->setDescription(row[2] ? row[2] : "");
-        equipment->setCategory(row[3] ? row[3] : "");
-        equipment->setTarget(row[4] ? row[4] : "");
+    batch += "COMMIT;SELECT @day_workout, @day_meals, @day_recovery";
+    
+    // Multi-statement mode is only enabled for this batch. Switching it on is
+    // a round trip of its own, so it also tells us whether the connection is
+    // still alive before any part of the transaction is sent.
+    if (mysql_set_server_option(link->handle, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0) {
+        if (!isConnectionLost(mysql_errno(link->handle))) {
+            handleError(*link, "Log Day");
+            return false;
+        }
+        link->connected = false;
+        ++retryCount;
+        link = connect();
+        if (!link) return false;
+        if (mysql_set_server_option(link->handle, MYSQL_OPTION_MULTI_STATEMENTS_ON) != 0) {
+            handleError(*link, "Log Day");
+            return false;
+        }
     }
     
-    mysql_free_result(result);
-    return equipment;
+    bool failed = !sendQuery(*link, batch);
+    unsigned int errorCode = failed ? mysql_errno(link->handle) : 0;
+    std::string ids;
+    bool haveIds = false;
+    
+    // Drain every result; execution stops at the first failing statement
+    if (!failed) {
+        int status;
+        do {
+            MYSQL_RES* rows = mysql_store_result(link->handle);
+            if (rows) {
+                MYSQL_ROW row = mysql_fetch_row(rows);
+                if (row) {
+                    result.workoutId = parseIntField(row[0]);
+                    ids = textField(row[1]);
+                    result.recoveryId = parseIntField(row[2]);
+                    haveIds = true;
+                }
+                mysql_free_result(rows);
+            }
+            status = mysql_next_result(link->handle);
+            if (status > 0) {
+                failed = true;
+                errorCode = mysql_errno(link->handle);
+                if (isConnectionLost(errorCode)) link->connected = false;
+            }
+        } while (status == 0);
+    }
+    
+    if (failed) {
+        handleError(*link, "Log Day");
+    }
+    
+    // Lost mid-batch: the server rolls back the unfinished transaction
+    // when the session ends, so there is nothing left to undo here
+    if (!link->connected) {
+        return false;
+    }
+    
+    mysql_set_server_option(link->handle, MYSQL_OPTION_MULTI_STATEMENTS_OFF);
+    
+    if (failed || !haveIds) {
+        sendQuery(*link, "ROLLBACK");
+        
+        // Same key already committed: hand back what that request created,
+        // unless it was a different request (rows logged before fingerprints
+        // were stored have none and are taken as a match)
+        std::string saved;
+        if (errorCode == ER_DUP_ENTRY && !clientKey.empty() && readDayLog(link, clientKey, result, saved)) {
+            if (!saved.empty() && saved != fingerprint) {
+                result = DayLogResult();
+                result.mismatch = true;
+                std::cerr << "Log Day Error: key " << clientKey << " was used for a different request" << std::endl;
+                return false;
+            }
+            result.replayed = true;
+            std::cout << "Day already logged for key " << clientKey << ", replaying" << std::endl;
+            return true;
+        }
+        return false;
+    }
+    
+    result.replayed = false;
+    result.nutritionIds = parseIdList(ids);
+    notePrimaryWrite();
+    
+    std::cout << "Day logged successfully (" << meals.size() << " meals)" << std::endl;
+    return true;
 }
 
-// Update Equipment
-bool WorkoutDAO::updateEquipment(const Equipment& equipment) {
-    if (!connect()) return false;
+// ==================== IDEMPOTENCY KEYS ====================
+
+// Load the response saved for a key
+bool WorkoutDAO::readIdempotencyRecord(const std::string& key, IdempotencyRecord& record) {
+    Link* link = connect();
+    if (!link) return false;
     
-    std::string query = "UPDATE Equipment SET "
-                       "name = '" + equipment.getName() + "', "
-                       "description = '" + equipment.getDescription() + "', "
-                       "category = '" + equipment.getCategory() + "', "
-                       "target = '" + equipment.getTarget() + "' "
-                       "WHERE equipment_id = " + std::to_string(equipment.getEquipmentId());
+    std::string query = "SELECT fingerprint, status, content_type, body, UNIX_TIMESTAMP(created_at) "
+                        "FROM IdempotencyKey WHERE idem_key = " + sqlText(*link, key);
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Update Equipment");
+    if (!runQuery(link, query, "Read Idempotency Record", true)) {
         return false;
     }
     
-    std::cout << "Equipment updated successfully!" << std::endl;
+    MYSQL_RES* result = mysql_store_result(link->handle);
+    if (!result) return false;
+    
+    MYSQL_ROW row = mysql_fetch_row(result);
+    bool found = false;
+    
+    if (row) {
+        // The body may contain NUL bytes, so copy it by length
+        unsigned long* lengths = mysql_fetch_lengths(result);
+        record.fingerprint = textField(row[0]);
+        record.status = parseIntField(row[1]);
+        record.contentType = textField(row[2]);
+        record.body = row[3] ? std::string(row[3], lengths[3]) : "";
+        record.createdAt = row[4] ? std::atoll(row[4]) : 0;
+        found = true;
+    }
+    
+    mysql_free_result(result);
+    return found;
+}
+
+// Save (or replace an expired) response for a key
+bool WorkoutDAO::saveIdempotencyRecord(const std::string& key, const IdempotencyRecord& record) {
+    Link* link = connect();
+    if (!link) return false;
+    
+    std::string values = sqlText(*link, record.fingerprint) + ", " + std::to_string(record.status) + ", " +
+                         sqlText(*link, record.contentType) + ", " + sqlText(*link, record.body) + ", " +
+                         "FROM_UNIXTIME(" + std::to_string(record.createdAt) + ")";
+    std::string query = "INSERT INTO IdempotencyKey (idem_key, fingerprint, status, content_type, body, created_at) "
+                        "VALUES (" + sqlText(*link, key) + ", " + values + ") "
+                        "ON DUPLICATE KEY UPDATE fingerprint = VALUES(fingerprint), status = VALUES(status), "
+                        "content_type = VALUES(content_type), body = VALUES(body), created_at = VALUES(created_at)";
+    
+    if (!runQuery(link, query, "Save Idempotency Record", false)) {
+        return false;
+    }
     return true;
 }
 
-// Delete Equipment
-bool WorkoutDAO::deleteEquipment(int equipmentId) {
-    if (!connect()) return false;
+// Delete records created before olderThan (epoch seconds); returns rows removed
+int WorkoutDAO::purgeIdempotencyRecords(long long olderThan) {
+    Link* link = connect();
+    if (!link) return 0;
     
-    std::string query = "DELETE FROM Equipment WHERE equipment_id = " + std::to_string(equipmentId);
+    std::string query = "DELETE FROM IdempotencyKey WHERE created_at < FROM_UNIXTIME(" +
+                        std::to_string(olderThan) + ")";
     
-    if (mysql_query(connection, query.c_str())) {
-        handleError("Delete Equipment");
+    if (!runQuery(link, query, "Purge Idempotency Records", false)) {
+        return 0;
+    }
+    return static_cast<int>(mysql_affected_rows(link->handle));
+}
+
+// ==================== BATCH INSERT ====================
+
+// Spacing between the ids one statement generates on link's session: 1
+// unless the server is set up for multi-primary replication. Read once per
+// connection; 0 if it cannot be read.
+int WorkoutDAO::autoIncrementStep(Link& link) {
+    if (link.idStep > 0) return link.idStep;
+    
+    Link* target = &link;
+    if (!runQuery(target, "SELECT @@auto_increment_increment", "Read Auto Increment Step", true)) {
+        return 0;
+    }
+    MYSQL_RES* result = mysql_store_result(target->handle);
+    if (!result) return 0;
+    
+    MYSQL_ROW row = mysql_fetch_row(result);
+    if (row) target->idStep = parseIntField(row[0]);
+    mysql_free_result(result);
+    return target->idStep;
+}
+
+// Insert many workouts with one multi-row INSERT: a single statement, so it
+// commits (or fails) as a unit in one round trip. A multi-row INSERT ... VALUES
+// is a "simple insert" to InnoDB: it reserves all its ids at once, so they are
+// LAST_INSERT_ID(), then one auto_increment_increment apart, under every
+// innodb_autoinc_lock_mode (0, 1 and the MySQL 8 default 2). An INSERT ...
+// SELECT or ON DUPLICATE KEY UPDATE would not have that guarantee.
+bool WorkoutDAO::createWorkouts(std::vector<Workout>& workouts) {
+    if (workouts.empty()) return true;
+    Link* link = connect();
+    if (!link) return false;
+    
+    // Read before the INSERT: a reconnect after it would lose LAST_INSERT_ID()
+    int step = autoIncrementStep(*link);
+    if (step <= 0) return false;
+    
+    std::string query = "INSERT INTO Workout (workout_date, workout_time, duration, type_description, "
+                        "calories_burned, rate_perceived_exhaustion, muscle_group_id) VALUES ";
+    
+    for (size_t i = 0; i < workouts.size(); ++i) {
+        const Workout& workout = workouts[i];
+        if (i > 0) query += ", ";
+        query += "(" + sqlText(*link, workout.getWorkoutDate()) + ", "
+                 + sqlText(*link, workout.getWorkoutTime()) + ", "
+                 + std::to_string(workout.getDuration()) + ", "
+                 + sqlText(*link, workout.getTypeDescription()) + ", "
+                 + std::to_string(workout.getCaloriesBurned()) + ", "
+                 + std::to_string(workout.getRatePerceivedExhaustion()) + ", "
+                 + (workout.getMuscleGroupId() > 0 ? std::to_string(workout.getMuscleGroupId()) : "NULL")
+                 + ")";
+    }
+    
+    if (!runQuery(link, query, "Create Workouts", false)) {
         return false;
     }
     
-    std::cout << "Equipment deleted successfully!" << std::endl;
+    int firstId = lastInsertId(*link);
+    for (size_t i = 0; i < workouts.size(); ++i) {
+        workouts[i].setWorkoutId(firstId + static_cast<int>(i) * step);
+    }
+    
+    std::cout << workouts.size() << " workouts created, IDs " << firstId << "-"
+              << workouts.back().getWorkoutId() << std::endl;
     return true;
 }
@@ -11,77 +11,261 @@
 #include "Nutrition.h"
 #include "Recovery.h"
 #include "Equipment.h"
+#include "QueryFilter.h"
+#include "ResultSet.h"
+#include "ConnectionPolicy.h"
 #include <mysql/mysql.h>
 #include <vector>
 #include <string>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Ids produced by WorkoutDAO::logDay (0 / empty for parts not logged)
+struct DayLogResult {
+    bool replayed = false;  // client key was seen before; ids are from that request
+    bool mismatch = false;  // client key was used for a different request; nothing was logged
+    int workoutId = 0;
+    std::vector<int> nutritionIds;
+    int recoveryId = 0;
+};
+
+// Stored response for an Idempotency-Key (see ServiceLayer/IdempotencyStore.h)
+struct IdempotencyRecord {
+    std::string fingerprint;  // hash of method, path and body of the first request
+    int status = 0;
+    std::string contentType;
+    std::string body;
+    long long createdAt = 0;  // epoch seconds
+};
+
+// Round trips made by a WorkoutDAO, for measuring connection overhead
+struct ConnectionStats {
+    unsigned long long queries = 0;   // statements sent
+    unsigned long long pings = 0;     // liveness checks after an idle period
+    unsigned long long connects = 0;  // connection attempts
+    unsigned long long retries = 0;   // statements re-sent after a lost connection
+    unsigned long long replicaReads = 0;  // reads served by a replica
+};
 
 class WorkoutDAO {
 private:
-    MYSQL* connection;
-    std::string host;
+    // One MySQL server: the primary, or a read replica with the same schema
+    struct Server {
+        std::string host;
+        int port = 3306;
+        std::atomic<long long> downUntilMs{0};  // replicas: skipped after a failure (steady clock)
+    };
+    
+    // One thread's connection to a server. A MYSQL handle must never be used
+    // by two threads at once, so each thread gets its own link to every
+    // server, and the link a statement runs on is passed to each helper.
+    struct Link {
+        Server* server = nullptr;
+        MYSQL* handle = nullptr;
+        bool connected = false;
+        int idStep = 0;  // @@auto_increment_increment of the session, once read
+        std::chrono::steady_clock::time_point lastActivity;  // last answer from the server
+    };
+    
+    struct ThreadLinks {
+        Link primary;
+        std::vector<Link> replicas;
+    };
+    
     std::string user;
     std::string password;
     std::string database;
-    int port;
     
-    // Helper methods
-    bool connect();
+    // Writes and transactions go to the primary; reads may go to a replica
+    Server primary;
+    std::deque<Server> replicas;
+    
+    // Every thread reads from the primary until this time (epoch ms), pushed
+    // policy.stickyMs ahead by each write made through this DAO. The caches
+    // above the DAO move to a new table version at once, so a body read from
+    // a lagging replica would be tagged and cached as the new version.
+    std::atomic<long long> allReadsPrimaryUntil{0};
+    
+    // Links of every thread that has used this DAO, closed by the destructor.
+    // serial tells DAOs apart in each thread's lookup cache.
+    std::mutex linksMutex;
+    std::map<std::thread::id, std::unique_ptr<ThreadLinks>> threadLinkSets;
+    unsigned long long serial;
+    
+    // Timeouts, read retries and fail-fast behaviour (ConnectionPolicy.h).
+    // The circuit breaker guards the primary; a failed replica is skipped
+    // for the same cooldown instead.
+    ConnectionPolicy policy;
+    CircuitBreaker breaker;
+    
+    // Round trip counters
+    std::atomic<unsigned long long> queryCount{0};
+    std::atomic<unsigned long long> pingCount{0};
+    std::atomic<unsigned long long> connectCount{0};
+    std::atomic<unsigned long long> retryCount{0};
+    std::atomic<unsigned long long> replicaReadCount{0};
+    
+    // Helper methods. connect() and connectForRead() return the calling
+    // thread's link to the chosen server, or nullptr when it cannot be reached.
+    ThreadLinks& threadLinks();
+    Link* connect();          // primary
+    Link* connectForRead();   // a healthy replica, else the primary
+    bool openLink(Link& target);
+    void closeLink(Link& target);
     void disconnect();
-    void handleError(const std::string& operation);
+    bool isPrimary(const Link& target) const { return target.server == &primary; }
+    void notePrimaryWrite();
+    void handleError(Link& link, const std::string& operation);
+    static int lastInsertId(Link& link);
+    int autoIncrementStep(Link& link);
+    
+    // Run one statement. Idempotent statements are retried with backoff when
+    // the connection drops; others report the failure to the caller. A read
+    // retried on another server updates link.
+    bool sendQuery(Link& link, const std::string& query);
+    bool runQuery(Link*& link, const std::string& query, const std::string& operation, bool idempotent);
+    static bool isConnectionLost(unsigned int errorCode);
+    
+    // Filter support: escape text and substitute '?' placeholders
+    std::string escapeString(Link& link, const std::string& value);
+    std::string bindParams(Link& link, const std::string& sql, const std::vector<SqlParam>& params);
+    
+    // Training day support
+    std::string sqlText(Link& link, const std::string& value);
+    bool readDayLog(Link*& link, const std::string& clientKey, DayLogResult& result, std::string& fingerprint);
+    
+    // Reads through RowMapping<T>: explicit column list, typed decoding
+    template<typename T>
+    ResultSet<T> readList(Link* link, const std::string& query, const std::string& operation);
+    template<typename T>
+    T* readOne(Link* link, const std::string& query, const std::string& operation);
+
+protected:
+    // For backends that do not use MySQL (see LocalStoreDAO.h); they override
+    // every data method below, so no connection is ever opened
+    WorkoutDAO();
+    
+    // Record whether the calling thread's write failed on a unique name
+    static void setDuplicateWrite(bool duplicate);
+    
+    // Count a failed connection or statement on the calling thread
+    static void noteFailure();
 
 public:
     // Constructor and Destructor
     WorkoutDAO(const std::string& host, const std::string& user,
                const std::string& password, const std::string& database, int port = 3306);
-    ~WorkoutDAO();
+    virtual ~WorkoutDAO();
     
     // Workout CRUD operations
-    bool createWorkout(const Workout& workout);
-    Workout* readWorkout(int workoutId);
-    std::vector<Workout*> readAllWorkouts();
-    std::vector<Workout*> readWorkoutsByDate(const std::string& date);
-    std::vector<Workout*> readWorkoutsByMuscleGroup(int muscleGroupId);
-    bool updateWorkout(const Workout& workout);
-    bool deleteWorkout(int workoutId);
+    virtual bool createWorkout(const Workout& workout);
+    virtual Workout* readWorkout(int workoutId);
+    virtual ResultSet<Workout> readWorkoutsByIds(const std::vector<int>& workoutIds);  // in ids order, one query
+    virtual ResultSet<Workout> readAllWorkouts();
+    virtual ResultSet<Workout> readWorkoutsByDate(const std::string& date);
+    virtual ResultSet<Workout> readWorkoutsByMuscleGroup(int muscleGroupId);
+    virtual ResultSet<Workout> readWorkoutsWhere(const WorkoutFilter& filter);
+    virtual bool updateWorkout(const Workout& workout);
+    virtual bool deleteWorkout(int workoutId);
     
     // MuscleGroup CRUD operations
-    bool createMuscleGroup(const MuscleGroup& muscleGroup);
-    MuscleGroup* readMuscleGroup(int muscleGroupId);
-    std::vector<MuscleGroup*> readAllMuscleGroups();
-    MuscleGroup* readMuscleGroupByName(const std::string& name);
-    bool updateMuscleGroup(const MuscleGroup& muscleGroup);
-    bool deleteMuscleGroup(int muscleGroupId);
+    virtual bool createMuscleGroup(const MuscleGroup& muscleGroup);
+    virtual MuscleGroup* readMuscleGroup(int muscleGroupId);
+    virtual ResultSet<MuscleGroup> readMuscleGroupsByIds(const std::vector<int>& muscleGroupIds);  // in ids order, one query
+    virtual ResultSet<MuscleGroup> readAllMuscleGroups();
+    virtual MuscleGroup* readMuscleGroupByName(const std::string& name);
+    virtual ResultSet<MuscleGroup> readMuscleGroupsWhere(const MuscleGroupFilter& filter);
+    virtual bool updateMuscleGroup(const MuscleGroup& muscleGroup);
+    virtual bool deleteMuscleGroup(int muscleGroupId);
     
     // Nutrition CRUD operations
-    bool createNutrition(const Nutrition& nutrition);
-    Nutrition* readNutrition(int nutritionId);
-    std::vector<Nutrition*> readAllNutrition();
-    std::vector<Nutrition*> readNutritionByDate(const std::string& date);
-    std::vector<Nutrition*> readNutritionByFamily(const std::string& family);
-    bool updateNutrition(const Nutrition& nutrition);
-    bool deleteNutrition(int nutritionId);
+    virtual bool createNutrition(const Nutrition& nutrition);
+    virtual Nutrition* readNutrition(int nutritionId);
+    virtual ResultSet<Nutrition> readAllNutrition();
+    virtual ResultSet<Nutrition> readNutritionByDate(const std::string& date);
+    virtual ResultSet<Nutrition> readNutritionByFamily(const std::string& family);
+    virtual ResultSet<Nutrition> readNutritionWhere(const NutritionFilter& filter);
+    virtual bool updateNutrition(const Nutrition& nutrition);
+    virtual bool deleteNutrition(int nutritionId);
     
     // Recovery CRUD operations
-    bool createRecovery(const Recovery& recovery);
-    Recovery* readRecovery(int recoveryId);
-    std::vector<Recovery*> readAllRecovery();
-    std::vector<Recovery*> readRecoveryByDate(const std::string& date);
-    std::vector<Recovery*> readRecoveryByType(const std::string& type);
-    bool updateRecovery(const Recovery& recovery);
-    bool deleteRecovery(int recoveryId);
+    virtual bool createRecovery(const Recovery& recovery);
+    virtual Recovery* readRecovery(int recoveryId);
+    virtual ResultSet<Recovery> readAllRecovery();
+    virtual ResultSet<Recovery> readRecoveryByDate(const std::string& date);
+    virtual ResultSet<Recovery> readRecoveryByType(const std::string& type);
+    virtual ResultSet<Recovery> readRecoveryWhere(const RecoveryFilter& filter);
+    virtual bool updateRecovery(const Recovery& recovery);
+    virtual bool deleteRecovery(int recoveryId);
     
     // Equipment CRUD operations
-    bool createEquipment(const Equipment& equipment);
-    Equipment* readEquipment(int equipmentId);
-    std::vector<Equipment*> readAllEquipment();
-    std::vector<Equipment*> readEquipmentByCategory(const std::string& category);
-    Equipment* readEquipmentByName(const std::string& name);
-    bool updateEquipment(const Equipment& equipment);
-    bool deleteEquipment(int equipmentId);
+    virtual bool createEquipment(const Equipment& equipment);
+    virtual Equipment* readEquipment(int equipmentId);
+    virtual ResultSet<Equipment> readAllEquipment();
+    virtual ResultSet<Equipment> readEquipmentByCategory(const std::string& category);
+    virtual Equipment* readEquipmentByName(const std::string& name);
+    virtual ResultSet<Equipment> readEquipmentWhere(const EquipmentFilter& filter);
+    virtual bool updateEquipment(const Equipment& equipment);
+    virtual bool deleteEquipment(int equipmentId);
+    
+    // Training day: insert a workout, meals and a recovery session in one
+    // transaction sent as a single multi-statement round trip. workout and
+    // recovery may be nullptr. A non-empty clientKey makes the call idempotent:
+    // repeating it returns the first call's ids with replayed set. fingerprint
+    // identifies the request and is stored with the key; a repeat with another
+    // fingerprint returns false with mismatch set.
+    virtual bool logDay(const std::string& clientKey, const std::string& fingerprint, const Workout* workout,
+                        const std::vector<Nutrition>& meals, const Recovery* recovery,
+                        DayLogResult& result);
+    
+    // Batch insert: all workouts in one statement; ids are written back
+    virtual bool createWorkouts(std::vector<Workout>& workouts);
+    
+    // Idempotency keys: saved responses of POST requests, replayed on retry
+    virtual bool readIdempotencyRecord(const std::string& key, IdempotencyRecord& record);
+    virtual bool saveIdempotencyRecord(const std::string& key, const IdempotencyRecord& record);
+    virtual int purgeIdempotencyRecords(long long olderThan);
     
     // Utility methods
-    bool testConnection();
-    int getLastInsertId();
+    virtual bool testConnection();
+    virtual int getLastInsertId();   // of the calling thread's last insert
+    
+    // True when the calling thread's last write failed because the name is
+    // already taken (the unique MuscleGroup and Equipment name indexes)
+    bool lastWriteWasDuplicate() const;
+    
+    // Connections and statements that have failed on the calling thread.
+    // A failed read returns an empty list, so a caller that must tell "no
+    // rows" from an error compares this before and after its reads.
+    static unsigned long long getFailureCount();
+    
+    // Connection policy (defaults come from the WORKOUT_DB_* environment)
+    void setConnectionPolicy(const ConnectionPolicy& settings);
+    const ConnectionPolicy& getConnectionPolicy() const { return policy; }
+    const CircuitBreaker& getCircuitBreaker() const { return breaker; }
+    ConnectionStats getConnectionStats() const;
+    
+    // Read replicas (also taken from WORKOUT_DB_REPLICAS). Reads go to the
+    // first healthy replica, except for a while after any write made through
+    // this DAO, and on a thread whose client wrote recently.
+    void addReadReplica(const std::string& host, int port = 3306);
+    size_t getReplicaCount() const { return replicas.size(); }
+    
+    // Read-your-writes: until this time (epoch ms) reads made on the calling
+    // thread go to the primary. Every write pushes it policy.stickyMs ahead;
+    // a server can also carry it between a client's requests (e.g. a cookie).
+    static long long getPrimaryReadsUntil();
+    static void setPrimaryReadsUntil(long long epochMs);
+    
+    // Change counter of a table, bumped by every insert, update and delete
+    // (the TableVersion triggers). Lets callers notice writes made by other
+    // processes without reading rows.
+    virtual bool readTableVersion(const std::string& table, long long& version);
 };
 
 #endif // WORKOUTDAO_H
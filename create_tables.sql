@@ -66,9 +66,99 @@ CREATE TABLE Equipment (
     updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP
 );
 
+-- Create DayLog table: one row per client key passed to WorkoutDAO::logDay,
+-- written in the same transaction as the day's rows so retries can be replayed
+CREATE TABLE DayLog (
+    client_key VARCHAR(64) PRIMARY KEY,
+    fingerprint VARCHAR(32) COMMENT 'Hash of method, path and body',
+    workout_id INT,
+    nutrition_ids VARCHAR(1024) COMMENT 'Comma-separated Nutrition ids',
+    recovery_id INT,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
+-- Create IdempotencyKey table: responses saved for POST requests that carried
+-- an Idempotency-Key header, replayed when the client retries
+CREATE TABLE IdempotencyKey (
+    idem_key VARCHAR(255) PRIMARY KEY COMMENT 'Client, a space, then the Idempotency-Key',
+    fingerprint VARCHAR(32) NOT NULL COMMENT 'Hash of method, path and body',
+    status INT NOT NULL,
+    content_type VARCHAR(100),
+    body MEDIUMTEXT,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    INDEX idx_idempotency_created (created_at)
+);
+
+-- Create TableVersion table: a change counter per table, bumped by the
+-- triggers below, so REST ETags notice writes from other processes
+-- (see migrations/004_table_versions.sql)
+CREATE TABLE TableVersion (
+    table_name VARCHAR(32) PRIMARY KEY,
+    version BIGINT UNSIGNED NOT NULL DEFAULT 0
+);
+
+INSERT INTO TableVersion (table_name) VALUES
+    ('Workout'), ('MuscleGroup'), ('Nutrition'), ('Recovery'), ('Equipment');
+
+CREATE TRIGGER trg_workout_insert AFTER INSERT ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+CREATE TRIGGER trg_workout_update AFTER UPDATE ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+CREATE TRIGGER trg_workout_delete AFTER DELETE ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+
+-- Deleting a muscle group sets Workout.muscle_group_id to NULL through the
+-- foreign key, which does not fire Workout's triggers, so bump both here
+CREATE TRIGGER trg_musclegroup_insert AFTER INSERT ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'MuscleGroup';
+CREATE TRIGGER trg_musclegroup_update AFTER UPDATE ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'MuscleGroup';
+CREATE TRIGGER trg_musclegroup_delete AFTER DELETE ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name IN ('MuscleGroup', 'Workout');
+
+CREATE TRIGGER trg_nutrition_insert AFTER INSERT ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+CREATE TRIGGER trg_nutrition_update AFTER UPDATE ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+CREATE TRIGGER trg_nutrition_delete AFTER DELETE ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+
+CREATE TRIGGER trg_recovery_insert AFTER INSERT ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+CREATE TRIGGER trg_recovery_update AFTER UPDATE ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+CREATE TRIGGER trg_recovery_delete AFTER DELETE ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+
+CREATE TRIGGER trg_equipment_insert AFTER INSERT ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+CREATE TRIGGER trg_equipment_update AFTER UPDATE ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+CREATE TRIGGER trg_equipment_delete AFTER DELETE ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+
 -- Create indexes for better performance
-CREATE INDEX idx_workout_date ON Workout(workout_date);
-CREATE INDEX idx_workout_muscle_group ON Workout(muscle_group_id);
+-- Each index matches a statement in WorkoutDAO.cpp; see migrations/001_query_indexes.sql
+-- for the reasoning (including why none is covering) and
+-- migrations/check_query_plans.sh for the EXPLAIN check.
+
+-- Workout: readAllWorkouts orders by (date, time); readWorkoutsByDate and date
+-- range filters use the same prefix
+CREATE INDEX idx_workout_date_time ON Workout(workout_date, workout_time);
+CREATE INDEX idx_workout_muscle_group_date ON Workout(muscle_group_id, workout_date);
+CREATE INDEX idx_workout_rpe_date ON Workout(rate_perceived_exhaustion, workout_date);
+
+-- MuscleGroup: looked up by name, listed by name; names identify a group
+CREATE UNIQUE INDEX uk_musclegroup_name ON MuscleGroup(name);
+
+-- Nutrition: by date, by family (newest first)
 CREATE INDEX idx_nutrition_date ON Nutrition(meal_date);
+CREATE INDEX idx_nutrition_family_date ON Nutrition(family, meal_date);
+
+-- Recovery: by date, by type (newest first)
 CREATE INDEX idx_recovery_date ON Recovery(recovery_date);
-CREATE INDEX idx_equipment_category ON Equipment(category);
+CREATE INDEX idx_recovery_type_date ON Recovery(type, recovery_date);
+
+-- Equipment: looked up by name, listed by name, filtered by category
+CREATE UNIQUE INDEX uk_equipment_name ON Equipment(name);
+CREATE INDEX idx_equipment_category_name ON Equipment(category, name);
@@ -4,6 +4,7 @@
 // Date: 2026-01-28
 
 #include "WorkoutDAO.h"
+#include "LocalStoreDAO.h"
 #include <iostream>
 #include <vector>
 
@@ -24,32 +25,28 @@ void demonstrateWorkoutOperations(WorkoutDAO& dao) {
     
     // Read all workouts
     std::cout << "\n[READ ALL] Retrieving all workouts..." << std::endl;
-    std::vector<Workout*> workouts = dao.readAllWorkouts();
+    ResultSet<Workout> workouts = dao.readAllWorkouts();
     std::cout << "Found " << workouts.size() << " workouts:" << std::endl;
     for (int i = 0; i < std::min(3, (int)workouts.size()); i++) {
-        std::cout << "  - " << workouts[i]->toString() << std::endl;
+        std::cout << "  - " << workouts[i].toString() << std::endl;
     }
     
     // Read workouts by date
     std::cout << "\n[READ BY DATE] Workouts on 2026-01-20:" << std::endl;
-    std::vector<Workout*> dateWorkouts = dao.readWorkoutsByDate("2026-01-20");
-    for (auto* w : dateWorkouts) {
-        w->displayInfo();
+    ResultSet<Workout> dateWorkouts = dao.readWorkoutsByDate("2026-01-20");
+    for (const auto& w : dateWorkouts) {
+        w.displayInfo();
         std::cout << std::endl;
     }
     
     // Update a workout
     if (!workouts.empty()) {
         std::cout << "\n[UPDATE] Updating first workout..." << std::endl;
-        Workout* toUpdate = workouts[0];
-        toUpdate->setCaloriesBurned(500.0);
-        toUpdate->setRatePerceivedExhaustion(9);
-        dao.updateWorkout(*toUpdate);
+        Workout& toUpdate = workouts[0];
+        toUpdate.setCaloriesBurned(500.0);
+        toUpdate.setRatePerceivedExhaustion(9);
+        dao.updateWorkout(toUpdate);
     }
-    
-    // Cleanup
-    for (auto* w : workouts) delete w;
-    for (auto* w : dateWorkouts) delete w;
 }
 
 void demonstrateMuscleGroupOperations(WorkoutDAO& dao) {
@@ -57,16 +54,26 @@ void demonstrateMuscleGroupOperations(WorkoutDAO& dao) {
     std::cout << "MUSCLE GROUP CRUD OPERATIONS DEMO" << std::endl;
     printSeparator();
     
-    // Create a new muscle group
-    MuscleGroup newGroup(0, "Abs", "Abdominal muscles", 3, 4, 25, 0.0);
-    std::cout << "\n[CREATE] Creating new muscle group..." << std::endl;
-    dao.createMuscleGroup(newGroup);
+    // Create a new muscle group. Names are unique, so skip it if an earlier
+    // run left one behind; the demo removes its own row again below.
+    int createdId = 0;
+    MuscleGroup* existing = dao.readMuscleGroupByName("Abs");
+    if (existing) {
+        std::cout << "\n[CREATE] Muscle group 'Abs' already exists, skipping" << std::endl;
+        delete existing;
+    } else {
+        MuscleGroup newGroup(0, "Abs", "Abdominal muscles", 3, 4, 25, 0.0);
+        std::cout << "\n[CREATE] Creating new muscle group..." << std::endl;
+        if (dao.createMuscleGroup(newGroup)) {
+            createdId = dao.getLastInsertId();
+        }
+    }
     
     // Read all muscle groups
     std::cout << "\n[READ ALL] All muscle groups:" << std::endl;
-    std::vector<MuscleGroup*> groups = dao.readAllMuscleGroups();
-    for (auto* mg : groups) {
-        std::cout << "  - " << mg->toString() << std::endl;
+    ResultSet<MuscleGroup> groups = dao.readAllMuscleGroups();
+    for (const auto& mg : groups) {
+        std::cout << "  - " << mg.toString() << std::endl;
     }
     
     // Read by name
@@ -77,8 +84,11 @@ void demonstrateMuscleGroupOperations(WorkoutDAO& dao) {
         delete chest;
     }
     
-    // Cleanup
-    for (auto* mg : groups) delete mg;
+    // Delete the demo muscle group
+    if (createdId > 0) {
+        std::cout << "\n[DELETE] Removing demo muscle group..." << std::endl;
+        dao.deleteMuscleGroup(createdId);
+    }
 }
 
 void demonstrateNutritionOperations(WorkoutDAO& dao) {
@@ -93,23 +103,19 @@ void demonstrateNutritionOperations(WorkoutDAO& dao) {
     
     // Read by date
     std::cout << "\n[READ BY DATE] Nutrition for 2026-01-20:" << std::endl;
-    std::vector<Nutrition*> nutrition = dao.readNutritionByDate("2026-01-20");
-    for (auto* n : nutrition) {
-        n->displayInfo();
-        std::cout << "Carb Ratio: " << n->getMacroRatio("carbs") << "%" << std::endl;
-        std::cout << "Protein Ratio: " << n->getMacroRatio("protein") << "%" << std::endl;
-        std::cout << "Fat Ratio: " << n->getMacroRatio("fat") << "%" << std::endl;
+    ResultSet<Nutrition> nutrition = dao.readNutritionByDate("2026-01-20");
+    for (const auto& n : nutrition) {
+        n.displayInfo();
+        std::cout << "Carb Ratio: " << n.getMacroRatio("carbs") << "%" << std::endl;
+        std::cout << "Protein Ratio: " << n.getMacroRatio("protein") << "%" << std::endl;
+        std::cout << "Fat Ratio: " << n.getMacroRatio("fat") << "%" << std::endl;
         std::cout << std::endl;
     }
     
     // Read by family
     std::cout << "\n[READ BY FAMILY] All 'Fruit' entries:" << std::endl;
-    std::vector<Nutrition*> fruits = dao.readNutritionByFamily("Fruit");
+    ResultSet<Nutrition> fruits = dao.readNutritionByFamily("Fruit");
     std::cout << "Found " << fruits.size() << " fruit entries." << std::endl;
-    
-    // Cleanup
-    for (auto* n : nutrition) delete n;
-    for (auto* n : fruits) delete n;
 }
 
 void demonstrateRecoveryOperations(WorkoutDAO& dao) {
@@ -124,10 +130,10 @@ void demonstrateRecoveryOperations(WorkoutDAO& dao) {
     
     // Read all recovery
     std::cout << "\n[READ ALL] All recovery sessions:" << std::endl;
-    std::vector<Recovery*> recoveries = dao.readAllRecovery();
+    ResultSet<Recovery> recoveries = dao.readAllRecovery();
     for (int i = 0; i < std::min(3, (int)recoveries.size()); i++) {
-        std::cout << "  - " << recoveries[i]->toString();
-        if (recoveries[i]->isLongRecovery()) {
+        std::cout << "  - " << recoveries[i].toString();
+        if (recoveries[i].isLongRecovery()) {
             std::cout << " [LONG SESSION]";
         }
         std::cout << std::endl;
@@ -135,15 +141,11 @@ void demonstrateRecoveryOperations(WorkoutDAO& dao) {
     
     // Read by type
     std::cout << "\n[READ BY TYPE] Yoga sessions:" << std::endl;
-    std::vector<Recovery*> yoga = dao.readRecoveryByType("Yoga Session");
-    for (auto* r : yoga) {
-        r->displayInfo();
+    ResultSet<Recovery> yoga = dao.readRecoveryByType("Yoga Session");
+    for (const auto& r : yoga) {
+        r.displayInfo();
         std::cout << std::endl;
     }
-    
-    // Cleanup
-    for (auto* r : recoveries) delete r;
-    for (auto* r : yoga) delete r;
 }
 
 void demonstrateEquipmentOperations(WorkoutDAO& dao) {
@@ -151,18 +153,27 @@ void demonstrateEquipmentOperations(WorkoutDAO& dao) {
     std::cout << "EQUIPMENT CRUD OPERATIONS DEMO" << std::endl;
     printSeparator();
     
-    // Create equipment
-    Equipment newEquipment(0, "Ab Wheel", "Core strengthening roller", 
-                          "Accessories", "Core, Abs");
-    std::cout << "\n[CREATE] Creating equipment..." << std::endl;
-    dao.createEquipment(newEquipment);
+    // Create equipment (names are unique, as for muscle groups above)
+    int createdId = 0;
+    Equipment* existing = dao.readEquipmentByName("Ab Wheel");
+    if (existing) {
+        std::cout << "\n[CREATE] Equipment 'Ab Wheel' already exists, skipping" << std::endl;
+        delete existing;
+    } else {
+        Equipment newEquipment(0, "Ab Wheel", "Core strengthening roller", 
+                              "Accessories", "Core, Abs");
+        std::cout << "\n[CREATE] Creating equipment..." << std::endl;
+        if (dao.createEquipment(newEquipment)) {
+            createdId = dao.getLastInsertId();
+        }
+    }
     
     // Read all equipment
     std::cout << "\n[READ ALL] All equipment:" << std::endl;
-    std::vector<Equipment*> equipment = dao.readAllEquipment();
+    ResultSet<Equipment> equipment = dao.readAllEquipment();
     for (int i = 0; i < std::min(5, (int)equipment.size()); i++) {
-        std::cout << "  - " << equipment[i]->toString();
-        if (equipment[i]->isCardioEquipment()) {
+        std::cout << "  - " << equipment[i].toString();
+        if (equipment[i].isCardioEquipment()) {
             std::cout << " [CARDIO]";
         }
         std::cout << std::endl;
@@ -170,15 +181,17 @@ void demonstrateEquipmentOperations(WorkoutDAO& dao) {
     
     // Read by category
     std::cout << "\n[READ BY CATEGORY] Free Weights:" << std::endl;
-    std::vector<Equipment*> freeWeights = dao.readEquipmentByCategory("Free Weights");
-    for (auto* e : freeWeights) {
-        e->displayInfo();
+    ResultSet<Equipment> freeWeights = dao.readEquipmentByCategory("Free Weights");
+    for (const auto& e : freeWeights) {
+        e.displayInfo();
         std::cout << std::endl;
     }
     
-    // Cleanup
-    for (auto* e : equipment) delete e;
-    for (auto* e : freeWeights) delete e;
+    // Delete the demo equipment
+    if (createdId > 0) {
+        std::cout << "\n[DELETE] Removing demo equipment..." << std::endl;
+        dao.deleteEquipment(createdId);
+    }
 }
 
 int main() {
@@ -193,8 +206,9 @@ int main() {
     std::string database = "workout_tracker";
     int port = 3306;
     
-    // Create DAO instance
-    WorkoutDAO dao(host, user, password, database, port);
+    // Create DAO instance (WORKOUT_STORAGE=local uses the embedded store)
+    std::unique_ptr<WorkoutDAO> storage = createWorkoutDAO(host, user, password, database, port);
+    WorkoutDAO& dao = *storage;
     
     // Test connection
     std::cout << "Testing database connection..." << std::endl;
@@ -0,0 +1,73 @@
+-- Workout Tracking System - Migration 001: indexes for the DAO's query shapes
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- Brings a database created from the original create_tables.sql up to the
+-- current index set. Fresh installs already get these from create_tables.sql.
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/001_query_indexes.sql
+--
+-- The unique name indexes fail if duplicates already exist. Find them first:
+--   SELECT name, COUNT(*) FROM MuscleGroup GROUP BY name HAVING COUNT(*) > 1;
+--   SELECT name, COUNT(*) FROM Equipment GROUP BY name HAVING COUNT(*) > 1;
+--
+-- None of these is a covering index, on purpose. Every list and date-range
+-- read selects the entity's full column list (selectFrom<T>() in
+-- RowMapping.h); the date-range totals read whole rows through
+-- readWorkoutsWhere/readRecoveryWhere too. An index covering that would copy
+-- the whole table, doubling write cost and storage. For MuscleGroup,
+-- Recovery and Equipment it cannot exist at all, since their TEXT columns
+-- (description, helpers) can only be prefix-indexed. The composite indexes
+-- below find the rows in order instead, and the primary key fetches them.
+
+-- Workout
+--   readAllWorkouts:            ORDER BY workout_date DESC, workout_time DESC
+--   readWorkoutsByDate:         WHERE workout_date = ?
+--   getTotalCaloriesBurned:     WHERE workout_date BETWEEN ? AND ?
+--   readWorkoutsByMuscleGroup:  WHERE muscle_group_id = ?
+--   getHighIntensityWorkouts:   WHERE rate_perceived_exhaustion >= 8
+-- The (muscle_group_id, workout_date) index also backs the foreign key, so the
+-- old single-column indexes are dropped in the same statement.
+ALTER TABLE Workout
+    ADD INDEX idx_workout_date_time (workout_date, workout_time),
+    ADD INDEX idx_workout_muscle_group_date (muscle_group_id, workout_date),
+    ADD INDEX idx_workout_rpe_date (rate_perceived_exhaustion, workout_date),
+    ADD INDEX idx_workout_updated (updated_at),
+    DROP INDEX idx_workout_date,
+    DROP INDEX idx_workout_muscle_group;
+
+-- MuscleGroup
+--   readMuscleGroupByName:      WHERE name = ?   (returns a single row)
+--   readAllMuscleGroups:        ORDER BY name
+ALTER TABLE MuscleGroup
+    ADD UNIQUE INDEX uk_musclegroup_name (name),
+    ADD INDEX idx_musclegroup_updated (updated_at);
+
+-- Nutrition
+--   readNutritionByDate:        WHERE meal_date = ?   (idx_nutrition_date, kept)
+--   readNutritionByFamily:      WHERE family = ?
+ALTER TABLE Nutrition
+    ADD INDEX idx_nutrition_family_date (family, meal_date),
+    ADD INDEX idx_nutrition_updated (updated_at);
+
+-- Recovery
+--   readRecoveryByDate:         WHERE recovery_date = ?   (idx_recovery_date, kept)
+--   readRecoveryByType:         WHERE type = ?
+ALTER TABLE Recovery
+    ADD INDEX idx_recovery_type_date (type, recovery_date),
+    ADD INDEX idx_recovery_updated (updated_at);
+
+-- Equipment
+--   readEquipmentByName:        WHERE name = ?   (returns a single row)
+--   readAllEquipment:           ORDER BY name
+--   readEquipmentByCategory:    WHERE category = ?
+ALTER TABLE Equipment
+    ADD UNIQUE INDEX uk_equipment_name (name),
+    ADD INDEX idx_equipment_category_name (category, name),
+    ADD INDEX idx_equipment_updated (updated_at),
+    DROP INDEX idx_equipment_category;
+
+-- updated_at indexes let WorkoutDAO::readTableStamp read MAX(updated_at)
+-- from the end of an index instead of scanning the table. (Migration 004
+-- replaces that check with trigger-maintained versions and drops them.)
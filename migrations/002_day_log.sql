@@ -0,0 +1,18 @@
+-- Workout Tracking System - Migration 002: DayLog table for POST /api/days
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- WorkoutDAO::logDay inserts a DayLog row keyed by the client's key in the
+-- same transaction as the workout, meals and recovery session. A retry with
+-- the same key hits the primary key, rolls back, and gets the stored ids.
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/002_day_log.sql
+
+CREATE TABLE DayLog (
+    client_key VARCHAR(64) PRIMARY KEY,
+    workout_id INT,
+    nutrition_ids VARCHAR(1024) COMMENT 'Comma-separated Nutrition ids',
+    recovery_id INT,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
@@ -0,0 +1,21 @@
+-- Workout Tracking System - Migration 003: IdempotencyKey table
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- Persistent half of the REST server's Idempotency-Key support. A POST
+-- carrying the header has its response saved here; a retry with the same key
+-- within the TTL gets that response back instead of running again. Rows older
+-- than the TTL are purged by the server.
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/003_idempotency_keys.sql
+
+CREATE TABLE IdempotencyKey (
+    idem_key VARCHAR(128) PRIMARY KEY,
+    fingerprint VARCHAR(32) NOT NULL COMMENT 'Hash of method, path and body',
+    status INT NOT NULL,
+    content_type VARCHAR(100),
+    body MEDIUMTEXT,
+    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+    INDEX idx_idempotency_created (created_at)
+);
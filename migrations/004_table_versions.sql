@@ -0,0 +1,73 @@
+-- Workout Tracking System - Migration 004: trigger-maintained table versions
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- The REST server's ETags notice writes made by other processes by reading
+-- each table's version from TableVersion (WorkoutDAO::readTableVersion).
+-- Every insert, update and delete bumps the version in the same transaction,
+-- so no write is missed and the read is a primary key lookup. It replaces
+-- COUNT(*) + MAX(updated_at), which scanned the table and could not see an
+-- update and a delete landing in the same second.
+--
+-- A version row is locked until the writing transaction commits, so writers
+-- to the same table take turns on it; writes here are small and rare enough
+-- for that not to matter.
+--
+-- Creating triggers needs the TRIGGER privilege (and, with binary logging
+-- on, SUPER or log_bin_trust_function_creators).
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/004_table_versions.sql
+
+CREATE TABLE TableVersion (
+    table_name VARCHAR(32) PRIMARY KEY,
+    version BIGINT UNSIGNED NOT NULL DEFAULT 0
+);
+
+INSERT INTO TableVersion (table_name) VALUES
+    ('Workout'), ('MuscleGroup'), ('Nutrition'), ('Recovery'), ('Equipment');
+
+CREATE TRIGGER trg_workout_insert AFTER INSERT ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+CREATE TRIGGER trg_workout_update AFTER UPDATE ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+CREATE TRIGGER trg_workout_delete AFTER DELETE ON Workout FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Workout';
+
+-- Deleting a muscle group sets Workout.muscle_group_id to NULL through the
+-- foreign key, which does not fire Workout's triggers, so bump both here
+CREATE TRIGGER trg_musclegroup_insert AFTER INSERT ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'MuscleGroup';
+CREATE TRIGGER trg_musclegroup_update AFTER UPDATE ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'MuscleGroup';
+CREATE TRIGGER trg_musclegroup_delete AFTER DELETE ON MuscleGroup FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name IN ('MuscleGroup', 'Workout');
+
+CREATE TRIGGER trg_nutrition_insert AFTER INSERT ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+CREATE TRIGGER trg_nutrition_update AFTER UPDATE ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+CREATE TRIGGER trg_nutrition_delete AFTER DELETE ON Nutrition FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Nutrition';
+
+CREATE TRIGGER trg_recovery_insert AFTER INSERT ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+CREATE TRIGGER trg_recovery_update AFTER UPDATE ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+CREATE TRIGGER trg_recovery_delete AFTER DELETE ON Recovery FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Recovery';
+
+CREATE TRIGGER trg_equipment_insert AFTER INSERT ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+CREATE TRIGGER trg_equipment_update AFTER UPDATE ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+CREATE TRIGGER trg_equipment_delete AFTER DELETE ON Equipment FOR EACH ROW
+    UPDATE TableVersion SET version = version + 1 WHERE table_name = 'Equipment';
+
+-- The updated_at indexes from migration 001 only served the old
+-- MAX(updated_at) check; nothing reads them now
+ALTER TABLE Workout DROP INDEX idx_workout_updated;
+ALTER TABLE MuscleGroup DROP INDEX idx_musclegroup_updated;
+ALTER TABLE Nutrition DROP INDEX idx_nutrition_updated;
+ALTER TABLE Recovery DROP INDEX idx_recovery_updated;
+ALTER TABLE Equipment DROP INDEX idx_equipment_updated;
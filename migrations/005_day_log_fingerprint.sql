@@ -0,0 +1,15 @@
+-- Workout Tracking System - Migration 005: request fingerprint for DayLog
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- POST /api/days stores a hash of the request body with its client_key. A
+-- retry with the same key and body replays the first call's ids; the same
+-- key with a different body is refused (422) instead of quietly returning
+-- ids that belong to another day. Rows logged before this migration have no
+-- fingerprint and still replay for any body.
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/005_day_log_fingerprint.sql
+
+ALTER TABLE DayLog
+    ADD COLUMN fingerprint VARCHAR(32) COMMENT 'Hash of method, path and body' AFTER client_key;
@@ -0,0 +1,15 @@
+-- Workout Tracking System - Migration 006: per-client idempotency keys
+-- Author: Therin Emmons
+-- Date: 2026-10-18
+--
+-- Idempotency keys are stored as "<client> <Idempotency-Key>", the client
+-- being its address or a configured API key, so one client's key can never
+-- replay or block another client's request. That needs more than 128
+-- characters. Saved rows from before this migration carry no client and stop
+-- matching; they expire with the TTL as usual.
+--
+-- Run once:
+--   mysql -u workout_user -pworkout_pass workout_tracker < migrations/006_idempotency_client_scope.sql
+
+ALTER TABLE IdempotencyKey
+    MODIFY idem_key VARCHAR(255) NOT NULL COMMENT 'Client, a space, then the Idempotency-Key';
@@ -0,0 +1,127 @@
+#!/bin/bash
+# check_query_plans.sh
+# Workout Tracking System - EXPLAIN every query shape WorkoutDAO issues and
+# fail if any of them would scan a whole table.
+# Author: Therin Emmons
+# Date: 2026-10-18
+#
+# Usage: migrations/check_query_plans.sh    (or: make db-check-plans)
+# Exits 1 if any query has no usable index.
+
+DB_NAME="${DB_NAME:-workout_tracker}"
+DB_USER="${DB_USER:-workout_user}"
+DB_PASS="${DB_PASS:-workout_pass}"
+DB_HOST="${DB_HOST:-localhost}"
+
+FAILED=0
+
+# Print one EXPLAIN row per table as "type|possible_keys|key|Extra",
+# locating the columns by header name so MySQL/MariaDB layouts both work.
+explain() {
+    mysql -h "$DB_HOST" -u "$DB_USER" -p"$DB_PASS" "$DB_NAME" -B -e "EXPLAIN $1" 2>/dev/null |
+        awk -F'\t' '
+            NR == 1 { for (i = 1; i <= NF; i++) col[$i] = i; next }
+            { print $col["type"] "|" $col["possible_keys"] "|" $col["key"] "|" $col["Extra"] }'
+}
+
+# Lookups: a full scan with no candidate index is a failure. (On a nearly
+# empty table MySQL may still choose ALL even with an index available, so
+# only a missing possible_keys counts.)
+check_lookup() {
+    local label="$1" query="$2"
+    local plan type possible key
+    plan=$(explain "$query")
+    if [ -z "$plan" ]; then
+        echo "✗ $label: EXPLAIN failed"
+        FAILED=1
+        return
+    fi
+    IFS='|' read -r type possible key _ <<< "$plan"
+    if [ "$type" = "ALL" ] && { [ -z "$possible" ] || [ "$possible" = "NULL" ]; }; then
+        echo "✗ $label: full table scan"
+        FAILED=1
+    else
+        echo "✓ $label: ${key:-$possible}"
+    fi
+}
+
+# Ordered reads: the ORDER BY must come from an index, not a filesort.
+# LIMIT keeps the optimizer from preferring a scan on small tables.
+check_ordered() {
+    local label="$1" query="$2"
+    local plan type possible key extra
+    plan=$(explain "$query LIMIT 10")
+    if [ -z "$plan" ]; then
+        echo "✗ $label: EXPLAIN failed"
+        FAILED=1
+        return
+    fi
+    IFS='|' read -r type possible key extra <<< "$plan"
+    if [[ "$extra" == *"Using filesort"* ]]; then
+        echo "✗ $label: filesort"
+        FAILED=1
+    else
+        echo "✓ $label: $key"
+    fi
+}
+
+# The SELECT lists WorkoutDAO builds with selectFrom<T>() (RowMapping.h), so
+# the plans checked are those of the statements actually sent. Keep these in
+# step with the RowMapping<T>::fields tables.
+WORKOUT="SELECT workout_id, workout_date, workout_time, duration, type_description, calories_burned, rate_perceived_exhaustion, muscle_group_id FROM Workout"
+MUSCLE_GROUP="SELECT muscle_group_id, name, description, days_per_week, sets, reps, weight_amount FROM MuscleGroup"
+NUTRITION="SELECT nutrition_id, family, water, carbs, fat, protein, sugar, meal_date FROM Nutrition"
+RECOVERY="SELECT recovery_id, recovery_date, duration, type, helpers FROM Recovery"
+EQUIPMENT="SELECT equipment_id, name, description, category, target FROM Equipment"
+
+echo "Checking query plans in $DB_NAME..."
+
+# Workout
+check_lookup  "Workout by id"           "$WORKOUT WHERE workout_id = 1"
+check_lookup  "Workout by ids"          "$WORKOUT WHERE workout_id IN (1,2,3) ORDER BY FIELD(workout_id, 1,2,3)"
+check_ordered "Workout all"             "$WORKOUT ORDER BY workout_date DESC, workout_time DESC"
+check_lookup  "Workout by date"         "$WORKOUT WHERE workout_date = '2026-01-01'"
+check_lookup  "Workout date range"      "$WORKOUT WHERE workout_date >= '2026-01-01' AND workout_date <= '2026-01-31' ORDER BY workout_date DESC, workout_time DESC"
+check_lookup  "Workout by muscle group" "$WORKOUT WHERE muscle_group_id = 1"
+check_lookup  "Workout by RPE"          "$WORKOUT WHERE rate_perceived_exhaustion >= 8 ORDER BY workout_date DESC, workout_time DESC"
+
+# MuscleGroup
+check_lookup  "MuscleGroup by id"       "$MUSCLE_GROUP WHERE muscle_group_id = 1"
+check_lookup  "MuscleGroup by ids"      "$MUSCLE_GROUP WHERE muscle_group_id IN (1,2,3) ORDER BY FIELD(muscle_group_id, 1,2,3)"
+check_ordered "MuscleGroup all"         "$MUSCLE_GROUP ORDER BY name"
+check_lookup  "MuscleGroup by name"     "$MUSCLE_GROUP WHERE name = 'Chest'"
+
+# Nutrition
+check_lookup  "Nutrition by id"         "$NUTRITION WHERE nutrition_id = 1"
+check_ordered "Nutrition all"           "$NUTRITION ORDER BY meal_date DESC"
+check_lookup  "Nutrition by date"       "$NUTRITION WHERE meal_date = '2026-01-01'"
+check_lookup  "Nutrition by family"     "$NUTRITION WHERE family = 'Protein'"
+
+# Recovery
+check_lookup  "Recovery by id"          "$RECOVERY WHERE recovery_id = 1"
+check_ordered "Recovery all"            "$RECOVERY ORDER BY recovery_date DESC"
+check_lookup  "Recovery by date"        "$RECOVERY WHERE recovery_date = '2026-01-01'"
+check_lookup  "Recovery by type"        "$RECOVERY WHERE type = 'Stretching'"
+
+# Equipment
+check_lookup  "Equipment by id"         "$EQUIPMENT WHERE equipment_id = 1"
+check_ordered "Equipment all"           "$EQUIPMENT ORDER BY name"
+check_lookup  "Equipment by category"   "$EQUIPMENT WHERE category = 'Cardio'"
+check_lookup  "Equipment by name"       "$EQUIPMENT WHERE name = 'Treadmill'"
+
+# Training days and idempotency keys
+check_lookup  "DayLog by client key"    "SELECT workout_id, nutrition_ids, recovery_id, fingerprint FROM DayLog WHERE client_key = 'k'"
+check_lookup  "Idempotency record"      "SELECT fingerprint, status, content_type, body, UNIX_TIMESTAMP(created_at) FROM IdempotencyKey WHERE idem_key = 'k'"
+check_lookup  "Idempotency purge"       "DELETE FROM IdempotencyKey WHERE created_at < FROM_UNIXTIME(0)"
+
+# Change detection (WorkoutDAO::readTableVersion)
+for table in Workout MuscleGroup Nutrition Recovery Equipment; do
+    check_lookup "$table version" "SELECT version FROM TableVersion WHERE table_name = '$table'"
+done
+
+echo ""
+if [ $FAILED -ne 0 ]; then
+    echo "✗ Some queries are not covered by an index"
+    exit 1
+fi
+echo "✓ All query plans use an index"
@@ -200,9 +200,10 @@ if [ -f "Makefile" ]; then
 else
     print_error "Makefile not found. Please build manually."
     print_info "Manual build command:"
-    echo "  g++ -std=c++11 -I/usr/include/mysql main.cpp Workout.cpp MuscleGroup.cpp \\"
+    echo "  g++ -std=c++17 -I/usr/include/mysql main.cpp Workout.cpp MuscleGroup.cpp \\"
     echo "      Nutrition.cpp Recovery.cpp Equipment.cpp WorkoutDAO.cpp \\"
-    echo "      -L/usr/lib/x86_64-linux-gnu -lmysqlclient -o workout_tracker"
+    echo "      LocalStore.cpp LocalStoreDAO.cpp ColumnSnapshot.cpp \\"
+    echo "      -L/usr/lib/x86_64-linux-gnu -lmysqlclient -lz -o workout_tracker"
 fi
 
 # Test connection
@@ -0,0 +1,80 @@
+// snapshot_tool.cpp
+// Workout Tracking System - Export and report on columnar analytics snapshots
+// Author: Therin Emmons
+// Date: 2026-10-18
+
+#include "WorkoutDAO.h"
+#include "LocalStoreDAO.h"
+#include "ColumnSnapshot.h"
+#include "BusinessLayer/WorkoutManager.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+void printUsage() {
+    std::cout << "Usage:\n"
+              << "  workout_snapshot export <dir>                  Write a snapshot of every table\n"
+              << "  workout_snapshot report <dir> <start> <end>    Totals for a date range (YYYY-MM-DD)\n"
+              << std::endl;
+}
+
+int exportSnapshot(const std::string& directory) {
+    // Database configuration (same as main.cpp)
+    std::string host = "localhost";
+    std::string user = "workout_user";
+    std::string password = "workout_pass";
+    std::string database = "workout_tracker";
+    int port = 3306;
+
+    std::unique_ptr<WorkoutDAO> storage = createWorkoutDAO(host, user, password, database, port);
+    if (!storage->testConnection()) {
+        std::cerr << "Failed to connect to database!" << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    if (!AnalyticsSnapshot::exportFrom(*storage, directory, error)) {
+        std::cerr << "Export failed: " << error << std::endl;
+        return 1;
+    }
+    std::cout << "Snapshot written to " << directory << std::endl;
+    return 0;
+}
+
+int reportSnapshot(const std::string& directory, const std::string& startDate, const std::string& endDate) {
+    auto start = std::chrono::steady_clock::now();
+    AnalyticsSnapshot snapshot;
+    std::string error;
+    if (!snapshot.open(directory, error)) {
+        std::cerr << "Cannot open snapshot: " << error << std::endl;
+        return 1;
+    }
+    auto opened = std::chrono::steady_clock::now();
+
+    std::cout << "Snapshot: " << snapshot.workouts().getRowCount() << " workouts, "
+              << snapshot.nutrition().getRowCount() << " meals, "
+              << snapshot.recovery().getRowCount() << " recovery sessions (opened in "
+              << std::chrono::duration<double, std::milli>(opened - start).count() << " ms)" << std::endl;
+
+    // The snapshot overloads never touch the DAO, so no connection is needed
+    WorkoutManager manager(nullptr);
+    manager.getTotalCaloriesBurned(snapshot, startDate, endDate);
+    manager.getTotalRecoveryTime(snapshot, startDate, endDate);
+    manager.getTotalCaloriesForDate(snapshot, startDate);
+    manager.getTotalProteinForDate(snapshot, startDate);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+
+    if (command == "export" && argc == 3) {
+        return exportSnapshot(argv[2]);
+    }
+    if (command == "report" && argc == 5) {
+        return reportSnapshot(argv[2], argv[3], argv[4]);
+    }
+
+    printUsage();
+    return 1;
+}